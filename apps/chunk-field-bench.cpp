@@ -0,0 +1,61 @@
+#include "utils/chunk-field/ChunkFieldGenerator.hpp"
+#include "utils/job-system/JobSystem.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <chrono>
+#include <iterator>
+#include <vector>
+
+// the throughput of the cpu chunk field generator, for every simd path the cpu supports, on a
+// single thread and over the job system
+//   chunk-field-bench [voxel resolution]
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// a few chunks around the center of the default world, so both the land and the air are covered
+void _benchPath(Logger &logger, ChunkFieldGenerator &generator, char const *threading) {
+  static glm::uvec3 const kChunkIndices[] = {{3, 0, 3}, {4, 0, 4}, {0, 0, 0}};
+
+  std::vector<uint16_t> field{};
+  // warms up the pages of the field
+  generator.generate(field, kChunkIndices[0]);
+
+  auto const start = Clock::now();
+  for (glm::uvec3 const &chunkIndex : kChunkIndices) {
+    generator.generate(field, chunkIndex);
+  }
+  double const seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  double const voxelCount = static_cast<double>(field.size() * std::size(kChunkIndices));
+  logger.info("{} {}: {:.2f} ms per chunk, {:.2f} M voxels/s",
+              ChunkFieldGenerator::getSimdPathName(generator.getSimdPath()), threading,
+              seconds * 1e3 / static_cast<double>(std::size(kChunkIndices)),
+              voxelCount / seconds / 1e6);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Logger logger{};
+  uint32_t const voxelResolution = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 128;
+  glm::uvec3 const chunksDim{8, 1, 8};
+
+  JobSystem jobSystem{};
+  logger.info("chunk field of {} voxels per axis, job system with {} workers", voxelResolution + 1,
+              jobSystem.getWorkerCount());
+
+  for (auto const simdPath :
+       {ChunkFieldGenerator::SimdPath::kScalar, ChunkFieldGenerator::SimdPath::kAvx2,
+        ChunkFieldGenerator::SimdPath::kNeon}) {
+    if (!ChunkFieldGenerator::isSimdPathSupported(simdPath)) {
+      continue;
+    }
+    ChunkFieldGenerator singleThreaded{nullptr, voxelResolution, chunksDim};
+    singleThreaded.setSimdPath(simdPath);
+    _benchPath(logger, singleThreaded, "single thread");
+
+    ChunkFieldGenerator multiThreaded{&jobSystem, voxelResolution, chunksDim};
+    multiThreaded.setSimdPath(simdPath);
+    _benchPath(logger, multiThreaded, "job system");
+  }
+  return 0;
+}
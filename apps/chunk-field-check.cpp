@@ -0,0 +1,115 @@
+#include "utils/chunk-field/ChunkFieldGenerator.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// checks the cpu chunk field generator, every simd path the cpu supports must be bit-exact with the
+// scalar path, and if a chunk field dumped by the renderer is given, the scalar path must be
+// bit-exact with it as well
+//   chunk-field-check <voxel resolution> <chunks dim x y z> <chunk index x y z> [dumped field]
+// the fields are dumped with Terrain.chunkFieldDumpFolder, to capture them without a gpu, run the
+// renderer on a software vulkan driver, e.g. VK_ICD_FILENAMES=<path to lvp_icd.json>
+namespace {
+
+struct FieldDiff {
+  size_t mismatchCount       = 0;
+  size_t blockTypeMismatches = 0;
+  uint32_t maxWeightDelta    = 0;
+  size_t firstMismatch       = 0;
+};
+
+FieldDiff _diffFields(std::vector<uint16_t> const &expected, std::vector<uint16_t> const &actual) {
+  uint32_t constexpr kWeightBits = 12;
+  uint32_t constexpr kWeightMask = (1U << kWeightBits) - 1;
+
+  FieldDiff diff{};
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (expected[i] == actual[i]) {
+      continue;
+    }
+    if (diff.mismatchCount == 0) {
+      diff.firstMismatch = i;
+    }
+    diff.mismatchCount++;
+    if ((expected[i] >> kWeightBits) != (actual[i] >> kWeightBits)) {
+      diff.blockTypeMismatches++;
+    }
+    auto const expectedWeight = static_cast<int32_t>(expected[i] & kWeightMask);
+    auto const actualWeight   = static_cast<int32_t>(actual[i] & kWeightMask);
+    auto const weightDelta    = static_cast<uint32_t>(std::abs(expectedWeight - actualWeight));
+    diff.maxWeightDelta       = std::max(diff.maxWeightDelta, weightDelta);
+  }
+  return diff;
+}
+
+bool _report(Logger &logger, std::string const &name, FieldDiff const &diff, uint32_t dim) {
+  if (diff.mismatchCount == 0) {
+    logger.info("{}: bit-exact", name);
+    return true;
+  }
+  size_t const x = diff.firstMismatch % dim;
+  size_t const y = diff.firstMismatch / dim % dim;
+  size_t const z = diff.firstMismatch / dim / dim;
+  logger.error("{}: {} voxels differ, {} of them in block type, max weight delta {} levels, first "
+               "at ({}, {}, {})",
+               name, diff.mismatchCount, diff.blockTypeMismatches, diff.maxWeightDelta, x, y, z);
+  return false;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Logger logger{};
+  if (argc != 8 && argc != 9) {
+    logger.error("usage: chunk-field-check <voxel resolution> <chunks dim x y z> "
+                 "<chunk index x y z> [dumped field]");
+    return 1;
+  }
+  auto const voxelResolution = static_cast<uint32_t>(std::stoul(argv[1]));
+  glm::uvec3 const chunksDim{std::stoul(argv[2]), std::stoul(argv[3]), std::stoul(argv[4])};
+  glm::uvec3 const chunkIndex{std::stoul(argv[5]), std::stoul(argv[6]), std::stoul(argv[7])};
+  uint32_t const dim = voxelResolution + 1;
+
+  ChunkFieldGenerator generator{nullptr, voxelResolution, chunksDim};
+  generator.setSimdPath(ChunkFieldGenerator::SimdPath::kScalar);
+  std::vector<uint16_t> scalarField{};
+  generator.generate(scalarField, chunkIndex);
+
+  bool allExact = true;
+  for (auto const simdPath : {ChunkFieldGenerator::SimdPath::kAvx2,
+                              ChunkFieldGenerator::SimdPath::kNeon}) {
+    if (!ChunkFieldGenerator::isSimdPathSupported(simdPath)) {
+      logger.info("{}: not supported, skipped", ChunkFieldGenerator::getSimdPathName(simdPath));
+      continue;
+    }
+    generator.setSimdPath(simdPath);
+    std::vector<uint16_t> simdField{};
+    generator.generate(simdField, chunkIndex);
+    allExact &= _report(logger,
+                        std::string(ChunkFieldGenerator::getSimdPathName(simdPath)) + " vs scalar",
+                        _diffFields(scalarField, simdField), dim);
+  }
+
+  if (argc == 9) {
+    std::ifstream file(argv[8], std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+      logger.error("failed to open {}", argv[8]);
+      return 1;
+    }
+    auto const fileSize = static_cast<size_t>(file.tellg());
+    if (fileSize != scalarField.size() * sizeof(uint16_t)) {
+      logger.error("{} has {} bytes, expected {} for the voxel resolution {}", argv[8], fileSize,
+                   scalarField.size() * sizeof(uint16_t), voxelResolution);
+      return 1;
+    }
+    std::vector<uint16_t> dumpedField(scalarField.size());
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(dumpedField.data()), static_cast<std::streamsize>(fileSize));
+    allExact &= _report(logger, "scalar vs gpu", _diffFields(dumpedField, scalarField), dim);
+  }
+
+  return allExact ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "utils/job-system/JobSystem.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// microbenchmarks of the job system, the scheduling overhead of the empty jobs, the latency of a
+// dependency chain, and the scaling of parallelFor over the worker counts
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double _elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// some floating point work that the compiler cannot fold
+double _work(size_t begin, size_t end) {
+  double sum = 0.0;
+  for (size_t i = begin; i < end; i++) {
+    sum += std::sin(static_cast<double>(i)) * std::sqrt(static_cast<double>(i));
+  }
+  return sum;
+}
+
+void _benchScheduling(Logger &logger, JobSystem &jobSystem) {
+  constexpr size_t kJobCount = 100000;
+
+  std::vector<JobSystem::JobHandle> jobs{};
+  jobs.reserve(kJobCount);
+  auto const start = Clock::now();
+  for (size_t i = 0; i < kJobCount; i++) {
+    jobs.push_back(jobSystem.schedule([]() {}));
+  }
+  jobSystem.wait(jobs);
+  double const elapsedMs = _elapsedMs(start);
+
+  logger.info("scheduling: {} empty jobs in {:.2f} ms, {:.0f} ns per job", kJobCount, elapsedMs,
+              elapsedMs * 1e6 / static_cast<double>(kJobCount));
+}
+
+void _benchDependencyChain(Logger &logger, JobSystem &jobSystem) {
+  constexpr size_t kChainLength = 10000;
+
+  auto const start          = Clock::now();
+  JobSystem::JobHandle last = jobSystem.schedule([]() {});
+  for (size_t i = 1; i < kChainLength; i++) {
+    last = jobSystem.schedule([]() {}, {last});
+  }
+  jobSystem.wait(last);
+  double const elapsedMs = _elapsedMs(start);
+
+  logger.info("dependency chain: {} jobs in {:.2f} ms, {:.0f} ns per link", kChainLength,
+              elapsedMs, elapsedMs * 1e6 / static_cast<double>(kChainLength));
+}
+
+void _benchParallelForScaling(Logger &logger) {
+  constexpr size_t kElementCount = 1 << 22;
+  constexpr size_t kGrainSize    = 4096;
+
+  auto const serialStart = Clock::now();
+  double const expected  = _work(0, kElementCount);
+  double const serialMs  = _elapsedMs(serialStart);
+  logger.info("parallelFor: serial {:.2f} ms", serialMs);
+
+  size_t const maxWorkerCount = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+  for (size_t workerCount = 1; workerCount <= maxWorkerCount; workerCount *= 2) {
+    JobSystem jobSystem{workerCount};
+
+    std::vector<double> chunkSums((kElementCount + kGrainSize - 1) / kGrainSize, 0.0);
+    auto const start = Clock::now();
+    jobSystem.parallelFor(0, kElementCount, kGrainSize, [&](size_t begin, size_t end) {
+      chunkSums[begin / kGrainSize] = _work(begin, end);
+    });
+    double const elapsedMs = _elapsedMs(start);
+
+    double sum = 0.0;
+    for (double const chunkSum : chunkSums) {
+      sum += chunkSum;
+    }
+    logger.info("parallelFor: {} workers {:.2f} ms, {:.2f}x, error {:.3e}", workerCount, elapsedMs,
+                serialMs / elapsedMs, std::abs(sum - expected) / std::abs(expected));
+  }
+}
+} // namespace
+
+int main() {
+  Logger logger{};
+  {
+    JobSystem jobSystem{};
+    logger.info("job system with {} workers", jobSystem.getWorkerCount());
+    _benchScheduling(logger, jobSystem);
+    _benchDependencyChain(logger, jobSystem);
+  }
+  _benchParallelForScaling(logger);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "application/svo-builder/MeshVoxelizer.hpp"
+#include "application/svo-builder/ObjLoader.hpp"
+#include "utils/job-system/JobSystem.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+// the throughput of the mesh voxelizer for spheres of increasing triangle counts, and for the obj
+// files that are given, the meshes fill the world, on a single thread and over the job system
+//   mesh-voxelizer-bench [voxel resolution] [obj files...]
+namespace {
+using Clock = std::chrono::steady_clock;
+
+glm::uvec3 const kChunksDim{4, 4, 4};
+// see blockType.glsl
+uint32_t constexpr kBlockTypeRock = 2;
+
+// 2 * segments^2 triangles
+TriangleMesh _makeSphere(uint32_t segments) {
+  TriangleMesh mesh{};
+  float constexpr kPi = 3.14159265F;
+  for (uint32_t i = 0; i <= segments; i++) {
+    float const theta = kPi * static_cast<float>(i) / static_cast<float>(segments);
+    for (uint32_t j = 0; j <= segments; j++) {
+      float const phi = 2.F * kPi * static_cast<float>(j) / static_cast<float>(segments);
+      mesh.positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta),
+                                  std::sin(theta) * std::sin(phi));
+    }
+  }
+  for (uint32_t i = 0; i < segments; i++) {
+    for (uint32_t j = 0; j < segments; j++) {
+      uint32_t const a = i * (segments + 1) + j;
+      uint32_t const b = a + segments + 1;
+      mesh.indices.insert(mesh.indices.end(), {a, a + 1, b, a + 1, b + 1, b});
+    }
+  }
+  return mesh;
+}
+
+void _benchMesh(Logger &logger, TriangleMesh mesh, std::string const &name,
+                MeshVoxelizer const &singleThreaded, MeshVoxelizer const &multiThreaded) {
+  fitMeshIntoBox(mesh, glm::vec3{0.05F}, glm::vec3{kChunksDim} - 0.05F);
+  auto const triangleCount = static_cast<double>(mesh.getTriangleCount());
+
+  for (auto const &[voxelizer, threading] :
+       {std::pair{&singleThreaded, "single thread"}, std::pair{&multiThreaded, "job system"}}) {
+    auto const start                         = Clock::now();
+    std::vector<ChunkFragments> const chunks = voxelizer->voxelize(mesh, kBlockTypeRock);
+    auto const end                           = Clock::now();
+
+    double const seconds = std::chrono::duration<double>(end - start).count();
+
+    size_t voxelCount = 0;
+    for (ChunkFragments const &chunk : chunks) {
+      voxelCount += chunk.fragments.size();
+    }
+    logger.info("{} ({} triangles) {}: {:.1f} ms, {:.2f} M triangles/s, {} voxels", name,
+                mesh.getTriangleCount(), threading, seconds * 1e3, triangleCount / seconds / 1e6,
+                voxelCount);
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Logger logger{};
+  uint32_t const voxelResolution = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 256;
+
+  JobSystem jobSystem{};
+  MeshVoxelizer const singleThreaded{nullptr, voxelResolution, kChunksDim};
+  MeshVoxelizer const multiThreaded{&jobSystem, voxelResolution, kChunksDim};
+  logger.info("{} voxels per chunk axis, {} chunks per axis, job system with {} workers",
+              voxelResolution, kChunksDim.x, jobSystem.getWorkerCount());
+
+  for (uint32_t const segments : {16U, 64U, 256U, 1024U, 2048U}) {
+    _benchMesh(logger, _makeSphere(segments), "sphere", singleThreaded, multiThreaded);
+  }
+
+  for (int i = 2; i < argc; i++) {
+    auto const start = Clock::now();
+    TriangleMesh mesh{};
+    if (!ObjLoader::fetchMeshFromFile(mesh, argv[i])) {
+      logger.error("failed to open {}", argv[i]);
+      continue;
+    }
+    logger.info("{} loaded in {:.1f} ms", argv[i],
+                std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    _benchMesh(logger, std::move(mesh), argv[i], singleThreaded, multiThreaded);
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include "utils/io/TextureArrayBlob.hpp"
+#include "utils/logger/Logger.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// packs the numbered pngs <prefix>0.png .. <prefix>(n-1).png into a texture array blob, the layers
+// are decoded to rgba8, which is the format that the renderer uploads them with
+//   texture-array-packer <prefix> <layer count> <blob path>
+// the renderer looks for the blue noise arrays at <stbn prefix>array.bin
+int main(int argc, char **argv) {
+  Logger logger{};
+  if (argc != 4) {
+    logger.error("usage: texture-array-packer <png prefix> <layer count> <blob path>");
+    return 1;
+  }
+  std::string const prefix   = argv[1];
+  int const layerCount       = std::stoi(argv[2]);
+  std::string const blobPath = argv[3];
+
+  int width  = 0;
+  int height = 0;
+  std::vector<unsigned char> data{};
+  for (int i = 0; i < layerCount; i++) {
+    std::string const path = prefix + std::to_string(i) + ".png";
+
+    int layerWidth           = 0;
+    int layerHeight          = 0;
+    int channels             = 0;
+    unsigned char *layerData = stbi_load(path.c_str(), &layerWidth, &layerHeight, &channels,
+                                         STBI_rgb_alpha);
+    if (layerData == nullptr) {
+      logger.error("failed to load {}", path);
+      return 1;
+    }
+    if (i == 0) {
+      width  = layerWidth;
+      height = layerHeight;
+      data.resize(static_cast<size_t>(width) * height * 4 * layerCount);
+    } else if (layerWidth != width || layerHeight != height) {
+      logger.error("{} is {}x{}, the layers before are {}x{}", path, layerWidth, layerHeight, width,
+                   height);
+      stbi_image_free(layerData);
+      return 1;
+    }
+
+    size_t const layerSize = static_cast<size_t>(width) * height * 4;
+    std::memcpy(data.data() + layerSize * i, layerData, layerSize);
+    stbi_image_free(layerData);
+  }
+
+  TextureArrayBlob::Header header{};
+  header.width         = static_cast<uint32_t>(width);
+  header.height        = static_cast<uint32_t>(height);
+  header.layerCount    = static_cast<uint32_t>(layerCount);
+  header.bytesPerPixel = 4;
+  if (!TextureArrayBlob::write(blobPath, header, data.data(), &logger)) {
+    return 1;
+  }
+  logger.info("packed {} layers of {}x{} into {}", layerCount, width, height, blobPath);
+  return 0;
+}
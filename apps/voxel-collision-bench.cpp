@@ -0,0 +1,119 @@
+#include "application/collision/VoxelCollider.hpp"
+#include "application/svo-builder/ChunkOctreeBuilder.hpp"
+#include "application/svo-builder/VoxelWorldMirror.hpp"
+#include "utils/chunk-field/ChunkFieldGenerator.hpp"
+#include "utils/job-system/JobSystem.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+// the sweep queries of the camera collision against a cpu generated world, the boxes start on the
+// surface and are moved with the displacement of a boosted camera frame, and of a frame that lags
+// ten times behind
+//   voxel-collision-bench [voxel resolution]
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// the default camera config
+float constexpr kHalfExtent = 0.01F;
+float constexpr kStepHeight = 0.02F;
+// movementSpeed * movementSpeedBoost at 60 fps
+float constexpr kFrameDistance = 0.2F * 3.F / 60.F;
+
+uint32_t constexpr kBoxCount   = 4096;
+uint32_t constexpr kSweepCount = 1 << 20;
+// the placement rays that may miss the ground before giving up
+uint32_t constexpr kMaxPlacementAttempts = kBoxCount * 64;
+
+void _buildWorld(VoxelWorldMirror &oWorld, JobSystem &jobSystem, uint32_t voxelResolution,
+                 glm::uvec3 chunksDim) {
+  ChunkFieldGenerator const generator{nullptr, voxelResolution, chunksDim};
+  size_t const chunkCount = static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z;
+
+  // a job builds a whole chunk, the same as the cpu chunk generation of the builder
+  jobSystem.parallelFor(0, chunkCount, 1, [&](size_t begin, size_t end) {
+    std::vector<uint16_t> field{};
+    for (size_t i = begin; i < end; i++) {
+      glm::uvec3 const chunkIndex{i % chunksDim.x, (i / chunksDim.x) % chunksDim.y,
+                                  i / (chunksDim.x * chunksDim.y)};
+      generator.generate(field, chunkIndex);
+      oWorld.setChunk(chunkIndex, buildChunkOctreeFromFragments(
+                                      extractChunkFragments(field.data(), voxelResolution),
+                                      voxelResolution, false));
+    }
+  });
+}
+
+// the boxes rest on the surface below random points of the world, fails when too few of the points
+// are above the ground, as for a world without voxels
+bool _placeBoxes(std::vector<glm::vec3> &oCenters, VoxelWorldMirror const &world,
+                 glm::uvec3 chunksDim, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> x{0.F, static_cast<float>(chunksDim.x)};
+  std::uniform_real_distribution<float> z{0.F, static_cast<float>(chunksDim.z)};
+  float const top = static_cast<float>(chunksDim.y);
+
+  oCenters.clear();
+  VoxelWorldMirror::RaycastHit hit{};
+  for (uint32_t attempt = 0; attempt < kMaxPlacementAttempts && oCenters.size() < kBoxCount;
+       attempt++) {
+    if (world.raycast(hit, {x(rng), top, z(rng)}, {0.F, -1.F, 0.F}, top)) {
+      oCenters.emplace_back(hit.position.x, hit.position.y + kHalfExtent + 1e-3F,
+                            hit.position.z);
+    }
+  }
+  return oCenters.size() == kBoxCount;
+}
+
+void _benchSweeps(Logger &logger, VoxelCollider &collider, std::vector<glm::vec3> centers,
+                  float frameDistance, char const *name, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> angle{0.F, 6.2831853F};
+  std::vector<glm::vec3> displacements(centers.size());
+  for (glm::vec3 &displacement : displacements) {
+    float const a = angle(rng);
+    // pressed against the ground, so the sweeps slide and step up
+    displacement = frameDistance * glm::vec3{std::cos(a), -0.25F, std::sin(a)};
+  }
+
+  glm::vec3 const halfExtent{kHalfExtent};
+  auto const start = Clock::now();
+  for (uint32_t i = 0; i < kSweepCount; i++) {
+    size_t const box = i % centers.size();
+    centers[box]     = collider.moveBox(centers[box], halfExtent, displacements[box]);
+  }
+  double const seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  logger.info("{}: {:.2f} M sweeps/s, {:.3f} us per sweep", name,
+              static_cast<double>(kSweepCount) / seconds / 1e6,
+              seconds * 1e6 / static_cast<double>(kSweepCount));
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Logger logger{};
+  uint32_t const voxelResolution = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 128;
+  glm::uvec3 const chunksDim{8, 1, 8};
+
+  JobSystem jobSystem{};
+  VoxelWorldMirror world{voxelResolution, chunksDim, false};
+  auto const buildStart = Clock::now();
+  _buildWorld(world, jobSystem, voxelResolution, chunksDim);
+  logger.info("world of {} voxels per chunk axis built in {:.2f} s", voxelResolution,
+              std::chrono::duration<double>(Clock::now() - buildStart).count());
+
+  std::mt19937 rng{1};
+  std::vector<glm::vec3> centers{};
+  if (!_placeBoxes(centers, world, chunksDim, rng)) {
+    logger.error("placed {} of {} boxes in {} attempts, the world has too little ground",
+                 centers.size(), kBoxCount, kMaxPlacementAttempts);
+    return 1;
+  }
+
+  VoxelCollider collider{&world, kStepHeight};
+  _benchSweeps(logger, collider, centers, kFrameDistance, "frame", rng);
+  _benchSweeps(logger, collider, centers, kFrameDistance * 10.F, "lagged frame", rng);
+  return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef ADAPTIVE_SAMPLING_GLSL
+#define ADAPTIVE_SAMPLING_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+// should be synchronized with SvoTracer
+const uint kAdaptiveTileSize = 8;
+
+// the values of the hit image, the shading of a deferred voxel hit is done by svoShading, and its
+// raw image holds the brdf until then
+const uint kVoxelHit         = 1;
+const uint kDeferredVoxelHit = 2;
+
+// a tile is converged once all its pixels have accumulated this many frames, and the relative
+// deviation of its luminance is below the threshold
+const uint kConvergedHistLength         = 32;
+const float kConvergedRelativeDeviation = 0.2;
+// a converged tile is only shaded once in this many frames, the tiles are staggered
+const uint kConvergedTileInterval = 8;
+// the tiles with fresh pixels, or with a noisy history, are shaded with more samples
+const uint kNoisyHistLength         = 4;
+const float kNoisyRelativeDeviation = 0.5;
+const uint kNoisyTileSampleCount    = 2;
+
+uint adaptiveTileCountX() {
+  return (renderInfoUbo.data.lowResSize.x + kAdaptiveTileSize - 1) / kAdaptiveTileSize;
+}
+
+uint adaptiveTileIndex(uvec2 uvi) {
+  return (uvi.y / kAdaptiveTileSize) * adaptiveTileCountX() + uvi.x / kAdaptiveTileSize;
+}
+
+uvec2 adaptiveTileOrigin(uint tileIndex) {
+  uint tileCountX = adaptiveTileCountX();
+  return uvec2(tileIndex % tileCountX, tileIndex / tileCountX) * kAdaptiveTileSize;
+}
+
+#endif // ADAPTIVE_SAMPLING_GLSL
@@ -5,7 +5,12 @@
 
 #include "../include/chunking.glsl"
 #include "../include/ddaMarching.glsl"
+#include "../include/occupancy.glsl"
+#ifdef WIDE_TREE
+#include "../include/wideTreeMarching.glsl"
+#else
 #include "../include/svoMarching.glsl"
+#endif // WIDE_TREE
 
 struct MarchingResult {
   uint iter;
@@ -48,17 +53,31 @@ bool cascadedMarching(out MarchingResult oResult, vec3 o, vec3 d) {
     const ivec3 preOffset   = ivec3(1);
     const vec3 originOffset = preOffset - chunkIndex;
 
-    uint chunkBufferOffset =
-        chunkIndicesBuffer
-            .data[getChunksBufferLinearIndex(uvec3(chunkIndex), sceneInfoBuffer.data.chunksDim)] -
-        1;
+    uint chunkLinearIndex =
+        getChunksBufferLinearIndex(uvec3(chunkIndex), sceneInfoBuffer.data.chunksDim);
+    uint chunkBufferOffset = chunkIndicesBuffer.data[chunkLinearIndex] - 1;
 
     uint chunkIterCount, voxHash;
     vec3 color, pos, nextTracingPos, normal;
     bool lightSourceHit;
     float t;
+#ifdef WIDE_TREE
+    hitVoxel = wideTreeMarching(t, chunkIterCount, color, pos, nextTracingPos, normal, voxHash,
+                                lightSourceHit, o + originOffset, d, chunkBufferOffset);
+#else
+    // the root of the 64-tree is the brick level already, so this is only done for the octree
+    float tSkip;
+    if (!marchBricks(tSkip, o + originOffset, d, chunkBrickMaskBuffer.data[chunkLinearIndex])) {
+      continue;
+    }
     hitVoxel = svoMarching(t, chunkIterCount, color, pos, nextTracingPos, normal, voxHash,
-                           lightSourceHit, o + originOffset, d, chunkBufferOffset);
+                           lightSourceHit, o + originOffset + d * tSkip, d, chunkBufferOffset);
+    t += tSkip;
+    // a dag shares whole chunks as well, so the hash of svoMarching is only unique within the chunk
+    if (sceneInfoBuffer.data.dagCompression != 0) {
+      voxHash = murmurHash12(uvec2(voxHash, chunkLinearIndex));
+    }
+#endif // WIDE_TREE
 
     oResult.iter += chunkIterCount;
     oResult.chunkTraversed++;
@@ -76,4 +95,52 @@ bool cascadedMarching(out MarchingResult oResult, vec3 o, vec3 d) {
   return false;
 }
 
+// occlusion only variant of cascadedMarching, for shadow rays, oT is the distance to the first hit
+bool cascadedMarchingAnyHit(out float oT, vec3 o, vec3 d) {
+  ivec3 chunkIndex;
+  oT = 1e10;
+
+  d = max(abs(d), vec3(kEpsilon)) * (step(0.0, d) * 2.0 - 1.0);
+
+  ivec3 mapPos               = ivec3(floor(o));
+  const vec3 deltaDist       = 1.0 / abs(d);
+  const ivec3 rayStep        = ivec3(sign(d));
+  vec3 sideDist              = (((sign(d) * 0.5) + 0.5) + sign(d) * (vec3(mapPos) - o)) * deltaDist;
+  bool enteredBigBoundingBox = false;
+  uint ddaIteration          = 0;
+  while (ddaMarchingWithSave(chunkIndex, mapPos, sideDist, enteredBigBoundingBox, ddaIteration,
+                             deltaDist, rayStep, o, d)) {
+    const ivec3 preOffset   = ivec3(1);
+    const vec3 originOffset = preOffset - chunkIndex;
+
+    uint chunkLinearIndex =
+        getChunksBufferLinearIndex(uvec3(chunkIndex), sceneInfoBuffer.data.chunksDim);
+    uint chunkBufferOffset = chunkIndicesBuffer.data[chunkLinearIndex] - 1;
+
+    float t;
+#ifdef WIDE_TREE
+    uint iter, cellWord, cellAddress;
+    float cellSize;
+    ivec3 cell;
+    int lastStepAxis;
+    bool hitVoxel = wideTreeMarchingCore(t, iter, cellSize, cell, cellWord, cellAddress,
+                                         lastStepAxis, o + originOffset, d, chunkBufferOffset, 0.0,
+                                         0.0);
+#else
+    float tSkip;
+    if (!marchBricks(tSkip, o + originOffset, d, chunkBrickMaskBuffer.data[chunkLinearIndex])) {
+      continue;
+    }
+    bool hitVoxel = svoMarchingAnyHit(t, o + originOffset + d * tSkip, d, chunkBufferOffset);
+    t += tSkip;
+#endif // WIDE_TREE
+
+    if (hitVoxel) {
+      oT = t;
+      return true;
+    }
+  }
+  return false;
+}
+
 #endif // CASCADED_MARCHING_GLSL
\ No newline at end of file
@@ -4,16 +4,38 @@
 #include "../include/svoTracerDescriptorSetLayouts.glsl"
 
 #include "../include/chunking.glsl"
+#include "../include/occupancy.glsl"
 
 bool _inChunkRange(ivec3 pos) {
   return all(greaterThanEqual(pos, ivec3(0))) && all(lessThan(pos, sceneInfoBuffer.data.chunksDim));
 }
 
+// the chunks that are not built yet have index 0, so they are marched as empty while the scene is
+// built progressively
 bool _hasChunk(uvec3 chunkIndex) {
   return chunkIndicesBuffer
              .data[getChunksBufferLinearIndex(chunkIndex, sceneInfoBuffer.data.chunksDim)] > 0;
 }
 
+bool _hasOccupiedChunkGroup(ivec3 chunkIndex) {
+  uint groupIndex = getChunkGroupLinearIndex(uvec3(chunkIndex), sceneInfoBuffer.data.chunksDim);
+  return chunkGroupOccupancyBuffer.data[groupIndex] != 0;
+}
+
+// moves the dda state to the first chunk after the chunk group that contains mapPos
+void _leapOverChunkGroup(inout ivec3 mapPos, inout vec3 sideDist, ivec3 rayStep, vec3 o, vec3 d) {
+  const int kGroupDim = int(kChunkGroupDim);
+
+  ivec3 groupMin = (mapPos / kGroupDim) * kGroupDim;
+  vec3 tExit3    = (vec3(groupMin) + step(0.0, d) * float(kGroupDim) - o) / d;
+  float tExit    = min(min(tExit3.x, tExit3.y), tExit3.z);
+
+  // the last chunk within the group, then step over the face that the ray leaves from
+  ivec3 lastChunk = clamp(ivec3(floor(o + d * tExit)), groupMin, groupMin + kGroupDim - 1);
+  mapPos          = lastChunk + ivec3(equal(tExit3, vec3(tExit))) * rayStep;
+  sideDist        = (vec3(mapPos) + step(0.0, d) - o) / d;
+}
+
 #define MAX_DDA_ITERATION 50
 
 // this function if used for continuous raymarching, where we need to save the last hit chunk
@@ -22,6 +44,13 @@ bool ddaMarchingWithSave(out ivec3 oChunkIndex, inout ivec3 mapPos, inout vec3 s
                          ivec3 rayStep, vec3 o, vec3 d) {
   bvec3 mask;
   while (it++ < MAX_DDA_ITERATION) {
+    // empty chunk groups are skipped in one step
+    if (_inChunkRange(mapPos) && !_hasOccupiedChunkGroup(mapPos)) {
+      enteredBigBoundingBox = true;
+      _leapOverChunkGroup(mapPos, sideDist, rayStep, o, d);
+      continue;
+    }
+
     mask = lessThanEqual(sideDist.xyz, min(sideDist.yzx, sideDist.zxy));
     sideDist += vec3(mask) * deltaDist;
 
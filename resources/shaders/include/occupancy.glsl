@@ -0,0 +1,64 @@
+#ifndef OCCUPANCY_GLSL
+#define OCCUPANCY_GLSL
+
+// the occupancy structure above the chunk octrees, maintained by chunkIndicesBufferUpdater.comp
+// 1. every chunk has a 64 bit brick mask, a brick is a 4x4x4 subdivision of the chunk, and the bit
+// x + y * 4 + z * 16 is set if the brick has any voxel, which is the same layout as the root node
+// of the 64-tree
+// 2. every 4x4x4 chunks form a chunk group, which is marked if any of its chunks has a voxel
+
+const uint kChunkGroupDim = 4;
+
+uvec3 getChunkGroupsDim(uvec3 chunksDim) {
+  return (chunksDim + kChunkGroupDim - 1) / kChunkGroupDim;
+}
+
+uint getChunkGroupLinearIndex(uvec3 chunkIndex, uvec3 chunksDim) {
+  uvec3 groupIndex = chunkIndex / kChunkGroupDim;
+  uvec3 groupsDim  = getChunkGroupsDim(chunksDim);
+  return groupIndex.x + groupIndex.y * groupsDim.x + groupIndex.z * groupsDim.x * groupsDim.y;
+}
+
+bool brickMaskHasBit(uvec2 brickMask, uint bit) {
+  return ((bit < 32u ? brickMask.x >> bit : brickMask.y >> (bit - 32u)) & 1u) != 0u;
+}
+
+// marches the bricks of a chunk, o is in the range of [1, 2], the same as svoMarching
+// returns false if the ray crosses no occupied brick, otherwise oT is where the ray enters the
+// first occupied brick, so the octree traversal can start from there
+bool marchBricks(out float oT, vec3 o, vec3 d, uvec2 brickMask) {
+  oT = 0;
+
+  vec3 p0      = o - vec3(1);
+  vec3 invD    = 1.0 / d;
+  vec3 tNear3  = min(-p0 * invD, (vec3(1) - p0) * invD);
+  vec3 tFar3   = max(-p0 * invD, (vec3(1) - p0) * invD);
+  float t      = max(max(max(tNear3.x, tNear3.y), tNear3.z), 0.0);
+  float tChunk = min(min(tFar3.x, tFar3.y), tFar3.z);
+  if (t > tChunk) return false;
+
+  ivec3 rayStep = ivec3(sign(d));
+  ivec3 brick   = clamp(ivec3(floor((p0 + t * d) * 4.0)), ivec3(0), ivec3(3));
+
+  // a ray crosses 10 bricks at most
+  for (uint i = 0; i < 10; i++) {
+    if (brickMaskHasBit(brickMask, uint(brick.x + brick.y * 4 + brick.z * 16))) {
+      oT = t;
+      return true;
+    }
+
+    vec3 tBrick = ((vec3(brick) + step(0.0, d)) * 0.25 - p0) * invD;
+    if (tBrick.x <= tBrick.y && tBrick.x <= tBrick.z) {
+      t = tBrick.x, brick.x += rayStep.x;
+    } else if (tBrick.y <= tBrick.z) {
+      t = tBrick.y, brick.y += rayStep.y;
+    } else {
+      t = tBrick.z, brick.z += rayStep.z;
+    }
+
+    if (any(lessThan(brick, ivec3(0))) || any(greaterThan(brick, ivec3(3)))) return false;
+  }
+  return false;
+}
+
+#endif // OCCUPANCY_GLSL
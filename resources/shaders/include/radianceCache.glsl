@@ -0,0 +1,117 @@
+#ifndef RADIANCE_CACHE_GLSL
+#define RADIANCE_CACHE_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/core/hash.glsl"
+
+// the entries of a key are found by linear probing from the hashed slot
+const uint kRadianceCacheProbeCount = 8;
+// the accumulation turns into an exponential moving average after this, so the cache follows the
+// lighting changes
+const uint kRadianceCacheMaxSampleCount = 32;
+// the entries that are not queried for this long are evicted by the update pass
+const uint kRadianceCacheMaxIdleFrames = 256;
+
+// the reserved keys, the probing stops at an empty entry, but goes on past an evicted one, which
+// can be claimed again, a claimed entry is busy until its fields are written
+const uint kRadianceCacheEmptyKey   = 0u;
+const uint kRadianceCacheEvictedKey = 1u;
+const uint kRadianceCacheBusyKey    = 2u;
+
+float radianceCacheVoxelSize() {
+  return exp2(1.0 - float(sceneInfoBuffer.data.voxelLevelCount));
+}
+
+uint radianceCacheFace(vec3 normal) {
+  vec3 absNormal = abs(normal);
+  uint axis      = absNormal.x > absNormal.y ? (absNormal.x > absNormal.z ? 0 : 2)
+                                             : (absNormal.y > absNormal.z ? 1 : 2);
+  return axis * 2 + (normal[axis] < 0.0 ? 1 : 0);
+}
+
+vec3 radianceCacheFaceNormal(uint face) {
+  vec3 normal      = vec3(0.0);
+  normal[face / 2] = (face & 1u) == 0u ? 1.0 : -1.0;
+  return normal;
+}
+
+// the hit position lies on the face, so it is pushed into the voxel before flooring
+uvec3 radianceCacheVoxel(vec3 position, vec3 normal) {
+  float voxelSize = radianceCacheVoxelSize();
+  vec3 inside     = position - normal * 0.5 * voxelSize;
+  return uvec3(max(floor(inside / voxelSize), vec3(0.0)));
+}
+
+// the center of the face, lifted off the surface so the rays leaving it do not hit the voxel itself
+vec3 radianceCacheFacePosition(uvec3 voxel, uint face) {
+  float voxelSize = radianceCacheVoxelSize();
+  vec3 normal     = radianceCacheFaceNormal(face);
+  return (vec3(voxel) + 0.5) * voxelSize + normal * 0.501 * voxelSize;
+}
+
+// never one of the reserved keys, different faces may still share a key
+uint _radianceCacheKey(uvec3 voxel, uint face) {
+  return max(murmurHash14(uvec4(voxel, face)), kRadianceCacheBusyKey + 1u);
+}
+
+// the key is published after the fields, so the entry is never read half written
+bool _claimRadianceCacheEntry(uint index, uint freeKey, uint key, uvec3 voxel, uint face) {
+  if (atomicCompSwap(radianceCacheBuffer.data[index].key, freeKey, kRadianceCacheBusyKey) !=
+      freeKey) {
+    return false;
+  }
+  radianceCacheBuffer.data[index].voxel         = voxel;
+  radianceCacheBuffer.data[index].irradiance    = vec3(0.0);
+  radianceCacheBuffer.data[index].face          = face;
+  radianceCacheBuffer.data[index].sampleCount   = 0u;
+  radianceCacheBuffer.data[index].lastUsedFrame = renderInfoUbo.data.currentSample;
+  memoryBarrierBuffer();
+  atomicExchange(radianceCacheBuffer.data[index].key, key);
+  return true;
+}
+
+// returns the accumulated irradiance of the voxel face, an entry is claimed for the face if it is
+// not cached yet, so the update pass starts accumulating it, an evicted entry on the way is reused
+// before the empty one that ends the probing, returns false if the entry has no samples yet or if
+// the probing runs out of entries
+bool queryRadianceCache(out vec3 oIrradiance, vec3 position, vec3 normal) {
+  oIrradiance = vec3(0.0);
+
+  uint face     = radianceCacheFace(normal);
+  uvec3 voxel   = radianceCacheVoxel(position, normal);
+  uint key      = _radianceCacheKey(voxel, face);
+  uint capacity = radianceCacheBuffer.data.length();
+
+  const uint kNoIndex = 0xFFFFFFFFu;
+  uint evictedIndex   = kNoIndex;
+  uint emptyIndex     = kNoIndex;
+  for (uint i = 0; i < kRadianceCacheProbeCount; i++) {
+    uint index     = (key + i) % capacity;
+    uint storedKey = radianceCacheBuffer.data[index].key;
+    if (storedKey == kRadianceCacheEmptyKey) {
+      emptyIndex = index;
+      break;
+    }
+    if (storedKey == kRadianceCacheEvictedKey) {
+      evictedIndex = evictedIndex == kNoIndex ? index : evictedIndex;
+      continue;
+    }
+    if (storedKey == key && radianceCacheBuffer.data[index].voxel == voxel &&
+        radianceCacheBuffer.data[index].face == face) {
+      radianceCacheBuffer.data[index].lastUsedFrame = renderInfoUbo.data.currentSample;
+      oIrradiance = radianceCacheBuffer.data[index].irradiance;
+      return radianceCacheBuffer.data[index].sampleCount > 0u;
+    }
+  }
+
+  // a lost claim is retried by a later query
+  if (evictedIndex != kNoIndex) {
+    _claimRadianceCacheEntry(evictedIndex, kRadianceCacheEvictedKey, key, voxel, face);
+  } else if (emptyIndex != kNoIndex) {
+    _claimRadianceCacheEntry(emptyIndex, kRadianceCacheEmptyKey, key, voxel, face);
+  }
+  return false;
+}
+
+#endif // RADIANCE_CACHE_GLSL
@@ -0,0 +1,82 @@
+#ifndef SURFACE_SHADING_GLSL
+#define SURFACE_SHADING_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/cascadedMarching.glsl"
+#include "../include/core/definitions.glsl"
+#include "../include/radianceCache.glsl"
+#include "../include/random.glsl"
+#include "../include/skyColor.glsl"
+
+vec3 getShadowRayColor(vec3 o, vec3 d) {
+  float shadowRayT;
+  bool shadowRayHit = cascadedMarchingAnyHit(shadowRayT, o, d);
+  if (shadowRayHit) {
+    return vec3(0.0);
+  }
+  return skyColor(d, true);
+}
+
+vec3 getIndirectRayColor(vec3 o, vec3 d, uvec3 seed, vec3 shadowRayDirReuse) {
+  MarchingResult indirectRayResult;
+
+  bool indirectRayHit = cascadedMarching(indirectRayResult, o, d);
+  if (!indirectRayHit) {
+    // exclude the sun light here!
+    return skyColor(d, false);
+  }
+
+  // the cached irradiance of the hit already includes its shadow ray and the later bounces
+  if (kRadianceCache) {
+    vec3 cachedIrradiance;
+    if (queryRadianceCache(cachedIrradiance, indirectRayResult.position,
+                           indirectRayResult.normal)) {
+      return indirectRayResult.color * kInvPi * cachedIrradiance;
+    }
+  }
+
+  // reuse the shadow ray dir for better performance
+  vec3 shadowRay2Color = vec3(0.0);
+  if (dot(shadowRayDirReuse, indirectRayResult.normal) >= 0.0) {
+    shadowRay2Color = getShadowRayColor(indirectRayResult.nextTracingPosition, shadowRayDirReuse);
+    vec3 brdf       = indirectRayResult.color * kInvPi;
+    const float shadowRayPdf = 1.0 / (0.0001 * kPi);
+    shadowRay2Color *= brdf * dot(shadowRayDirReuse, indirectRayResult.normal) / shadowRayPdf;
+  }
+
+  return shadowRay2Color;
+}
+
+// surface color without brdf
+vec3 computeRawSurfaceCol(vec3 surfacePoint, vec3 normal, uvec3 seed) {
+  vec3 shadowRayDir   = getRandomShadowRay(makeDisturbedSeed(seed, 1));
+  vec3 shadowRayColor = vec3(0.0);
+  if (dot(shadowRayDir, normal) >= 0.0) {
+    shadowRayColor           = getShadowRayColor(surfacePoint, shadowRayDir);
+    const float shadowRayPdf = 1.0 / (0.0001 * kPi);
+    shadowRayColor *= dot(shadowRayDir, normal) / shadowRayPdf;
+  }
+
+  if (!kTraceIndirectRay) {
+    return shadowRayColor;
+  }
+
+  vec3 indirectRayDir   = randomCosineWeightedHemispherePoint(normal, makeDisturbedSeed(seed, 2));
+  vec3 indirectRayColor = getIndirectRayColor(surfacePoint, indirectRayDir, seed, shadowRayDir);
+
+  float indirectRayPdf = dot(indirectRayDir, normal) / kPi;
+  indirectRayColor *= dot(indirectRayDir, normal) / indirectRayPdf;
+
+  return shadowRayColor + indirectRayColor;
+}
+
+// recovers the nextTracingPosition of a primary hit from the g-buffer, the center of the lowest
+// level voxel behind the hit is pushed out of the surface, the same as svoMarching does
+vec3 surfaceTracingPosition(vec3 position, vec3 normal) {
+  float voxelSize  = exp2(1.0 - float(sceneInfoBuffer.data.voxelLevelCount));
+  vec3 voxelCenter = (floor((position - normal * 0.5 * voxelSize) / voxelSize) + 0.5) * voxelSize;
+  return voxelCenter + 0.87 * voxelSize * normal;
+}
+
+#endif // SURFACE_SHADING_GLSL
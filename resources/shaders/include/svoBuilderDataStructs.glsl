@@ -3,7 +3,14 @@
 
 struct G_ChunksInfo {
   uvec3 chunksDim;
+  uint dagCompression; // bool
+};
+
+// pushed before the dispatches that work on a single chunk
+struct G_ChunkPushConstants {
   uvec3 currentlyWritingChunk;
+  // the root address + 1 of the chunk in the appended octree buffer, 0 for an empty chunk
+  uint octreeBufferWriteOffset;
 };
 
 struct G_ChunkEditingInfo {
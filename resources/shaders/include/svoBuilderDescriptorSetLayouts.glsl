@@ -29,10 +29,20 @@ layout(std430, binding = 9) buffer ChunksInfoBuffer { G_ChunksInfo data; }
 chunksInfoBuffer;
 layout(std430, binding = 10) buffer OctreeBufferLengthBuffer { uint data; }
 octreeBufferLengthBuffer;
-layout(std430, binding = 11) buffer OctreeBufferWriteOffsetBuffer { uint data; }
-octreeBufferWriteOffsetBuffer;
 
 layout(std430, binding = 12) buffer ChunkEditingInfo { G_ChunkEditingInfo data; }
 chunkEditingInfo;
+layout(std430, binding = 13) buffer ChunkLeafAttributeBuffer { uint data[]; }
+chunkLeafAttributeBuffer;
+layout(std430, binding = 14) readonly buffer AppendedOctreeBuffer { uint data[]; }
+appendedOctreeBuffer;
+layout(std430, binding = 15) buffer ChunkBrickMaskBuffer { uvec2 data[]; }
+chunkBrickMaskBuffer;
+layout(std430, binding = 16) buffer ChunkGroupOccupancyBuffer { uint data[]; }
+chunkGroupOccupancyBuffer;
+
+// all the builder pipelines share the push constant range
+layout(push_constant) uniform ChunkPushConstants { G_ChunkPushConstants data; }
+chunkPushConstants;
 
 #endif // SVO_BUILDER_DESCRIPTOR_SET_GLSL
\ No newline at end of file
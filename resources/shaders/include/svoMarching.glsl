@@ -2,22 +2,11 @@
 #define SVO_MARCHING_GLSL
 
 #include "../include/core/definitions.glsl"
+#include "../include/core/hash.glsl"
 
 #include "../include/blockColor.glsl"
 #include "../include/blockType.glsl"
-
-vec3 decompressNormal(uint packed) {
-  // extract the components
-  uvec3 quantized;
-  quantized.r = packed & 0x7F;
-  quantized.g = (packed >> 7) & 0x7F;
-  quantized.b = (packed >> 14) & 0x7F;
-
-  // convert back to [-1, 1] range
-  vec3 normal = vec3(quantized) / 127.0 * 2.0 - 1.0;
-
-  return normal;
-}
+#include "../include/voxelProperties.glsl"
 
 const uint STACK_SIZE = 23;
 struct StackItem {
@@ -39,14 +28,24 @@ struct StackItem {
 // 3. all eight childrens are stored if at least one is active, so the parent node masks only need
 // two bits (isLeaf and hasChild), this is different from the paper, which needs 16 bits for
 // that
-
-bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPosition,
-                 out vec3 oNextTracingPosition, out vec3 oNormal, out uint oVoxHash,
-                 out bool oLightSourceHit, vec3 o, vec3 d, uint chunkBufferOffset) {
-  uint parent  = 0;
+// 4. the parent is tracked as an absolute address, child pointers are relative to the chunk by
+// default, and absolute when the chunks are compressed into a dag, since subtrees can be shared
+// across chunks
+
+// the traversal shared by svoMarching and svoMarchingAnyHit, it stops on the first leaf, which is
+// also the closest one, since the children are visited in the order of the ray
+// oPos and oScaleExp2 are the corner and the edge length of the voxel where the traversal stopped,
+// both in the mirrored coordinate system of oOctMask, oTCorner is the t of its far corner
+// oLeaf is the node of the voxel, oVoxHash is its address
+bool svoMarchingCore(out float oT, out uint oIter, out vec3 oPos, out float oScaleExp2,
+                     out uint oOctMask, out vec3 oTCorner, out uint oLeaf, out uint oVoxHash,
+                     vec3 o, vec3 d, uint chunkBufferOffset) {
+  uint parent  = chunkBufferOffset;
   uint iter    = 0;
   uint voxHash = 0;
 
+  uint childPointerBase = sceneInfoBuffer.data.dagCompression != 0 ? 0 : chunkBufferOffset;
+
   vec3 t_coef = 1 / -abs(d);
   vec3 t_bias = t_coef * o;
 
@@ -82,7 +81,7 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
 
     // parent pointer is the address of first largest sub-octree (8 in total) of the parent
     voxHash = parent + (idx ^ oct_mask);
-    if (cur == 0u) cur = octreeBuffer.data[voxHash + chunkBufferOffset];
+    if (cur == 0u) cur = octreeBuffer.data[voxHash];
 
     vec3 t_corner = pos * t_coef - t_bias;
     float tc_max  = min(min(t_corner.x, t_corner.y), t_corner.z);
@@ -104,7 +103,7 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
         }
         h = tc_max;
 
-        parent = cur & 0x3FFFFFFFu;
+        parent = (cur & 0x3FFFFFFFu) + childPointerBase;
 
         idx = 0u;
         --scale;
@@ -162,7 +161,26 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
     }
   }
 
-  vec3 t_corner = t_coef * (pos + scale_exp2) - t_bias;
+  oT         = t_min;
+  oIter      = iter;
+  oPos       = pos;
+  oScaleExp2 = scale_exp2;
+  oOctMask   = oct_mask;
+  oTCorner   = t_coef * (pos + scale_exp2) - t_bias;
+  oLeaf      = cur;
+  oVoxHash   = voxHash;
+
+  return scale < STACK_SIZE && t_min <= t_max;
+}
+
+bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPosition,
+                 out vec3 oNextTracingPosition, out vec3 oNormal, out uint oVoxHash,
+                 out bool oLightSourceHit, vec3 o, vec3 d, uint chunkBufferOffset) {
+  vec3 pos, t_corner;
+  float scale_exp2;
+  uint oct_mask, leaf;
+  bool hit = svoMarchingCore(oT, oIter, pos, scale_exp2, oct_mask, t_corner, leaf, oVoxHash, o, d,
+                             chunkBufferOffset);
 
   vec3 norm = (t_corner.x > t_corner.y && t_corner.x > t_corner.z)
                   ? vec3(-1, 0, 0)
@@ -176,31 +194,47 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
   if ((oct_mask & 2u) != 0u) pos.y = 3 - scale_exp2 - pos.y;
   if ((oct_mask & 4u) != 0u) pos.z = 3 - scale_exp2 - pos.z;
 
+  // in a dag, the surfaces deduplicated into one subtree share their leaf addresses, so the corner
+  // of the voxel is hashed in, the hash is then unique within the chunk up to collisions, and
+  // cascadedMarching hashes in the chunk
+  if (sceneInfoBuffer.data.dagCompression != 0) {
+    oVoxHash = murmurHash14(uvec4(floatBitsToUint(pos), oVoxHash));
+  }
+
   // output results
-  oPosition = clamp(o + t_min * d, pos, pos + scale_exp2);
+  oPosition = clamp(o + oT * d, pos, pos + scale_exp2);
   if (norm.x != 0) oPosition.x = norm.x > 0 ? pos.x + scale_exp2 + kEpsilon : pos.x - kEpsilon;
   if (norm.y != 0) oPosition.y = norm.y > 0 ? pos.y + scale_exp2 + kEpsilon : pos.y - kEpsilon;
   if (norm.z != 0) oPosition.z = norm.z > 0 ? pos.z + scale_exp2 + kEpsilon : pos.z - kEpsilon;
   // oNormal = norm;
 
+  // the properties are only fetched once the traversal is done
+  uint properties = getLeafProperties(leaf, oVoxHash);
+
   // scale_exp2 is the length of the edges of the voxel
-  oNormal = decompressNormal((cur & 0x1FFFFF00u) >> 8);
+  oNormal = decompressNormal((properties & 0x1FFFFF00u) >> 8);
 
   oNextTracingPosition = pos + scale_exp2 * 0.5 + 0.87 * scale_exp2 * oNormal;
   // oNextTracingPosition = oPosition + 1e-7 * norm;
 
   oLightSourceHit = false;
 
-  uint blockType = cur & 0xFF;
+  uint blockType = properties & 0xFF;
 
   oColor = getBlockColor(blockType);
   // oColor = oNormal * 0.5 + 0.5;
 
-  oIter    = iter;
-  oVoxHash = voxHash;
-  oT       = t_min;
+  return hit;
+}
 
-  return scale < STACK_SIZE && t_min <= t_max;
+// occlusion only variant of svoMarching, used by shadow rays, it returns right after the traversal
+// stops on the first leaf, no position, normal or properties are decoded
+bool svoMarchingAnyHit(out float oT, vec3 o, vec3 d, uint chunkBufferOffset) {
+  uint iter, oct_mask, leaf, voxHash;
+  vec3 pos, t_corner;
+  float scale_exp2;
+  return svoMarchingCore(oT, iter, pos, scale_exp2, oct_mask, t_corner, leaf, voxHash, o, d,
+                         chunkBufferOffset);
 }
 
 #endif // SVO_MARCHING_GLSL
\ No newline at end of file
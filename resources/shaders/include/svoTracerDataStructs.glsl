@@ -39,23 +39,18 @@ struct G_EnvironmentInfo {
   float sunSize;
 };
 
+// the bool and int tweakables are specialization constants, see svoTracerSpecializationConstants
 struct G_TweakableParameters {
-  uint debugB1; // bool
   float debugF1;
-  uint debugI1;
   vec3 debugC1;
   float explosure;
-  uint visualizeChunks;  // bool
-  uint visualizeOctree;  // bool
-  uint beamOptimization; // bool
-  uint traceIndirectRay; // bool
-  uint taa;              // bool
 };
 
 struct G_SceneInfo {
   uint beamResolution;
   uint voxelLevelCount;
   uvec3 chunksDim;
+  uint dagCompression; // bool
 };
 
 struct G_TemporalFilterInfo {
@@ -74,9 +69,85 @@ struct G_SpatialFilterInfo {
   uint changingLuminancePhi; // bool
 };
 
+// pushed before every a-trous dispatch
+struct G_ATrousPushConstants {
+  uint iteration; // counts from 0
+};
+
+// the wavefront tracing mode, the secondary rays of the primary hits are queued, binned by their
+// direction octant and origin chunk, and traced by a compact kernel per ray class
+struct G_WavefrontRay {
+  vec3 origin;
+  uint pixelAndSlot; // linear pixel index << 1 | radiance slot of the pixel
+  vec3 dir;
+  uint bin;
+  vec3 weight;
+  uint rankInBin;
+};
+
+// the first three members are the indirect dispatch arguments of the tracing kernel of the queue
+struct G_WavefrontQueueInfo {
+  uint dispatchX;
+  uint dispatchY;
+  uint dispatchZ;
+  uint rayCount;
+};
+
+struct G_WavefrontPixel {
+  vec3 brdf;
+  uint deferred; // bool, the diffuse color of the pixel is resolved from the slots
+  vec3 directRadiance;
+  vec3 indirectRadiance;
+};
+
+// pushed before the binning dispatches
+struct G_WavefrontPushConstants {
+  uint queue;
+};
+
+const uint kShadowMapMaxDirtyRects = 16;
+
+// the texels of the shadow map that are traced in a frame, one slice per frame in flight, the first
+// three members are the indirect dispatch arguments, a workgroup layer per rect
+struct G_ShadowMapUpdateInfo {
+  uint dispatchX;
+  uint dispatchY;
+  uint dispatchZ;
+  uint rectCount;
+  uvec4 rects[kShadowMapMaxDirtyRects]; // min texel in xy, max texel (exclusive) in zw
+};
+
+// pushed before the shadow map dispatch, selects the slice of the update info
+struct G_ShadowMapPushConstants {
+  uint frameSlot;
+};
+
+// the indirect dispatch arguments of svoShading, one workgroup per listed tile
+struct G_TileDispatchInfo {
+  uint dispatchX;
+  uint dispatchY;
+  uint dispatchZ;
+};
+
+// an entry of the hashed radiance cache, it holds the temporally accumulated irradiance of a voxel
+// face, the same quantity as computeRawSurfaceCol of svoTracing
+struct G_RadianceCacheEntry {
+  uvec3 voxel; // in the lowest level voxel units of the whole scene
+  uint key;    // a hash of the voxel and the face, or a reserved key, see radianceCache.glsl
+  vec3 irradiance;
+  uint face; // 0 to 5, the axis of the normal times 2, plus 1 if it points to the negative side
+  uint sampleCount;
+  uint lastUsedFrame;
+};
+
 struct G_OutputInfo {
   vec3 midRayHitPos;
   uint midRayHit; // bool
+  // the marching iterations of all the primary rays of a frame, the sum is split in two words,
+  // since it overflows 32 bits at high resolutions, cleared every frame
+  uint primaryRayIterSumLow;
+  uint primaryRayIterSumHigh;
+  uint primaryRayCount;
 };
 
 #endif // SVO_TRACER_DATA_STRUCTS_GLSL
\ No newline at end of file
@@ -4,6 +4,7 @@
 #extension GL_EXT_shader_image_load_formatted : require
 
 #include "../include/svoTracerDataStructs.glsl"
+#include "../include/svoTracerSpecializationConstants.glsl"
 
 layout(binding = 0) uniform RenderInfoUniformBuffer { G_RenderInfo data; }
 renderInfoUbo;
@@ -21,7 +22,7 @@ layout(binding = 6) readonly uniform image2DArray vec2BlueNoise;
 layout(binding = 7) readonly uniform image2DArray vec3BlueNoise;
 layout(binding = 8) readonly uniform image2DArray weightedCosineBlueNoise;
 
-layout(std430, binding = 9) readonly buffer ChunkIndicesBuffer { uint[] data; }
+layout(std430, binding = 9) readonly buffer ChunkIndicesBuffer { uint data[]; }
 chunkIndicesBuffer;
 
 layout(binding = 10) uniform uimage2D backgroundImage;
@@ -70,11 +71,42 @@ layout(binding = 43) uniform sampler2D shadowMapTexture;
 
 layout(std430, binding = 44) readonly buffer SceneInfoBuffer { G_SceneInfo data; }
 sceneInfoBuffer;
-layout(std430, binding = 45) readonly buffer OctreeBuffer { uint[] data; }
+layout(std430, binding = 45) readonly buffer OctreeBuffer { uint data[]; }
 octreeBuffer;
-layout(binding = 46) readonly buffer ATrousIterationBuffer { uint data; }
-aTrousIterationBuffer;
 layout(binding = 47) buffer OutputInfoBuffer { G_OutputInfo data; }
 outputInfoBuffer;
+layout(std430, binding = 48) readonly buffer LeafAttributeBuffer { uint data[]; }
+leafAttributeBuffer;
+layout(std430, binding = 49) readonly buffer ChunkBrickMaskBuffer { uvec2 data[]; }
+chunkBrickMaskBuffer;
+layout(std430, binding = 50) readonly buffer ChunkGroupOccupancyBuffer { uint data[]; }
+chunkGroupOccupancyBuffer;
+
+// the wavefront queues, the indirect queue is followed by the shadow queue, see wavefront.glsl
+layout(std430, binding = 51) buffer WavefrontRayBuffer { G_WavefrontRay data[]; }
+wavefrontRayBuffer;
+layout(std430, binding = 52) buffer WavefrontSortedRayBuffer { G_WavefrontRay data[]; }
+wavefrontSortedRayBuffer;
+layout(std430, binding = 53) buffer WavefrontQueueInfoBuffer { G_WavefrontQueueInfo data[2]; }
+wavefrontQueueInfoBuffer;
+layout(std430, binding = 54) buffer WavefrontBinBuffer { uint data[]; }
+wavefrontBinBuffer;
+layout(std430, binding = 55) buffer WavefrontPixelBuffer { G_WavefrontPixel data[]; }
+wavefrontPixelBuffer;
+
+// coherent, since the entries are claimed and read by the invocations of other workgroups
+layout(std430, binding = 56) coherent buffer RadianceCacheBuffer { G_RadianceCacheEntry data[]; }
+radianceCacheBuffer;
+
+// the adaptive sampling tiles, see adaptiveSampling.glsl
+layout(std430, binding = 57) buffer TileSampleCountBuffer { uint data[]; }
+tileSampleCountBuffer;
+layout(std430, binding = 58) buffer TileListBuffer { uint data[]; }
+tileListBuffer;
+layout(std430, binding = 59) buffer TileDispatchBuffer { G_TileDispatchInfo data; }
+tileDispatchBuffer;
+
+layout(std430, binding = 60) readonly buffer ShadowMapUpdateBuffer { G_ShadowMapUpdateInfo data[]; }
+shadowMapUpdateBuffer;
 
 #endif // SVO_TRACER_DESCRIPTOR_SET_LAYOUTS_GLSL
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef SVO_TRACER_SPECIALIZATION_CONSTANTS_GLSL
+#define SVO_TRACER_SPECIALIZATION_CONSTANTS_GLSL
+
+// the toggles of the tweakable parameters, the pipelines are specialized with them, so the code of
+// a disabled feature is compiled out, the ids match _makeSpecializationConstants in SvoTracer.cpp
+layout(constant_id = 0) const bool kDebugB1          = false;
+layout(constant_id = 1) const int kDebugI1           = 0;
+layout(constant_id = 2) const bool kVisualizeChunks  = false;
+layout(constant_id = 3) const bool kVisualizeOctree  = false;
+layout(constant_id = 4) const bool kBeamOptimization = true;
+layout(constant_id = 5) const bool kTraceIndirectRay = true;
+layout(constant_id = 6) const bool kTaa              = false;
+layout(constant_id = 7) const bool kWavefrontTracing = false;
+layout(constant_id = 8) const bool kRadianceCache    = true;
+layout(constant_id = 9) const bool kAdaptiveSampling = false;
+
+// the voxel hits are shaded by the wavefront passes instead when both are on
+const bool kAdaptiveShading = kAdaptiveSampling && !kWavefrontTracing;
+
+#endif // SVO_TRACER_SPECIALIZATION_CONSTANTS_GLSL
@@ -0,0 +1,30 @@
+#ifndef VOXEL_PROPERTIES_GLSL
+#define VOXEL_PROPERTIES_GLSL
+
+// leaf nodes store 0xC0000000 | properties, where the properties are
+// bit 0-7: block type, bit 8-28: normal compressed by compressNormal in chunkVoxelCreation.comp
+
+// with SEPARATE_LEAF_ATTRIBUTES, leaf nodes only store the flags, and the properties are stored at
+// the same index of the leaf attribute buffer, so the traversal never touches them
+uint getLeafProperties(uint leafNode, uint leafAddress) {
+#ifdef SEPARATE_LEAF_ATTRIBUTES
+  return leafAttributeBuffer.data[leafAddress];
+#else
+  return leafNode & 0x3FFFFFFFu;
+#endif // SEPARATE_LEAF_ATTRIBUTES
+}
+
+vec3 decompressNormal(uint packed) {
+  // extract the components
+  uvec3 quantized;
+  quantized.r = packed & 0x7F;
+  quantized.g = (packed >> 7) & 0x7F;
+  quantized.b = (packed >> 14) & 0x7F;
+
+  // convert back to [-1, 1] range
+  vec3 normal = vec3(quantized) / 127.0 * 2.0 - 1.0;
+
+  return normal;
+}
+
+#endif // VOXEL_PROPERTIES_GLSL
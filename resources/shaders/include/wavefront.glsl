@@ -0,0 +1,73 @@
+#ifndef WAVEFRONT_GLSL
+#define WAVEFRONT_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/chunking.glsl"
+
+// should be synchronized with SvoTracer
+const uint kWavefrontIndirectQueue = 0;
+const uint kWavefrontShadowQueue   = 1;
+
+// the radiance slots of a pixel
+const uint kWavefrontDirectSlot   = 0;
+const uint kWavefrontIndirectSlot = 1;
+
+uint wavefrontPixelCount() {
+  return renderInfoUbo.data.lowResSize.x * renderInfoUbo.data.lowResSize.y;
+}
+
+uint wavefrontPixelIndex(uvec2 uvi) { return uvi.y * renderInfoUbo.data.lowResSize.x + uvi.x; }
+
+// the same seed as the one of the primary ray of the pixel
+uvec3 wavefrontPixelSeed(uint pixelIndex) {
+  uint width = renderInfoUbo.data.lowResSize.x;
+  return uvec3(pixelIndex % width, pixelIndex / width, renderInfoUbo.data.currentSample);
+}
+
+// a pixel queues at most one indirect ray, and two shadow rays
+uint wavefrontQueueBase(uint queue) {
+  return queue == kWavefrontIndirectQueue ? 0 : wavefrontPixelCount();
+}
+
+uint wavefrontBinBase(uint queue, uint binCount) { return queue * binCount; }
+
+// a bin per direction octant and origin chunk
+uint wavefrontBinCount() {
+  uvec3 chunksDim = sceneInfoBuffer.data.chunksDim;
+  return 8 * chunksDim.x * chunksDim.y * chunksDim.z;
+}
+
+// the bins of the same octant are adjacent, so the rays that go in similar directions are traced by
+// the same waves, and the rays starting from the same chunk fetch the same nodes
+uint wavefrontBin(vec3 o, vec3 d) {
+  uvec3 chunksDim = sceneInfoBuffer.data.chunksDim;
+  uvec3 chunk     = uvec3(clamp(ivec3(floor(o)), ivec3(0), ivec3(chunksDim) - 1));
+  uint octant     = uint(d.x < 0.0) | (uint(d.y < 0.0) << 1) | (uint(d.z < 0.0) << 2);
+  return octant * chunksDim.x * chunksDim.y * chunksDim.z +
+         getChunksBufferLinearIndex(chunk, chunksDim);
+}
+
+void enqueueWavefrontRay(uint queue, vec3 o, vec3 d, vec3 weight, uint pixelIndex, uint slot) {
+  uint index = atomicAdd(wavefrontQueueInfoBuffer.data[queue].rayCount, 1);
+
+  G_WavefrontRay ray;
+  ray.origin       = o;
+  ray.pixelAndSlot = (pixelIndex << 1) | slot;
+  ray.dir          = d;
+  ray.bin          = wavefrontBin(o, d);
+  ray.weight       = weight;
+  ray.rankInBin    = 0;
+  wavefrontRayBuffer.data[wavefrontQueueBase(queue) + index] = ray;
+}
+
+void writeWavefrontRadiance(uint pixelAndSlot, vec3 radiance) {
+  uint pixelIndex = pixelAndSlot >> 1;
+  if ((pixelAndSlot & 1u) == kWavefrontDirectSlot) {
+    wavefrontPixelBuffer.data[pixelIndex].directRadiance = radiance;
+  } else {
+    wavefrontPixelBuffer.data[pixelIndex].indirectRadiance = radiance;
+  }
+}
+
+#endif // WAVEFRONT_GLSL
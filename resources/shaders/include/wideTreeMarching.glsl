@@ -0,0 +1,169 @@
+#ifndef WIDE_TREE_MARCHING_GLSL
+#define WIDE_TREE_MARCHING_GLSL
+
+#include "../include/core/definitions.glsl"
+
+#include "../include/blockColor.glsl"
+#include "../include/blockType.glsl"
+#include "../include/voxelProperties.glsl"
+
+// this is the alternative of svoMarching, selected by defining WIDE_TREE when the pipelines are
+// built, the tree is built by WideTreeBuilder.cpp
+
+// layout of the sparse 64-tree:
+// 1. every node has 4x4x4 children, and is stored as 3 words: the 64 bit child mask (low, high)
+// and the pointer to the first child, relative to the chunk
+// 2. only the existing children are stored, and they are compacted, so a child is located by the
+// popcount of the lower bits of the child mask
+// 3. the children of the last level are the voxels, in the same format as the octree leaves
+// 4. a chunk with 2^(2n) voxels per axis takes n levels, which is half of the octree
+
+const uint kWideTreeMaxLevelCount = 11;
+const uint kWideTreeMaxIteration  = 1024;
+
+bool _wideTreeHasChild(uvec2 childMask, uint bit) {
+  return ((bit < 32u ? childMask.x >> bit : childMask.y >> (bit - 32u)) & 1u) != 0u;
+}
+
+uint _wideTreeChildRank(uvec2 childMask, uint bit) {
+  if (bit < 32u) return bitCount(childMask.x & ((1u << bit) - 1u));
+  return bitCount(childMask.x) + bitCount(childMask.y & ((1u << (bit - 32u)) - 1u));
+}
+
+// o is in the range of [1, 2], the same as svoMarching
+// the marching stops at a cell that is smaller than originalSize + t * directionalSize, pass 0 to
+// both of them to march until a voxel is hit
+// oCell is the coordinate of the cell within the chunk, in the unit of oCellSize
+// oLastStepAxis is the axis of the face that the ray enters the cell from, -1 if the ray starts
+// inside the cell
+bool wideTreeMarchingCore(out float oT, out uint oIter, out float oCellSize, out ivec3 oCell,
+                          out uint oCellWord, out uint oCellAddress, out int oLastStepAxis, vec3 o,
+                          vec3 d, uint chunkBufferOffset, float originalSize,
+                          float directionalSize) {
+  oT            = 0;
+  oIter         = 0;
+  oCellSize     = 1;
+  oCell         = ivec3(0);
+  oCellWord     = 0;
+  oCellAddress  = 0;
+  oLastStepAxis = -1;
+
+  // chunk local position, in the range of [0, 1]
+  vec3 p0   = o - vec3(1);
+  vec3 invD = 1.0 / d;
+
+  vec3 tNear3  = min(-p0 * invD, (vec3(1) - p0) * invD);
+  vec3 tFar3   = max(-p0 * invD, (vec3(1) - p0) * invD);
+  float t      = max(max(tNear3.x, tNear3.y), tNear3.z);
+  float tChunk = min(min(tFar3.x, tFar3.y), tFar3.z);
+  if (t > 0) {
+    oLastStepAxis = t == tNear3.x ? 0 : (t == tNear3.y ? 1 : 2);
+  }
+  t = max(t, 0);
+  if (t > tChunk) return false;
+
+  uint levelCount = sceneInfoBuffer.data.voxelLevelCount / 2u;
+  uint nodeStack[kWideTreeMaxLevelCount];
+
+  ivec3 rayStep  = ivec3(sign(d));
+  uint level     = 0;
+  uint node      = chunkBufferOffset;
+  float cellSize = 0.25;
+  ivec3 cell     = clamp(ivec3(floor((p0 + t * d) / cellSize)), ivec3(0), ivec3(3));
+  int lastAxis   = oLastStepAxis;
+  uint iter      = 0;
+
+  while (iter++ < kWideTreeMaxIteration) {
+    ivec3 local     = cell & 3;
+    uint bit        = uint(local.x + local.y * 4 + local.z * 16);
+    uvec2 childMask = uvec2(octreeBuffer.data[node], octreeBuffer.data[node + 1u]);
+
+    if (_wideTreeHasChild(childMask, bit)) {
+      uint rank       = _wideTreeChildRank(childMask, bit);
+      uint firstChild = octreeBuffer.data[node + 2u] + chunkBufferOffset;
+
+      bool isVoxel        = level == levelCount - 1u;
+      bool reachedDetails = originalSize + t * directionalSize >= cellSize;
+      if (isVoxel || reachedDetails) {
+        oT            = t;
+        oIter         = iter;
+        oCellSize     = cellSize;
+        oCell         = cell;
+        oCellAddress  = isVoxel ? firstChild + rank : firstChild + 3u * rank;
+        oCellWord     = isVoxel ? octreeBuffer.data[oCellAddress] : 0u;
+        oLastStepAxis = lastAxis;
+        return true;
+      }
+
+      // PUSH
+      nodeStack[level] = node;
+      node             = firstChild + 3u * rank;
+      level++;
+      cellSize *= 0.25;
+      // the precision issue is resolved by clamping the cell into the range of the parent
+      ivec3 childCell = ivec3(floor((p0 + t * d) / cellSize));
+      cell            = clamp(childCell, cell * 4, cell * 4 + 3);
+      continue;
+    }
+
+    // ADVANCE
+    vec3 tCell     = ((vec3(cell) + step(0.0, d)) * cellSize - p0) * invD;
+    ivec3 prevCell = cell;
+    if (tCell.x <= tCell.y && tCell.x <= tCell.z) {
+      t = tCell.x, cell.x += rayStep.x, lastAxis = 0;
+    } else if (tCell.y <= tCell.z) {
+      t = tCell.y, cell.y += rayStep.y, lastAxis = 1;
+    } else {
+      t = tCell.z, cell.z += rayStep.z, lastAxis = 2;
+    }
+
+    // POP until the cell is inside the current node
+    while (any(notEqual(cell >> 2, prevCell >> 2))) {
+      // the ray has left the chunk
+      if (level == 0u) {
+        oIter = iter;
+        return false;
+      }
+      level--;
+      node = nodeStack[level];
+      cellSize *= 4.0;
+      cell     = cell >> 2;
+      prevCell = prevCell >> 2;
+    }
+  }
+
+  oIter = iter;
+  return false;
+}
+
+// same interface as svoMarching
+bool wideTreeMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPosition,
+                      out vec3 oNextTracingPosition, out vec3 oNormal, out uint oVoxHash,
+                      out bool oLightSourceHit, vec3 o, vec3 d, uint chunkBufferOffset) {
+  float cellSize;
+  ivec3 cell;
+  uint cellWord, cellAddress;
+  int lastStepAxis;
+  bool hit = wideTreeMarchingCore(oT, oIter, cellSize, cell, cellWord, cellAddress, lastStepAxis,
+                                  o, d, chunkBufferOffset, 0.0, 0.0);
+
+  vec3 voxelMin = vec3(1) + vec3(cell) * cellSize;
+
+  oPosition = clamp(o + oT * d, voxelMin, voxelMin + cellSize);
+  if (lastStepAxis >= 0) {
+    // the ray enters from the face that is facing against the ray direction
+    oPosition[lastStepAxis] =
+        d[lastStepAxis] > 0 ? voxelMin[lastStepAxis] - kEpsilon
+                            : voxelMin[lastStepAxis] + cellSize + kEpsilon;
+  }
+
+  oNormal              = decompressNormal((cellWord & 0x1FFFFF00u) >> 8);
+  oNextTracingPosition = voxelMin + cellSize * 0.5 + 0.87 * cellSize * oNormal;
+  oLightSourceHit      = false;
+  oColor               = getBlockColor(cellWord & 0xFF);
+  oVoxHash             = cellAddress;
+
+  return hit;
+}
+
+#endif // WIDE_TREE_MARCHING_GLSL
@@ -0,0 +1,31 @@
+#include "DeletionQueue.hpp"
+
+#include "FrameScheduler.hpp"
+
+DeletionQueue::DeletionQueue(FrameScheduler *frameScheduler) : _frameScheduler(frameScheduler) {}
+
+DeletionQueue::~DeletionQueue() {
+  while (!_entries.empty()) {
+    std::function<void()> destroyer = std::move(_entries.front().destroyer);
+    _entries.pop_front();
+    destroyer();
+  }
+}
+
+void DeletionQueue::push(std::function<void()> destroyer) {
+  _entries.push_back({_frameScheduler->getSubmittedFrameValue(), std::move(destroyer)});
+}
+
+void DeletionQueue::collect() {
+  if (_entries.empty()) {
+    return;
+  }
+
+  uint64_t const completedFrameValue = _frameScheduler->getCompletedFrameValue();
+  while (!_entries.empty() && _entries.front().frameValue <= completedFrameValue) {
+    // pop before running, so a destroyer may push more entries
+    std::function<void()> destroyer = std::move(_entries.front().destroyer);
+    _entries.pop_front();
+    destroyer();
+  }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+class FrameScheduler;
+
+// destroys the vulkan objects once the gpu has passed all the frames that were submitted when the
+// destruction was requested, so the render loop does not have to wait for the device to be idle
+// before a resource is released
+// the objects that are only used by the compute queue are waited for by their owners
+class DeletionQueue {
+public:
+  DeletionQueue(FrameScheduler *frameScheduler);
+  // runs all the pending destroyers, the device must be idle
+  ~DeletionQueue();
+
+  // disable copy and move
+  DeletionQueue(DeletionQueue const &)            = delete;
+  DeletionQueue(DeletionQueue &&)                 = delete;
+  DeletionQueue &operator=(DeletionQueue const &) = delete;
+  DeletionQueue &operator=(DeletionQueue &&)      = delete;
+
+  // the destroyer should capture the handles by value, because the owner is gone when it runs
+  void push(std::function<void()> destroyer);
+
+  // runs the destroyers of the completed frames, never blocks, call me once per frame
+  void collect();
+
+private:
+  FrameScheduler *_frameScheduler;
+
+  struct Entry {
+    uint64_t frameValue;
+    std::function<void()> destroyer;
+  };
+  // the frame values are non-decreasing from front to back
+  std::deque<Entry> _entries;
+};
@@ -0,0 +1,121 @@
+#include "FrameScheduler.hpp"
+
+#include <algorithm>
+
+FrameScheduler::FrameScheduler(VkDevice device, uint32_t framesInFlight,
+                               uint32_t swapchainImageCount)
+    : _device(device), _framesInFlight(std::max(framesInFlight, 1U)) {
+  VkSemaphoreTypeCreateInfo semaphoreTypeInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+  semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  semaphoreTypeInfo.initialValue  = 0;
+
+  VkSemaphoreCreateInfo timelineSemaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  timelineSemaphoreInfo.pNext = &semaphoreTypeInfo;
+  vkCreateSemaphore(_device, &timelineSemaphoreInfo, nullptr, &_timelineSemaphore);
+
+  VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  _imageAvailableSemaphores.resize(_framesInFlight);
+  for (auto &semaphore : _imageAvailableSemaphores) {
+    vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &semaphore);
+  }
+
+  _createRenderFinishedSemaphores(swapchainImageCount);
+}
+
+FrameScheduler::~FrameScheduler() {
+  waitForFrame(_submittedFrameValue);
+
+  _destroyRenderFinishedSemaphores();
+  for (auto &semaphore : _imageAvailableSemaphores) {
+    vkDestroySemaphore(_device, semaphore, nullptr);
+  }
+  vkDestroySemaphore(_device, _timelineSemaphore, nullptr);
+}
+
+void FrameScheduler::onSwapchainResize(uint32_t swapchainImageCount) {
+  _destroyRenderFinishedSemaphores();
+  _createRenderFinishedSemaphores(swapchainImageCount);
+}
+
+uint32_t FrameScheduler::beginFrame() {
+  uint64_t const frameValue = _submittedFrameValue + 1;
+  _frameSlot                = static_cast<uint32_t>(_submittedFrameValue % _framesInFlight);
+
+  // the frame that used the same slot before
+  if (frameValue > _framesInFlight) {
+    waitForFrame(frameValue - _framesInFlight);
+  }
+  return _frameSlot;
+}
+
+void FrameScheduler::submitFrame(VkQueue queue, uint32_t imageIndex,
+                                 VkCommandBuffer const *commandBuffers,
+                                 uint32_t commandBufferCount) {
+  uint64_t const frameValue = _submittedFrameValue + 1;
+
+  VkSemaphore const signalSemaphores[] = {_renderFinishedSemaphores[imageIndex],
+                                          _timelineSemaphore};
+  // the value of the binary semaphore is ignored
+  uint64_t const signalValues[] = {0, frameValue};
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  timelineInfo.signalSemaphoreValueCount = 2;
+  timelineInfo.pSignalSemaphoreValues    = signalValues;
+
+  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.pNext = &timelineInfo;
+  // wait until the image is ready
+  submitInfo.waitSemaphoreCount = 1;
+  submitInfo.pWaitSemaphores    = &_imageAvailableSemaphores[_frameSlot];
+  // wait for no stage
+  VkPipelineStageFlags waitStages{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+  submitInfo.pWaitDstStageMask = &waitStages;
+
+  submitInfo.signalSemaphoreCount = 2;
+  submitInfo.pSignalSemaphores    = signalSemaphores;
+
+  submitInfo.commandBufferCount = commandBufferCount;
+  submitInfo.pCommandBuffers    = commandBuffers;
+
+  vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+  _submittedFrameValue = frameValue;
+}
+
+uint64_t FrameScheduler::getCompletedFrameValue() const {
+  uint64_t value = 0;
+  vkGetSemaphoreCounterValue(_device, _timelineSemaphore, &value);
+  return value;
+}
+
+bool FrameScheduler::isFrameComplete(uint64_t frameValue) const {
+  return getCompletedFrameValue() >= frameValue;
+}
+
+void FrameScheduler::waitForFrame(uint64_t frameValue) const {
+  // a value that is never signaled would block forever
+  frameValue = std::min(frameValue, _submittedFrameValue);
+  if (frameValue == 0) {
+    return;
+  }
+
+  VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores    = &_timelineSemaphore;
+  waitInfo.pValues        = &frameValue;
+  vkWaitSemaphores(_device, &waitInfo, UINT64_MAX);
+}
+
+void FrameScheduler::_createRenderFinishedSemaphores(uint32_t swapchainImageCount) {
+  VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  _renderFinishedSemaphores.resize(swapchainImageCount);
+  for (auto &semaphore : _renderFinishedSemaphores) {
+    vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &semaphore);
+  }
+}
+
+void FrameScheduler::_destroyRenderFinishedSemaphores() {
+  for (auto &semaphore : _renderFinishedSemaphores) {
+    vkDestroySemaphore(_device, semaphore, nullptr);
+  }
+  _renderFinishedSemaphores.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "volk.h"
+
+#include <cstdint>
+#include <vector>
+
+// paces the frames in flight with a timeline semaphore, the submission of every frame signals a
+// monotonically increasing frame value, so any subsystem can query or wait for the gpu progress of
+// a frame without holding a fence of its own
+// the frame slot (frame value modulo frames in flight) indexes the per-frame resources
+class FrameScheduler {
+public:
+  FrameScheduler(VkDevice device, uint32_t framesInFlight, uint32_t swapchainImageCount);
+  ~FrameScheduler();
+
+  // disable copy and move
+  FrameScheduler(FrameScheduler const &)            = delete;
+  FrameScheduler(FrameScheduler &&)                 = delete;
+  FrameScheduler &operator=(FrameScheduler const &) = delete;
+  FrameScheduler &operator=(FrameScheduler &&)      = delete;
+
+  // the render finished semaphores are per swapchain image, the device must be idle
+  void onSwapchainResize(uint32_t swapchainImageCount);
+
+  // waits until the frame that last used the slot has finished on the gpu, returns the slot of the
+  // new frame, the frame is only counted once it is submitted, so it can be abandoned when the
+  // swapchain image cannot be acquired
+  uint32_t beginFrame();
+  // the command buffers wait for the acquired image, and signal the render finished semaphore of
+  // the image and the frame value
+  void submitFrame(VkQueue queue, uint32_t imageIndex, VkCommandBuffer const *commandBuffers,
+                   uint32_t commandBufferCount);
+
+  [[nodiscard]] uint32_t getFramesInFlight() const { return _framesInFlight; }
+  [[nodiscard]] uint32_t getFrameSlot() const { return _frameSlot; }
+  // the value that the frame being recorded signals once it is finished
+  [[nodiscard]] uint64_t getFrameValue() const { return _submittedFrameValue + 1; }
+  [[nodiscard]] uint64_t getSubmittedFrameValue() const { return _submittedFrameValue; }
+  [[nodiscard]] VkSemaphore getTimelineSemaphore() const { return _timelineSemaphore; }
+  [[nodiscard]] VkSemaphore getImageAvailableSemaphore() const {
+    return _imageAvailableSemaphores[_frameSlot];
+  }
+  [[nodiscard]] VkSemaphore getRenderFinishedSemaphore(uint32_t imageIndex) const {
+    return _renderFinishedSemaphores[imageIndex];
+  }
+
+  // these never block
+  [[nodiscard]] uint64_t getCompletedFrameValue() const;
+  [[nodiscard]] bool isFrameComplete(uint64_t frameValue) const;
+  // blocks until the frame has finished on the gpu, returns at once for frames not yet submitted
+  void waitForFrame(uint64_t frameValue) const;
+
+private:
+  VkDevice _device;
+  uint32_t _framesInFlight;
+
+  VkSemaphore _timelineSemaphore = VK_NULL_HANDLE;
+  std::vector<VkSemaphore> _imageAvailableSemaphores;
+  std::vector<VkSemaphore> _renderFinishedSemaphores;
+
+  uint64_t _submittedFrameValue = 0;
+  uint32_t _frameSlot           = 0;
+
+  void _createRenderFinishedSemaphores(uint32_t swapchainImageCount);
+  void _destroyRenderFinishedSemaphores();
+};
@@ -0,0 +1,244 @@
+#include "StagingRing.hpp"
+
+#include <cstring>
+
+namespace {
+// satisfies the offset alignment of the buffer to image copies of all the formats in use
+VkDeviceSize constexpr kRegionAlignment = 16;
+
+VkDeviceSize _alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// the downloads are small counters, so reading the write-combined memory is acceptable
+uint8_t *_createMappedBuffer(VmaAllocator allocator, VkDeviceSize size, VkBuffer &vkBuffer,
+                             VmaAllocation &allocation) {
+  VkBufferCreateInfo bufferCreateInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferCreateInfo.size  = size;
+  bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+  VmaAllocationCreateInfo allocCreateInfo{};
+  allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocCreateInfo.flags =
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo allocInfo{};
+  vmaCreateBuffer(allocator, &bufferCreateInfo, &allocCreateInfo, &vkBuffer, &allocation,
+                  &allocInfo);
+  return static_cast<uint8_t *>(allocInfo.pMappedData);
+}
+} // namespace
+
+StagingRing::StagingRing(VkDevice device, VmaAllocator allocator, VkQueue queue,
+                         VkCommandPool commandPool, VkDeviceSize capacity)
+    : _device(device), _allocator(allocator), _queue(queue), _commandPool(commandPool),
+      _capacity(capacity) {
+  _mappedAddr = _createMappedBuffer(_allocator, _capacity, _ringBuffer, _ringAllocation);
+}
+
+StagingRing::~StagingRing() {
+  flush();
+  while (!_inFlightBatches.empty()) {
+    _waitForOldestBatch();
+  }
+  for (VkFence fence : _freeFences) {
+    vkDestroyFence(_device, fence, nullptr);
+  }
+  vmaDestroyBuffer(_allocator, _ringBuffer, _ringAllocation);
+}
+
+StagingTicket StagingRing::uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset,
+                                          void const *data, VkDeviceSize size) {
+  Region const region = _allocate(size);
+  if (data != nullptr) {
+    memcpy(region.mappedAddr, data, size);
+  } else {
+    memset(region.mappedAddr, 0, size);
+  }
+  vmaFlushAllocation(_allocator, region.allocation, region.offset, size);
+
+  VkBufferCopy bufCopy = {
+      region.offset, // srcOffset
+      dstOffset,     // dstOffset,
+      size,          // size
+  };
+  vkCmdCopyBuffer(_openBatch.commandBuffer, region.vkBuffer, dstBuffer, 1, &bufCopy);
+  return _openBatch.ticket;
+}
+
+StagingTicket StagingRing::uploadToImage(VkImage dstImage, VkBufferImageCopy region,
+                                         void const *data, VkDeviceSize size) {
+  Region const ringRegion = _allocate(size);
+  memcpy(ringRegion.mappedAddr, data, size);
+  vmaFlushAllocation(_allocator, ringRegion.allocation, ringRegion.offset, size);
+
+  region.bufferOffset = ringRegion.offset;
+  vkCmdCopyBufferToImage(_openBatch.commandBuffer, ringRegion.vkBuffer, dstImage,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  return _openBatch.ticket;
+}
+
+void StagingRing::downloadFromBuffer(VkBuffer srcBuffer, VkDeviceSize srcOffset, void *data,
+                                     VkDeviceSize size) {
+  Region const region = _allocate(size);
+
+  VkBufferCopy bufCopy = {
+      srcOffset,     // srcOffset
+      region.offset, // dstOffset,
+      size,          // size
+  };
+  vkCmdCopyBuffer(_openBatch.commandBuffer, srcBuffer, region.vkBuffer, 1, &bufCopy);
+
+  // the batch is waited for directly, since retiring it would free an overflow buffer
+  flush();
+  vkWaitForFences(_device, 1, &_inFlightBatches.back().fence, VK_TRUE, UINT64_MAX);
+  vmaInvalidateAllocation(_allocator, region.allocation, region.offset, size);
+  memcpy(data, region.mappedAddr, size);
+
+  _retireCompleteBatches();
+}
+
+VkCommandBuffer StagingRing::getCommandBuffer() {
+  if (!_hasOpenBatch) {
+    _beginBatch();
+  }
+  return _openBatch.commandBuffer;
+}
+
+StagingTicket StagingRing::flush() {
+  if (!_hasOpenBatch) {
+    return _openTicket - 1;
+  }
+
+  // make the transferred data visible to the later submissions, and to the host for downloads
+  VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask =
+      VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(_openBatch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1,
+                       &barrier, 0, nullptr, 0, nullptr);
+  vkEndCommandBuffer(_openBatch.commandBuffer);
+
+  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers    = &_openBatch.commandBuffer;
+  vkQueueSubmit(_queue, 1, &submitInfo, _openBatch.fence);
+
+  _inFlightBatches.push_back(std::move(_openBatch));
+  _openBatch    = Batch{};
+  _hasOpenBatch = false;
+  return _openTicket++;
+}
+
+bool StagingRing::isComplete(StagingTicket ticket) {
+  _retireCompleteBatches();
+  return ticket <= _lastCompleteTicket;
+}
+
+void StagingRing::wait(StagingTicket ticket) {
+  if (_hasOpenBatch && ticket >= _openBatch.ticket) {
+    flush();
+  }
+  while (ticket > _lastCompleteTicket && !_inFlightBatches.empty()) {
+    _waitForOldestBatch();
+  }
+}
+
+StagingRing::Region StagingRing::_allocate(VkDeviceSize size) {
+  if (size > _capacity) {
+    OverflowBuffer overflowBuffer{};
+    uint8_t *mappedAddr =
+        _createMappedBuffer(_allocator, size, overflowBuffer.vkBuffer, overflowBuffer.allocation);
+    getCommandBuffer();
+    _openBatch.overflowBuffers.push_back(overflowBuffer);
+    return {overflowBuffer.vkBuffer, 0, overflowBuffer.allocation, mappedAddr};
+  }
+
+  VkDeviceSize offset  = 0;
+  VkDeviceSize padding = 0;
+  while (true) {
+    if (_usedSize == 0) {
+      _head = 0;
+    }
+    offset  = _alignUp(_head, kRegionAlignment);
+    padding = offset - _head;
+    // skip the end of the ring if the region does not fit there
+    if (offset + size > _capacity) {
+      offset  = 0;
+      padding = _capacity - _head;
+    }
+    if (_capacity - _usedSize >= padding + size) {
+      break;
+    }
+    // all the space might be held by the open batch
+    if (_inFlightBatches.empty()) {
+      flush();
+    }
+    _waitForOldestBatch();
+  }
+
+  getCommandBuffer();
+  _openBatch.usedSize += padding + size;
+  _usedSize += padding + size;
+  _head = offset + size;
+  return {_ringBuffer, offset, _ringAllocation, _mappedAddr + offset};
+}
+
+void StagingRing::_beginBatch() {
+  VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocInfo.commandPool        = _commandPool;
+  allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = 1;
+  vkAllocateCommandBuffers(_device, &allocInfo, &_openBatch.commandBuffer);
+
+  if (_freeFences.empty()) {
+    VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    vkCreateFence(_device, &fenceInfo, nullptr, &_openBatch.fence);
+  } else {
+    _openBatch.fence = _freeFences.back();
+    _freeFences.pop_back();
+    vkResetFences(_device, 1, &_openBatch.fence);
+  }
+  _openBatch.ticket = _openTicket;
+
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(_openBatch.commandBuffer, &beginInfo);
+
+  // the transfers must not overtake the earlier submissions that access the same resources
+  VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(_openBatch.commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+  _hasOpenBatch = true;
+}
+
+void StagingRing::_retireCompleteBatches() {
+  while (!_inFlightBatches.empty() &&
+         vkGetFenceStatus(_device, _inFlightBatches.front().fence) == VK_SUCCESS) {
+    _releaseBatch(_inFlightBatches.front());
+    _inFlightBatches.pop_front();
+  }
+}
+
+void StagingRing::_waitForOldestBatch() {
+  if (_inFlightBatches.empty()) {
+    return;
+  }
+  vkWaitForFences(_device, 1, &_inFlightBatches.front().fence, VK_TRUE, UINT64_MAX);
+  _releaseBatch(_inFlightBatches.front());
+  _inFlightBatches.pop_front();
+}
+
+void StagingRing::_releaseBatch(Batch &batch) {
+  vkFreeCommandBuffers(_device, _commandPool, 1, &batch.commandBuffer);
+  _freeFences.push_back(batch.fence);
+  for (OverflowBuffer const &overflowBuffer : batch.overflowBuffers) {
+    vmaDestroyBuffer(_allocator, overflowBuffer.vkBuffer, overflowBuffer.allocation);
+  }
+  _usedSize -= batch.usedSize;
+  _lastCompleteTicket = batch.ticket;
+}
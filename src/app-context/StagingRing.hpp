@@ -0,0 +1,104 @@
+#pragma once
+
+#include "volk.h"
+
+#ifdef __APPLE__
+#include "vk_mem_alloc.h"
+#else
+#include "vma/vk_mem_alloc.h"
+#endif
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// identifies a batch of transfers, the ticket is complete once the gpu has finished the batch
+using StagingTicket = uint64_t;
+
+// a persistently mapped staging buffer that is used as a ring, the transfers are recorded into an
+// open batch, which is submitted by flush with a fence, the ring region of a batch is reclaimed
+// once its fence is signaled, so transfers never wait for the queue to be idle
+// a transfer larger than the ring gets its own staging buffer, which lives as long as its batch
+class StagingRing {
+public:
+  StagingRing(VkDevice device, VmaAllocator allocator, VkQueue queue, VkCommandPool commandPool,
+              VkDeviceSize capacity);
+  ~StagingRing();
+
+  // disable copy and move
+  StagingRing(StagingRing const &)            = delete;
+  StagingRing(StagingRing &&)                 = delete;
+  StagingRing &operator=(StagingRing const &) = delete;
+  StagingRing &operator=(StagingRing &&)      = delete;
+
+  // the data is copied into the ring before returning, zeros are uploaded if data is nullptr
+  StagingTicket uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, void const *data,
+                               VkDeviceSize size);
+  // the image is expected to be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, the buffer offset of the
+  // region is decided by the ring
+  StagingTicket uploadToImage(VkImage dstImage, VkBufferImageCopy region, void const *data,
+                              VkDeviceSize size);
+
+  // copies from the buffer to the host, this submits the open batch and waits for it
+  void downloadFromBuffer(VkBuffer srcBuffer, VkDeviceSize srcOffset, void *data,
+                          VkDeviceSize size);
+
+  // the command buffer of the open batch, for recording the barriers around the transfers, the
+  // batch may be submitted by any transfer that runs out of space, so fetch it right before use
+  VkCommandBuffer getCommandBuffer();
+
+  // submits the open batch and returns its ticket, the batch ends with a barrier, so the
+  // submissions to the same queue afterwards see the transferred data
+  StagingTicket flush();
+
+  [[nodiscard]] bool isComplete(StagingTicket ticket);
+  // submits the batch of the ticket if it is still open
+  void wait(StagingTicket ticket);
+
+private:
+  VkDevice _device;
+  VmaAllocator _allocator;
+  VkQueue _queue;
+  VkCommandPool _commandPool;
+
+  VkDeviceSize _capacity;
+  VkBuffer _ringBuffer              = VK_NULL_HANDLE;
+  VmaAllocation _ringAllocation     = VK_NULL_HANDLE;
+  uint8_t *_mappedAddr              = nullptr;
+  VkDeviceSize _head                = 0;
+  VkDeviceSize _usedSize            = 0;
+  StagingTicket _openTicket         = 1;
+  StagingTicket _lastCompleteTicket = 0;
+
+  struct OverflowBuffer {
+    VkBuffer vkBuffer        = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+  };
+
+  struct Batch {
+    StagingTicket ticket          = 0;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence                 = VK_NULL_HANDLE;
+    // the ring bytes taken by the batch, including the alignment and the wrapping paddings
+    VkDeviceSize usedSize = 0;
+    std::vector<OverflowBuffer> overflowBuffers;
+  };
+
+  struct Region {
+    VkBuffer vkBuffer        = VK_NULL_HANDLE;
+    VkDeviceSize offset      = 0;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    uint8_t *mappedAddr      = nullptr;
+  };
+
+  bool _hasOpenBatch = false;
+  Batch _openBatch{};
+  std::deque<Batch> _inFlightBatches;
+  std::vector<VkFence> _freeFences;
+
+  Region _allocate(VkDeviceSize size);
+  void _beginBatch();
+  void _retireCompleteBatches();
+  void _waitForOldestBatch();
+  void _releaseBatch(Batch &batch);
+};
@@ -4,6 +4,9 @@
 
 #include "VulkanApplicationContext.hpp"
 
+#include "DeletionQueue.hpp"
+#include "FrameScheduler.hpp"
+#include "StagingRing.hpp"
 #include "utils/logger/Logger.hpp"
 
 static const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
@@ -18,8 +21,15 @@ static const std::vector<const char *> requiredDeviceExtensions = {VK_KHR_SWAPCH
 VulkanApplicationContext::VulkanApplicationContext() = default;
 
 VulkanApplicationContext::~VulkanApplicationContext() {
+  // the rings wait for their pending transfers, and the scheduler for the submitted frames
+  _deletionQueue.reset();
+  _graphicsStagingRing.reset();
+  _computeStagingRing.reset();
+  _frameScheduler.reset();
+
   vkDestroyCommandPool(_device, _commandPool, nullptr);
   vkDestroyCommandPool(_device, _guiCommandPool, nullptr);
+  vkDestroyCommandPool(_device, _computeCommandPool, nullptr);
 
   for (auto &swapchainImageView : _swapchainImageViews) {
     vkDestroyImageView(_device, swapchainImageView, nullptr);
@@ -82,20 +92,33 @@ void VulkanApplicationContext::init(Logger *logger, GLFWwindow *window,
   _createSwapchain(settings->isFramerateLimited);
   _createAllocator();
   _createCommandPool();
+  _createStagingRings();
+  _createFrameScheduler(settings->framesInFlight);
+  _deletionQueue = std::make_unique<DeletionQueue>(_frameScheduler.get());
 }
 
 void VulkanApplicationContext::onSwapchainResize(bool isFramerateLimited) {
-  for (auto &swapchainImageView : _swapchainImageViews) {
-    vkDestroyImageView(_device, swapchainImageView, nullptr);
-  }
-  vkDestroySwapchainKHR(_device, _swapchain, nullptr);
-  _createSwapchain(isFramerateLimited);
+  // the old swapchain is retired through the new one, the presentation engine may still hold its
+  // images, so it is destroyed once the frames in flight are done
+  VkSwapchainKHR oldSwapchain = _swapchain;
+  std::vector<VkImageView> oldSwapchainImageViews{};
+  oldSwapchainImageViews.swap(_swapchainImageViews);
+  _createSwapchain(isFramerateLimited, oldSwapchain);
+  _deletionQueue->push([device = _device, oldSwapchain, oldSwapchainImageViews]() {
+    for (auto const &swapchainImageView : oldSwapchainImageViews) {
+      vkDestroyImageView(device, swapchainImageView, nullptr);
+    }
+    vkDestroySwapchainKHR(device, oldSwapchain, nullptr);
+  });
+  _frameScheduler->onSwapchainResize(static_cast<uint32_t>(getSwapchainImagesCount()));
 }
 
-void VulkanApplicationContext::_createSwapchain(bool isFramerateLimited) {
+void VulkanApplicationContext::_createSwapchain(bool isFramerateLimited,
+                                                VkSwapchainKHR oldSwapchain) {
   ContextCreator::createSwapchain(_logger, isFramerateLimited, _swapchain, _swapchainImages,
                                   _swapchainImageViews, _swapchainSurfaceFormat, _swapchainExtent,
-                                  _surface, _device, _physicalDevice, _queueFamilyIndices);
+                                  _surface, _device, _physicalDevice, _queueFamilyIndices,
+                                  oldSwapchain);
 }
 
 void VulkanApplicationContext::_createAllocator() {
@@ -136,8 +159,8 @@ void VulkanApplicationContext::_createAllocator() {
   vmaCreateAllocator(&allocatorInfo, &_allocator);
 }
 
-// create a command pool for rendering commands and a command pool for gui
-// commands (imgui)
+// create a command pool for rendering commands, a command pool for gui
+// commands (imgui) and a command pool for the compute queue
 void VulkanApplicationContext::_createCommandPool() {
   VkCommandPoolCreateInfo commandPoolCreateInfo1{};
   commandPoolCreateInfo1.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -152,4 +175,28 @@ void VulkanApplicationContext::_createCommandPool() {
   commandPoolCreateInfo2.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
   vkCreateCommandPool(_device, &commandPoolCreateInfo2, nullptr, &_guiCommandPool);
+
+  VkCommandPoolCreateInfo commandPoolCreateInfo3{};
+  commandPoolCreateInfo3.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  commandPoolCreateInfo3.queueFamilyIndex = _queueFamilyIndices.computeFamily;
+
+  vkCreateCommandPool(_device, &commandPoolCreateInfo3, nullptr, &_computeCommandPool);
+}
+
+void VulkanApplicationContext::_createStagingRings() {
+  // the startup textures are uploaded through the graphics ring, the chunk data through the compute
+  // ring
+  VkDeviceSize constexpr kMb                     = 1024 * 1024;
+  VkDeviceSize constexpr kGraphicsStagingRingSize = 32 * kMb;
+  VkDeviceSize constexpr kComputeStagingRingSize  = 8 * kMb;
+
+  _graphicsStagingRing = std::make_unique<StagingRing>(_device, _allocator, _graphicsQueue,
+                                                       _commandPool, kGraphicsStagingRingSize);
+  _computeStagingRing  = std::make_unique<StagingRing>(_device, _allocator, _computeQueue,
+                                                      _computeCommandPool, kComputeStagingRingSize);
+}
+
+void VulkanApplicationContext::_createFrameScheduler(uint32_t framesInFlight) {
+  _frameScheduler = std::make_unique<FrameScheduler>(
+      _device, framesInFlight, static_cast<uint32_t>(getSwapchainImagesCount()));
 }
@@ -14,14 +14,19 @@
 #include "vma/vk_mem_alloc.h"
 #endif
 
+#include <memory>
 #include <vector>
 
 class Logger;
+class DeletionQueue;
+class FrameScheduler;
+class StagingRing;
 // also, this class should be configed out of class
 class VulkanApplicationContext {
 public:
   struct GraphicsSettings {
     bool isFramerateLimited;
+    uint32_t framesInFlight;
   };
 
 public:
@@ -46,7 +51,16 @@ public:
 
   [[nodiscard]] inline const VkCommandPool &getCommandPool() const { return _commandPool; }
   [[nodiscard]] inline const VkCommandPool &getGuiCommandPool() const { return _guiCommandPool; }
+  [[nodiscard]] inline const VkCommandPool &getComputeCommandPool() const {
+    return _computeCommandPool;
+  }
   [[nodiscard]] inline const VmaAllocator &getAllocator() const { return _allocator; }
+  // for the transfers submitted to the graphics queue and the compute queue
+  [[nodiscard]] StagingRing *getGraphicsStagingRing() const { return _graphicsStagingRing.get(); }
+  [[nodiscard]] StagingRing *getComputeStagingRing() const { return _computeStagingRing.get(); }
+  [[nodiscard]] FrameScheduler *getFrameScheduler() const { return _frameScheduler.get(); }
+  // the vulkan objects that might still be used by the frames in flight are destroyed through it
+  [[nodiscard]] DeletionQueue *getDeletionQueue() const { return _deletionQueue.get(); }
   [[nodiscard]] inline const std::vector<VkImage> &getSwapchainImages() const {
     return _swapchainImages;
   }
@@ -103,6 +117,13 @@ private:
 
   VkCommandPool _commandPool    = VK_NULL_HANDLE;
   VkCommandPool _guiCommandPool = VK_NULL_HANDLE;
+  // for the command buffers submitted to the compute queue
+  VkCommandPool _computeCommandPool = VK_NULL_HANDLE;
+
+  std::unique_ptr<StagingRing> _graphicsStagingRing;
+  std::unique_ptr<StagingRing> _computeStagingRing;
+  std::unique_ptr<FrameScheduler> _frameScheduler;
+  std::unique_ptr<DeletionQueue> _deletionQueue;
 
   VkDebugUtilsMessengerEXT _debugMessager = VK_NULL_HANDLE;
 
@@ -115,9 +136,11 @@ private:
 
   void _initWindow(uint8_t windowSize);
 
-  void _createSwapchain(bool isFramerateLimited);
+  void _createSwapchain(bool isFramerateLimited, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
   void _createAllocator();
   void _createCommandPool();
+  void _createStagingRings();
+  void _createFrameScheduler(uint32_t framesInFlight);
 
   static std::vector<const char *> _getRequiredInstanceExtensions();
   void _checkDeviceSuitable(VkSurfaceKHR surface, VkPhysicalDevice physicalDevice);
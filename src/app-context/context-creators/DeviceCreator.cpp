@@ -3,11 +3,15 @@
 #include "Common.hpp"
 #include "utils/logger/Logger.hpp"
 
+#include <limits>
 #include <set>
 namespace {
+uint32_t constexpr kUnsetQueueFamily = std::numeric_limits<uint32_t>::max();
+
 bool _queueIndicesAreFilled(const ContextCreator::QueueFamilyIndices &indices) {
-  return indices.computeFamily != -1 && indices.transferFamily != -1 &&
-         indices.graphicsFamily != -1 && indices.presentFamily != -1;
+  return indices.computeFamily != kUnsetQueueFamily &&
+         indices.transferFamily != kUnsetQueueFamily &&
+         indices.graphicsFamily != kUnsetQueueFamily && indices.presentFamily != kUnsetQueueFamily;
 }
 
 bool _findQueueFamilies(ContextCreator::QueueFamilyIndices &indices,
@@ -17,22 +21,37 @@ bool _findQueueFamilies(ContextCreator::QueueFamilyIndices &indices,
   std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
   vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
 
+  indices.graphicsFamily = kUnsetQueueFamily;
+  indices.presentFamily  = kUnsetQueueFamily;
+  indices.computeFamily  = kUnsetQueueFamily;
+  indices.transferFamily = kUnsetQueueFamily;
+
+  // prefer a compute family without graphics support, so the compute work submitted to it can run
+  // alongside the rendering, otherwise the first compute family is used
+  for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+    if ((queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0 &&
+        (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0) {
+      indices.computeFamily = i;
+      break;
+    }
+  }
+
   for (uint32_t i = 0; i < queueFamilyCount; ++i) {
     const auto &queueFamily = queueFamilies[i];
 
-    if (indices.computeFamily == -1) {
+    if (indices.computeFamily == kUnsetQueueFamily) {
       if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) != 0) {
         indices.computeFamily = i;
       }
     }
 
-    if (indices.transferFamily == -1) {
+    if (indices.transferFamily == kUnsetQueueFamily) {
       if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) != 0) {
         indices.transferFamily = i;
       }
     }
 
-    if (indices.graphicsFamily == -1) {
+    if (indices.graphicsFamily == kUnsetQueueFamily) {
       if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0) {
         uint32_t presentSupport = 0;
         vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
@@ -285,15 +304,23 @@ void ContextCreator::createDevice(Logger *logger, VkPhysicalDevice &physicalDevi
     rayTracingStructure.pNext                 = &rayTracingPipeline;
     rayTracingStructure.accelerationStructure = VK_TRUE;
 
+    // used to hand the svo builder's work on the compute queue over to the graphics queue
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphore = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+
     VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexing = {
         VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
-    // descriptorIndexing.pNext = &rayTracingStructure; // uncomment this to
+    descriptorIndexing.pNext = &timelineSemaphore;
+    // timelineSemaphore.pNext = &rayTracingStructure; // uncomment this to
     // enable the features above
 
     physicalDeviceFeatures.pNext = &descriptorIndexing;
 
     vkGetPhysicalDeviceFeatures2(physicalDevice,
                                  &physicalDeviceFeatures); // enable all the features our GPU has
+    if (timelineSemaphore.timelineSemaphore == VK_FALSE) {
+      logger->error("timeline semaphores are not supported by the device!");
+    }
 
     VkDeviceCreateInfo deviceCreateInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
     deviceCreateInfo.pNext                = &physicalDeviceFeatures;
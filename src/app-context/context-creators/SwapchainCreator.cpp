@@ -686,7 +686,8 @@ void ContextCreator::createSwapchain(Logger *logger, bool isFramerateLimited,
                                      VkSurfaceFormatKHR &surfaceFormat, VkExtent2D &swapchainExtent,
                                      const VkSurfaceKHR &surface, const VkDevice &device,
                                      const VkPhysicalDevice &physicalDevice,
-                                     const QueueFamilyIndices &queueFamilyIndices) {
+                                     const QueueFamilyIndices &queueFamilyIndices,
+                                     VkSwapchainKHR oldSwapchain) {
   SwapchainSupportDetails swapchainSupport = _querySwapchainSupport(surface, physicalDevice);
 
   logger->info("all surface formats", swapchainSupport.formats.size());
@@ -754,7 +755,8 @@ void ContextCreator::createSwapchain(Logger *logger, bool isFramerateLimited,
   swapchainCreateInfo.presentMode = presentMode;
   swapchainCreateInfo.clipped     = VK_TRUE;
 
-  swapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
+  // the images of the old swapchain that are not acquired are released
+  swapchainCreateInfo.oldSwapchain = oldSwapchain;
 
   vkCreateSwapchainKHR(device, &swapchainCreateInfo, nullptr, &swapchain);
 
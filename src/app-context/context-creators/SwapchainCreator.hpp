@@ -10,5 +10,6 @@ void createSwapchain(Logger *logger, bool isFramerateLimited, VkSwapchainKHR &sw
                      VkSurfaceFormatKHR &swapchainImageFormat, VkExtent2D &swapchainExtent,
                      const VkSurfaceKHR &surface, const VkDevice &device,
                      const VkPhysicalDevice &physicalDevice,
-                     const QueueFamilyIndices &queueFamilyIndices);
+                     const QueueFamilyIndices &queueFamilyIndices,
+                     VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
 } // namespace ContextCreator
\ No newline at end of file
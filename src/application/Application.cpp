@@ -1,25 +1,54 @@
 #include "application/Application.hpp"
 
+#include "collision/VoxelCollider.hpp"
 #include "svo-builder/SvoBuilder.hpp"
+#include "svo-builder/VoxelWorldMirror.hpp"
 #include "svo-tracer/SvoTracer.hpp"
 
 #include "config-container/ConfigContainer.hpp"
 #include "config-container/sub-config/ApplicationInfo.hpp"
+#include "config-container/sub-config/CameraInfo.hpp"
 
 #include "BlockState.hpp"
+#include "app-context/DeletionQueue.hpp"
+#include "app-context/FrameScheduler.hpp"
+#include "camera/Camera.hpp"
 #include "file-watcher/ShaderChangeListener.hpp"
 #include "imgui-manager/gui-manager/ImguiManager.hpp"
+#include "utils/config/RootDir.h"
 #include "utils/event-dispatcher/GlobalEventDispatcher.hpp"
 #include "utils/fps-sink/FpsSink.hpp"
+#include "utils/job-system/JobSystem.hpp"
 #include "utils/logger/Logger.hpp"
 #include "utils/shader-compiler/ShaderCompiler.hpp"
 #include "window/CursorInfo.hpp"
 #include "window/Window.hpp"
 
+#include <array>
 #include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+// all the compute shaders of a folder, in the same form as the pipelines build their paths
+std::vector<std::string> _listComputeShaders(std::string const &fullPathToFolder) {
+  std::vector<std::string> fullPathsToShaders{};
+  for (auto const &entry : std::filesystem::directory_iterator(fullPathToFolder)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".comp") {
+      fullPathsToShaders.push_back(fullPathToFolder + entry.path().filename().string());
+    }
+  }
+  return fullPathsToShaders;
+}
+} // namespace
 
 // https://www.reddit.com/r/vulkan/comments/10io2l8/is_framesinflight_fif_method_really_worth_it/
-Application::Application(Logger *logger) : _logger(logger) {
+Application::Application(Logger *logger)
+    : _logger(logger), _startupTime(std::chrono::steady_clock::now()) {
+  _jobSystem = std::make_unique<JobSystem>();
+  _logger->info("job system started with {} workers", _jobSystem->getWorkerCount());
+
   _appContext              = std::make_unique<VulkanApplicationContext>();
   _configContainer         = std::make_unique<ConfigContainer>(_logger);
   _shaderFileWatchListener = std::make_unique<ShaderChangeListener>(_logger);
@@ -30,19 +59,47 @@ Application::Application(Logger *logger) : _logger(logger) {
             fullPathToIncludedShaderFile);
       });
 
+  // the builder only keeps the pointers until init, the context is initialized below
+  _svoBuilder =
+      std::make_unique<SvoBuilder>(_appContext.get(), _logger, _shaderCompiler.get(),
+                                   _shaderFileWatchListener.get(), _configContainer.get(),
+                                   _jobSystem.get());
+
+  // the tree layout is decided by the builder, and is compiled into both the builder and the
+  // tracer shaders
+  if (_svoBuilder->isWideTree()) {
+    _shaderCompiler->addMacroDefinition("WIDE_TREE");
+  }
+  if (_svoBuilder->hasSeparateLeafAttributes()) {
+    _shaderCompiler->addMacroDefinition("SEPARATE_LEAF_ATTRIBUTES");
+  }
+
+  // the shaders only depend on the macros above, so they are compiled on the workers while the
+  // window and the vulkan context are created, the pipelines pick up the results
+  JobSystem::JobHandle const shaderPrecompileJob = _jobSystem->schedule([this]() {
+    std::vector<std::string> fullPathsToShaders =
+        _listComputeShaders(kPathToResourceFolder + "shaders/svo-builder/");
+    std::vector<std::string> const tracerShaders =
+        _listComputeShaders(kPathToResourceFolder + "shaders/svo-tracer/");
+    fullPathsToShaders.insert(fullPathsToShaders.end(), tracerShaders.begin(),
+                              tracerShaders.end());
+    _shaderCompiler->precompileComputeShaders(fullPathsToShaders, _jobSystem.get());
+  });
+
   _window = std::make_unique<Window>(WindowStyle::kMaximized, logger);
 
   VulkanApplicationContext::GraphicsSettings settings{};
   settings.isFramerateLimited = _configContainer->applicationInfo->isFramerateLimited;
+  settings.framesInFlight     = _configContainer->applicationInfo->framesInFlight;
   _appContext->init(_logger, _window->getGlWindow(), &settings);
 
-  _svoBuilder =
-      std::make_unique<SvoBuilder>(_appContext.get(), _logger, _shaderCompiler.get(),
-                                   _shaderFileWatchListener.get(), _configContainer.get());
+  _jobSystem->wait(shaderPrecompileJob);
+  _logger->info("shaders precompiled, {:.3f} seconds since startup", _getSecondsSinceStartup());
 
   _svoTracer = std::make_unique<SvoTracer>(
       _appContext.get(), _logger, _configContainer->applicationInfo->framesInFlight, _window.get(),
-      _shaderCompiler.get(), _shaderFileWatchListener.get(), _configContainer.get());
+      _shaderCompiler.get(), _shaderFileWatchListener.get(), _configContainer.get(),
+      _jobSystem.get());
 
   _imguiManager = std::make_unique<ImguiManager>(_appContext.get(), _window.get(), _logger,
                                                  _configContainer.get());
@@ -63,15 +120,7 @@ void Application::run() {
   _cleanup();
 }
 
-void Application::_cleanup() {
-  _logger->info("application is cleaning up resources...");
-
-  for (size_t i = 0; i < _configContainer->applicationInfo->framesInFlight; i++) {
-    vkDestroySemaphore(_appContext->getDevice(), _renderFinishedSemaphores[i], nullptr);
-    vkDestroySemaphore(_appContext->getDevice(), _imageAvailableSemaphores[i], nullptr);
-    vkDestroyFence(_appContext->getDevice(), _framesInFlightFences[i], nullptr);
-  }
-}
+void Application::_cleanup() { _logger->info("application is cleaning up resources..."); }
 
 void Application::_onRenderLoopBlockRequest(E_RenderLoopBlockRequest const &event) {
   _blockStateBits |= event.blockStateBits;
@@ -83,38 +132,19 @@ void Application::_onSwapchainResize() {
   _svoTracer->onSwapchainResize();
 }
 
-void Application::_createSemaphoresAndFences() {
-  _imageAvailableSemaphores.resize(_configContainer->applicationInfo->framesInFlight);
-  _renderFinishedSemaphores.resize(_configContainer->applicationInfo->framesInFlight);
-  _framesInFlightFences.resize(_configContainer->applicationInfo->framesInFlight);
-
-  VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
-
-  VkFenceCreateInfo fenceCreateInfoPreSignalled{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-  fenceCreateInfoPreSignalled.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-  for (size_t i = 0; i < _configContainer->applicationInfo->framesInFlight; i++) {
-    vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr,
-                      &_imageAvailableSemaphores[i]);
-    vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr,
-                      &_renderFinishedSemaphores[i]);
-    vkCreateFence(_appContext->getDevice(), &fenceCreateInfoPreSignalled, nullptr,
-                  &_framesInFlightFences[i]);
-  }
-}
-
 void Application::_drawFrame() {
-  static size_t currentFrame = 0;
-  vkWaitForFences(_appContext->getDevice(), 1, &_framesInFlightFences[currentFrame], VK_TRUE,
-                  UINT64_MAX);
-  vkResetFences(_appContext->getDevice(), 1, &_framesInFlightFences[currentFrame]);
+  FrameScheduler *frameScheduler = _appContext->getFrameScheduler();
+  // waits for the frame that used the same slot, instead of a per-frame fence
+  uint32_t const frameSlot = frameScheduler->beginFrame();
+  _appContext->getDeletionQueue()->collect();
 
   uint32_t imageIndex = 0;
   // this process is fairly quick, but it is related to communicating with the GPU
   // https://stackoverflow.com/questions/60419749/why-does-vkacquirenextimagekhr-never-block-my-thread
   VkResult result =
       vkAcquireNextImageKHR(_appContext->getDevice(), _appContext->getSwapchain(), UINT64_MAX,
-                            _imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+                            frameScheduler->getImageAvailableSemaphore(), VK_NULL_HANDLE,
+                            &imageIndex);
   if (result == VK_ERROR_OUT_OF_DATE_KHR) {
     return;
   }
@@ -129,46 +159,45 @@ void Application::_drawFrame() {
   CursorInfo const &cursorInfo = _window->getCursorInfo();
   if (cursorInfo.cursorState == CursorState::kInvisible &&
       (cursorInfo.leftButtonPressed || cursorInfo.rightButtonPressed)) {
-    auto outputInfo = _svoTracer->getOutputInfo();
-    if (outputInfo.midRayHit) {
-      // _logger->info("mid ray hit at: " + std::to_string(outputInfo.midRayHitPos.x) + ", " +
-      //               std::to_string(outputInfo.midRayHitPos.y) + ", " +
-      //               std::to_string(outputInfo.midRayHitPos.z));
-
-      _svoBuilder->handleCursorHit(outputInfo.midRayHitPos, cursorInfo.leftButtonPressed);
+    VoxelWorldMirror const *voxelWorldMirror = _svoBuilder->getVoxelWorldMirror();
+    if (voxelWorldMirror != nullptr) {
+      // the mirror is up to date, while the output of the tracer is a frame behind
+      Camera const *camera = _svoTracer->getCamera();
+      float const maxT     = glm::length(glm::vec3{_svoBuilder->getChunksDim()});
+      VoxelWorldMirror::RaycastHit hit{};
+      if (voxelWorldMirror->raycast(hit, camera->getPosition(), camera->getFront(), maxT)) {
+        _svoBuilder->handleCursorHit(hit.position, cursorInfo.leftButtonPressed);
+      }
+    } else {
+      auto outputInfo = _svoTracer->getOutputInfo();
+      if (outputInfo.midRayHit) {
+        // _logger->info("mid ray hit at: " + std::to_string(outputInfo.midRayHitPos.x) + ", " +
+        //               std::to_string(outputInfo.midRayHitPos.y) + ", " +
+        //               std::to_string(outputInfo.midRayHitPos.z));
+
+        _svoBuilder->handleCursorHit(outputInfo.midRayHitPos, cursorInfo.leftButtonPressed);
+      }
     }
   }
 
-  _svoTracer->drawFrame(currentFrame);
+  _svoTracer->drawFrame(frameSlot);
 
-  _imguiManager->recordCommandBuffer(currentFrame, imageIndex);
-  std::vector<VkCommandBuffer> submitCommandBuffers = {
-      _svoTracer->getTracingCommandBuffer(currentFrame),
+  _imguiManager->recordCommandBuffer(frameSlot, imageIndex);
+  std::array<VkCommandBuffer, 3> const submitCommandBuffers = {
+      _svoTracer->getTracingCommandBuffer(frameSlot),
       _svoTracer->getDeliveryCommandBuffer(imageIndex),
-      _imguiManager->getCommandBuffer(currentFrame),
+      _imguiManager->getCommandBuffer(frameSlot),
   };
+  frameScheduler->submitFrame(_appContext->getGraphicsQueue(), imageIndex,
+                              submitCommandBuffers.data(),
+                              static_cast<uint32_t>(submitCommandBuffers.size()));
 
-  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  // wait until the image is ready
-  submitInfo.waitSemaphoreCount = 1;
-  submitInfo.pWaitSemaphores    = &_imageAvailableSemaphores[currentFrame];
-  // signal a semaphore after render finished
-  submitInfo.signalSemaphoreCount = 1;
-  submitInfo.pSignalSemaphores    = &_renderFinishedSemaphores[currentFrame];
-  // wait for no stage
-  VkPipelineStageFlags waitStages{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
-  submitInfo.pWaitDstStageMask = &waitStages;
-
-  submitInfo.commandBufferCount = static_cast<uint32_t>(submitCommandBuffers.size());
-  submitInfo.pCommandBuffers    = submitCommandBuffers.data();
-
-  vkQueueSubmit(_appContext->getGraphicsQueue(), 1, &submitInfo,
-                _framesInFlightFences[currentFrame]);
+  VkSemaphore renderFinishedSemaphore = frameScheduler->getRenderFinishedSemaphore(imageIndex);
 
   VkPresentInfoKHR presentInfo{};
   presentInfo.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
   presentInfo.waitSemaphoreCount = 1;
-  presentInfo.pWaitSemaphores    = &_renderFinishedSemaphores[currentFrame];
+  presentInfo.pWaitSemaphores    = &renderFinishedSemaphore;
   presentInfo.swapchainCount     = 1;
   presentInfo.pSwapchains        = &_appContext->getSwapchain();
   presentInfo.pImageIndices      = &imageIndex;
@@ -176,7 +205,10 @@ void Application::_drawFrame() {
 
   vkQueuePresentKHR(_appContext->getPresentQueue(), &presentInfo);
 
-  currentFrame = (currentFrame + 1) % _configContainer->applicationInfo->framesInFlight;
+  if (!_firstFramePresented) {
+    _firstFramePresented = true;
+    _logger->info("time to first frame: {:.3f} seconds", _getSecondsSinceStartup());
+  }
 }
 
 void Application::_waitForTheWindowToBeResumed() {
@@ -197,7 +229,10 @@ void Application::_mainLoop() {
     glfwPollEvents();
 
     if (_blockStateBits != 0) {
-      vkDeviceWaitIdle(_appContext->getDevice());
+      // the command buffers of the frames in flight are re-recorded, the replaced resources go
+      // through the deletion queue, so the device is not waited for as a whole
+      FrameScheduler *frameScheduler = _appContext->getFrameScheduler();
+      frameScheduler->waitForFrame(frameScheduler->getSubmittedFrameValue());
 
       if (_blockStateBits & BlockState::kShaderChanged) {
         GlobalEventDispatcher::get().trigger<E_RenderLoopBlocked>();
@@ -205,10 +240,16 @@ void Application::_mainLoop() {
       }
 
       if (_blockStateBits & BlockState::kWindowResized) {
+        // the render finished semaphores are recreated, they must not be waited by a present
+        vkQueueWaitIdle(_appContext->getPresentQueue());
         _waitForTheWindowToBeResumed();
         _onSwapchainResize();
       }
 
+      if (_blockStateBits & BlockState::kTogglesChanged) {
+        _svoTracer->onTweakableTogglesChanged();
+      }
+
       // reset the block state and timer
       _blockStateBits   = 0;
       fpsRecordLastTime = std::chrono::steady_clock::now();
@@ -225,15 +266,45 @@ void Application::_mainLoop() {
 
     _fpsSink->addRecord(1.0F / deltaTimeInSec);
 
+    _imguiManager->setPrimaryRayIterAverage(_svoTracer->getPrimaryRayIterAverage());
+    // the frames drawn while the scene is still being built are not representative
+    if (_configContainer->applicationInfo->benchmarkFrames > 0 && _svoBuilder->isSceneBuilt()) {
+      _recordBenchmarkFrame(deltaTimeInSec);
+    }
     _imguiManager->draw(_fpsSink.get());
     _svoTracer->processInput(deltaTimeInSec);
 
+    _buildSceneStep();
     _drawFrame();
   }
 
   vkDeviceWaitIdle(_appContext->getDevice());
 }
 
+void Application::_recordBenchmarkFrame(double deltaTimeInSec) {
+  // skips the first frames, the pipelines and the caches are still warming up
+  constexpr int kWarmupFrames = 120;
+
+  _benchmarkFrameCount++;
+  if (_benchmarkFrameCount <= kWarmupFrames) {
+    return;
+  }
+  _benchmarkFrameTimeSum += deltaTimeInSec;
+  _benchmarkIterSum += _svoTracer->getPrimaryRayIterAverage();
+
+  int const recordedFrames = _benchmarkFrameCount - kWarmupFrames;
+  if (recordedFrames < _configContainer->applicationInfo->benchmarkFrames) {
+    return;
+  }
+  _logger->info("benchmark over " + std::to_string(recordedFrames) + " frames, wideTree: " +
+                std::to_string(static_cast<int>(_configContainer->terrainInfo->wideTree)));
+  _logger->info("average frame time: " +
+                std::to_string(1000.0 * _benchmarkFrameTimeSum / recordedFrames) + " ms");
+  _logger->info("average primary ray iterations: " +
+                std::to_string(_benchmarkIterSum / recordedFrames));
+  glfwSetWindowShouldClose(_window->getGlWindow(), 1);
+}
+
 void Application::_init() {
   {
     auto startTime = std::chrono::steady_clock::now();
@@ -247,13 +318,31 @@ void Application::_init() {
   _svoTracer->init(_svoBuilder.get());
   _imguiManager->init();
 
-  _createSemaphoresAndFences();
+  _initCameraCollision();
 
   // attach application-level keyboard listeners
   _window->addKeyboardCallback(
       [this](KeyboardInfo const &keyboardInfo) { _applicationKeyboardCallback(keyboardInfo); });
+}
+
+void Application::_initCameraCollision() {
+  CameraInfo const *cameraInfo = _configContainer->cameraInfo.get();
+  if (!cameraInfo->collision) {
+    return;
+  }
+  VoxelWorldMirror const *voxelWorldMirror = _svoBuilder->getVoxelWorldMirror();
+  if (voxelWorldMirror == nullptr) {
+    _logger->warn("camera collision needs the cpu world mirror, the camera moves freely");
+    return;
+  }
 
-  _buildScene();
+  _voxelCollider =
+      std::make_unique<VoxelCollider>(voxelWorldMirror, cameraInfo->collisionStepHeight);
+  glm::vec3 const halfExtent{cameraInfo->collisionHalfExtent};
+  _svoTracer->getCamera()->setMovementResolver(
+      [this, halfExtent](glm::vec3 position, glm::vec3 displacement) {
+        return _voxelCollider->moveBox(position, halfExtent, displacement);
+      });
 }
 
 void Application::_applicationKeyboardCallback(KeyboardInfo const &keyboardInfo) {
@@ -268,11 +357,25 @@ void Application::_applicationKeyboardCallback(KeyboardInfo const &keyboardInfo)
   }
 }
 
-void Application::_buildScene() {
-  auto startTime = std::chrono::steady_clock::now();
-  _svoBuilder->buildScene();
-  auto endTime = std::chrono::steady_clock::now();
-  auto duration =
-      std::chrono::duration<double, std::chrono::seconds::period>(endTime - startTime).count();
-  _logger->info("svo building time: " + std::to_string(duration) + " seconds");
+// the frames are drawn from the start, with the sky only, the chunks appear as they are built
+void Application::_buildSceneStep() {
+  if (_svoBuilder->isSceneBuilt()) {
+    return;
+  }
+  // the chunks in view are built first, the same matrices as the tracer uses
+  Camera const *camera = _svoTracer->getCamera();
+  glm::mat4 const vpMat =
+      camera->getProjectionMatrix(static_cast<float>(_appContext->getSwapchainExtentWidth()) /
+                                  static_cast<float>(_appContext->getSwapchainExtentHeight())) *
+      camera->getViewMatrix();
+  _svoBuilder->buildSceneStep(camera->getPosition(), vpMat);
+  if (_svoBuilder->isSceneBuilt()) {
+    _logger->info("time to fully built: {:.3f} seconds", _getSecondsSinceStartup());
+  }
+}
+
+double Application::_getSecondsSinceStartup() const {
+  return std::chrono::duration<double, std::chrono::seconds::period>(
+             std::chrono::steady_clock::now() - _startupTime)
+      .count();
 }
@@ -6,6 +6,7 @@
 #include "utils/logger/Logger.hpp"
 #include "window/KeyboardInfo.hpp"
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -21,6 +22,8 @@ class ShadowMapCamera;
 class FpsSink;
 class ShaderCompiler;
 class ShaderChangeListener;
+class JobSystem;
+class VoxelCollider;
 
 class Application {
 public:
@@ -38,6 +41,10 @@ public:
 private:
   Logger *_logger;
 
+  // shared by all the subsystems for their cpu work, so none of them spawns its own threads, it is
+  // destroyed last
+  std::unique_ptr<JobSystem> _jobSystem = nullptr;
+
   std::unique_ptr<VulkanApplicationContext> _appContext          = nullptr;
   std::unique_ptr<ConfigContainer> _configContainer              = nullptr;
   std::unique_ptr<ShaderChangeListener> _shaderFileWatchListener = nullptr;
@@ -47,25 +54,33 @@ private:
   std::unique_ptr<SvoTracer> _svoTracer                          = nullptr;
   std::unique_ptr<ImguiManager> _imguiManager                    = nullptr;
   std::unique_ptr<FpsSink> _fpsSink                              = nullptr;
-
-  // semaphores and fences for synchronization
-  std::vector<VkSemaphore> _imageAvailableSemaphores{};
-  std::vector<VkSemaphore> _renderFinishedSemaphores{};
-  std::vector<VkFence> _framesInFlightFences{};
+  // keeps the camera out of the voxels of the world mirror, null when the collision is off
+  std::unique_ptr<VoxelCollider> _voxelCollider = nullptr;
 
   // BlockState _blockState = BlockState::kUnblocked;
   uint32_t _blockStateBits = 0;
 
+  // the logged timing run, see Application.benchmarkFrames
+  int _benchmarkFrameCount      = 0;
+  double _benchmarkFrameTimeSum = 0;
+  double _benchmarkIterSum      = 0;
+
+  // the time to the first frame and the time to the fully built scene are reported separately
+  std::chrono::steady_clock::time_point _startupTime;
+  bool _firstFramePresented = false;
+
   void _applicationKeyboardCallback(KeyboardInfo const &keyboardInfo);
 
-  void _createSemaphoresAndFences();
   void _onSwapchainResize();
   void _waitForTheWindowToBeResumed();
   void _drawFrame();
   void _mainLoop();
+  void _recordBenchmarkFrame(double deltaTimeInSec);
   void _init();
+  void _initCameraCollision();
   void _cleanup();
 
   void _onRenderLoopBlockRequest(E_RenderLoopBlockRequest const &event);
-  void _buildScene();
+  void _buildSceneStep();
+  [[nodiscard]] double _getSecondsSinceStartup() const;
 };
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <cstdint>
 
 enum BlockState : uint32_t {
-  kShaderChanged = 1U,
-  kWindowResized = 2U,
+  kShaderChanged  = 1U,
+  kWindowResized  = 2U,
+  // the toggles that the pipelines are specialized with have changed
+  kTogglesChanged = 4U,
 };
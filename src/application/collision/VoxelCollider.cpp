@@ -0,0 +1,95 @@
+#include "VoxelCollider.hpp"
+
+#include "../svo-builder/VoxelWorldMirror.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// the gap that is kept to the voxels, in voxels, so the rounding of a resolved move never lets the
+// box sink into the voxel that stopped it
+float constexpr kSkin = 0.01F;
+
+} // namespace
+
+VoxelCollider::VoxelCollider(VoxelWorldMirror const *voxelWorldMirror, float stepHeight)
+    : _voxelWorldMirror(voxelWorldMirror), _stepHeight(stepHeight) {}
+
+glm::vec3 VoxelCollider::moveBox(glm::vec3 center, glm::vec3 halfExtent, glm::vec3 displacement) {
+  if (displacement == glm::vec3{0.F}) {
+    return center;
+  }
+
+  auto const res     = static_cast<float>(_voxelWorldMirror->getVoxelResolution());
+  Box const start    = {(center - halfExtent) * res, (center + halfExtent) * res};
+  glm::vec3 const d  = displacement * res;
+  float const stepUp = _stepHeight * res;
+
+  // one query covers the whole move, the step up included
+  glm::vec3 const sweptMin = glm::min(start.min, start.min + d);
+  glm::vec3 const sweptMax = glm::max(start.max, start.max + d) + glm::vec3{0.F, stepUp, 0.F};
+  _voxels.clear();
+  if (!_voxelWorldMirror->overlapBox((sweptMin - kSkin) / res, (sweptMax + kSkin) / res,
+                                     &_voxels)) {
+    return center + displacement;
+  }
+
+  Box moved                = start;
+  glm::vec3 const resolved = _sweep(moved, d);
+
+  // the step up is taken if it gets further horizontally
+  bool const blockedHorizontally = resolved.x != d.x || resolved.z != d.z;
+  if (stepUp > 0.F && blockedHorizontally) {
+    Box stepped      = start;
+    float const lift = _sweepAxis(stepped, 1, stepUp);
+    _sweepAxis(stepped, 0, d.x);
+    _sweepAxis(stepped, 2, d.z);
+    _sweepAxis(stepped, 1, d.y - lift);
+
+    glm::vec2 const movedDistance{moved.min.x - start.min.x, moved.min.z - start.min.z};
+    glm::vec2 const steppedDistance{stepped.min.x - start.min.x, stepped.min.z - start.min.z};
+    if (glm::dot(steppedDistance, steppedDistance) > glm::dot(movedDistance, movedDistance)) {
+      moved = stepped;
+    }
+  }
+
+  return center + (moved.min - start.min) / res;
+}
+
+glm::vec3 VoxelCollider::_sweep(Box &box, glm::vec3 displacement) const {
+  glm::vec3 resolved{};
+  resolved.y = _sweepAxis(box, 1, displacement.y);
+  resolved.x = _sweepAxis(box, 0, displacement.x);
+  resolved.z = _sweepAxis(box, 2, displacement.z);
+  return resolved;
+}
+
+// the voxels are unit boxes in voxel space, only the ones that overlap the box on the other two
+// axes can stop it, and the ones that it already overlaps on this axis are passed through
+float VoxelCollider::_sweepAxis(Box &box, int axis, float distance) const {
+  if (distance == 0.F) {
+    return 0.F;
+  }
+  int const axisB = (axis + 1) % 3;
+  int const axisC = (axis + 2) % 3;
+
+  for (glm::ivec3 const &voxel : _voxels) {
+    glm::vec3 const voxelMin{voxel};
+    glm::vec3 const voxelMax = voxelMin + 1.F;
+    if (box.min[axisB] >= voxelMax[axisB] || box.max[axisB] <= voxelMin[axisB] ||
+        box.min[axisC] >= voxelMax[axisC] || box.max[axisC] <= voxelMin[axisC]) {
+      continue;
+    }
+
+    if (distance > 0.F && box.max[axis] <= voxelMin[axis] + kSkin) {
+      distance = std::min(distance, std::max(voxelMin[axis] - box.max[axis] - kSkin, 0.F));
+    } else if (distance < 0.F && box.min[axis] >= voxelMax[axis] - kSkin) {
+      distance = std::max(distance, std::min(voxelMax[axis] - box.min[axis] + kSkin, 0.F));
+    }
+  }
+
+  box.min[axis] += distance;
+  box.max[axis] += distance;
+  return distance;
+}
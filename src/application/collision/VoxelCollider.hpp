@@ -0,0 +1,45 @@
+#pragma once
+
+#include "glm/glm.hpp" // IWYU pragma: export
+
+#include <vector>
+
+class VoxelWorldMirror;
+
+// moves axis aligned boxes through the voxel world without letting them enter the voxels, the
+// voxels near the swept box are gathered once per move through the occupancy bricks and the
+// octrees of the mirror, then the move is resolved one axis after another (y, x, z), so a blocked
+// box slides along the surface, and a box that is blocked horizontally steps up the ledges that
+// are not higher than the step height
+class VoxelCollider {
+public:
+  VoxelCollider(VoxelWorldMirror const *voxelWorldMirror, float stepHeight);
+
+  // disable copy and move
+  VoxelCollider(VoxelCollider const &)            = delete;
+  VoxelCollider(VoxelCollider &&)                 = delete;
+  VoxelCollider &operator=(VoxelCollider const &) = delete;
+  VoxelCollider &operator=(VoxelCollider &&)      = delete;
+
+  // returns the center of the box after the move, in world space, a box that already overlaps
+  // voxels can move out of them, it is not pushed out
+  glm::vec3 moveBox(glm::vec3 center, glm::vec3 halfExtent, glm::vec3 displacement);
+
+private:
+  // in voxel space
+  struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+  };
+
+  VoxelWorldMirror const *_voxelWorldMirror;
+  float _stepHeight;
+
+  // the voxels near the swept box, kept across the moves, so a move does not allocate
+  std::vector<glm::ivec3> _voxels;
+
+  // moves the box along the axis until it touches a voxel, returns the distance moved
+  float _sweepAxis(Box &box, int axis, float distance) const;
+  // returns the displacement that is applied
+  glm::vec3 _sweep(Box &box, glm::vec3 displacement) const;
+};
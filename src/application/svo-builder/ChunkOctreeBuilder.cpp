@@ -0,0 +1,179 @@
+#include "ChunkOctreeBuilder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+// the block types and the weight packing of blockTypeAndWeight.glsl
+uint32_t constexpr kBlockTypeEmpty = 0;
+uint32_t constexpr kBlockTypeMax   = 5;
+uint32_t constexpr kWeightBits     = 12;
+uint32_t constexpr kWeightLevels   = (1U << kWeightBits) - 1;
+float constexpr kWeightBoundary    = 1.F / 100.F;
+
+// the fragment coordinates take 10 bits per axis
+uint32_t constexpr kCoordinateBits = 10;
+uint32_t constexpr kCoordinateMask = (1U << kCoordinateBits) - 1;
+
+// refer svoMarching.glsl for the node words
+uint32_t constexpr kHasChildBit   = 0x80000000U;
+uint32_t constexpr kLeafBits      = 0xC0000000U;
+uint32_t constexpr kNodeGroupSize = 8;
+
+float _unpackWeight(uint32_t encodedWeight) {
+  return (static_cast<float>(encodedWeight) / static_cast<float>(kWeightLevels)) *
+             (kWeightBoundary - -kWeightBoundary) +
+         -kWeightBoundary;
+}
+
+// a zero gradient has no direction, it is encoded as the zero normal
+uint32_t _compressNormal(glm::vec3 normal) {
+  float const length = glm::length(normal);
+  normal             = length > 0.F ? normal / length : glm::vec3{0.F};
+  glm::uvec3 const quantized{((normal + 1.F) * 0.5F) * 127.F};
+  return quantized.x | (quantized.y << 7) | (quantized.z << 14);
+}
+
+// the voxel coordinates interleaved, x in the lowest bit of every level, the top level in the
+// highest bits, so sorting by it groups the fragments by the octants at every level
+uint32_t _mortonCode(uint32_t coordinates, uint32_t levelCount) {
+  uint32_t const x = coordinates & kCoordinateMask;
+  uint32_t const y = (coordinates >> kCoordinateBits) & kCoordinateMask;
+  uint32_t const z = (coordinates >> (2 * kCoordinateBits)) & kCoordinateMask;
+
+  uint32_t code = 0;
+  for (uint32_t bit = 0; bit < levelCount; bit++) {
+    code |= ((x >> bit) & 1U) << (3 * bit);
+    code |= ((y >> bit) & 1U) << (3 * bit + 1);
+    code |= ((z >> bit) & 1U) << (3 * bit + 2);
+  }
+  return code;
+}
+} // namespace
+
+G_FragmentListEntry packChunkFragment(glm::uvec3 voxel, uint32_t blockType, glm::vec3 normal) {
+  G_FragmentListEntry fragment{};
+  fragment.coordinates =
+      voxel.x | (voxel.y << kCoordinateBits) | (voxel.z << (2 * kCoordinateBits));
+  fragment.properties = (blockType & 0xFF) | (_compressNormal(normal) << 8);
+  return fragment;
+}
+
+std::vector<G_FragmentListEntry> extractChunkFragments(uint16_t const *field,
+                                                       uint32_t voxelResolution) {
+  size_t const dim = static_cast<size_t>(voxelResolution) + 1;
+  // the corners in the order of lookupOffsets, x | y << 1 | z << 2
+  std::array<size_t, 8> cornerOffsets{};
+  for (uint32_t i = 0; i < 8; i++) {
+    cornerOffsets[i] = (i & 1U) + ((i >> 1) & 1U) * dim + ((i >> 2) & 1U) * dim * dim;
+  }
+
+  std::vector<G_FragmentListEntry> fragments{};
+  for (uint32_t z = 0; z < voxelResolution; z++) {
+    for (uint32_t y = 0; y < voxelResolution; y++) {
+      for (uint32_t x = 0; x < voxelResolution; x++) {
+        uint16_t const *base = field + (z * dim + y) * dim + x;
+
+        // atInterface
+        uint32_t lightestBlockType = kBlockTypeMax;
+        uint32_t densestBlockType  = kBlockTypeEmpty;
+        for (size_t const offset : cornerOffsets) {
+          uint32_t const blockType = base[offset] >> kWeightBits;
+          lightestBlockType        = std::min(lightestBlockType, blockType);
+          densestBlockType         = std::max(densestBlockType, blockType);
+        }
+        if (lightestBlockType != kBlockTypeEmpty || densestBlockType == kBlockTypeEmpty) {
+          continue;
+        }
+
+        // getNormalByWeight
+        std::array<float, 8> w{};
+        for (uint32_t i = 0; i < 8; i++) {
+          w[i] = _unpackWeight(base[cornerOffsets[i]] & kWeightLevels);
+        }
+        glm::vec3 normal{};
+        normal.x = ((w[0] + w[2] + w[4] + w[6]) - (w[1] + w[3] + w[5] + w[7])) * 0.25F;
+        normal.y = ((w[0] + w[1] + w[4] + w[5]) - (w[2] + w[3] + w[6] + w[7])) * 0.25F;
+        normal.z = ((w[0] + w[1] + w[2] + w[3]) - (w[4] + w[5] + w[6] + w[7])) * 0.25F;
+
+        fragments.push_back(packChunkFragment({x, y, z}, densestBlockType, normal));
+      }
+    }
+  }
+  return fragments;
+}
+
+ChunkOctree buildChunkOctreeFromFragments(std::vector<G_FragmentListEntry> const &fragments,
+                                          uint32_t voxelResolution, bool separateLeafAttributes) {
+  ChunkOctree octree{};
+  if (fragments.empty()) {
+    return octree;
+  }
+  auto const levelCount = static_cast<uint32_t>(std::log2(voxelResolution));
+
+  // the morton code and the properties, stable sorted, so the last fragment of a voxel wins
+  std::vector<std::pair<uint32_t, uint32_t>> sortedFragments{};
+  sortedFragments.reserve(fragments.size());
+  for (G_FragmentListEntry const &fragment : fragments) {
+    sortedFragments.emplace_back(_mortonCode(fragment.coordinates, levelCount),
+                                 fragment.properties);
+  }
+  std::stable_sort(sortedFragments.begin(), sortedFragments.end(),
+                   [](auto const &a, auto const &b) { return a.first < b.first; });
+
+  // a node group and the range of the sorted fragments inside of it
+  struct NodeGroup {
+    uint32_t index;
+    size_t begin;
+    size_t end;
+  };
+  std::vector<NodeGroup> groups{{0, 0, sortedFragments.size()}};
+  std::vector<NodeGroup> childGroups{};
+  std::vector<std::pair<uint32_t, uint32_t>> leaves{};
+  octree.nodes.assign(kNodeGroupSize, 0);
+
+  for (uint32_t level = 0; level < levelCount; level++) {
+    uint32_t const shift   = 3 * (levelCount - 1 - level);
+    bool const isLastLevel = level == levelCount - 1;
+
+    for (NodeGroup const &group : groups) {
+      size_t begin = group.begin;
+      while (begin < group.end) {
+        uint32_t const octant = (sortedFragments[begin].first >> shift) & 7U;
+        size_t end            = begin + 1;
+        while (end < group.end && ((sortedFragments[end].first >> shift) & 7U) == octant) {
+          end++;
+        }
+
+        uint32_t const nodeIndex = group.index + octant;
+        if (isLastLevel) {
+          leaves.emplace_back(nodeIndex, sortedFragments[end - 1].second);
+        } else {
+          auto const childGroupIndex = static_cast<uint32_t>(octree.nodes.size());
+          octree.nodes.resize(octree.nodes.size() + kNodeGroupSize, 0);
+          octree.nodes[nodeIndex] = kHasChildBit | childGroupIndex;
+          childGroups.push_back({childGroupIndex, begin, end});
+        }
+        begin = end;
+      }
+    }
+    groups.swap(childGroups);
+    childGroups.clear();
+  }
+
+  // see octreeTagNode.comp
+  if (separateLeafAttributes) {
+    octree.leafAttributes.assign(octree.nodes.size(), 0);
+  }
+  for (auto const &[nodeIndex, properties] : leaves) {
+    if (separateLeafAttributes) {
+      octree.nodes[nodeIndex]          = kLeafBits;
+      octree.leafAttributes[nodeIndex] = properties;
+    } else {
+      octree.nodes[nodeIndex] = kLeafBits | properties;
+    }
+  }
+  return octree;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "SvoBuilderDataGpu.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// the cpu counterpart of chunkVoxelCreation.comp and the octree passes (octreeInitNode,
+// octreeTagNode and octreeAllocNode), so a chunk can be built without the gpu
+
+// the octree has the layout of the chunk octree buffer of the gpu path, the root node group at
+// index 0 and the child pointers relative to the start of the chunk, the leaves are at the last
+// level, the node groups are allocated level by level like on the gpu
+struct ChunkOctree {
+  std::vector<uint32_t> nodes;
+  // only filled with separate leaf attributes, at the same index as the leaf nodes
+  std::vector<uint32_t> leafAttributes;
+};
+
+// the fragment of a voxel of the chunk, packed like chunkVoxelCreation.comp does, the normal does
+// not need to be normalized
+G_FragmentListEntry packChunkFragment(glm::uvec3 voxel, uint32_t blockType, glm::vec3 normal);
+
+// the field has (voxelResolution + 1)^3 packed block types and weights in x, y, z order, see
+// ChunkFieldGenerator, a fragment is emitted for every voxel on the surface
+std::vector<G_FragmentListEntry> extractChunkFragments(uint16_t const *field,
+                                                       uint32_t voxelResolution);
+
+// the octree is empty if there are no fragments, voxelResolution must be a power of 2, if a voxel
+// has multiple fragments, the last one is kept
+ChunkOctree buildChunkOctreeFromFragments(std::vector<G_FragmentListEntry> const &fragments,
+                                          uint32_t voxelResolution, bool separateLeafAttributes);
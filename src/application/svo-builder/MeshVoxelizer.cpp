@@ -0,0 +1,366 @@
+#include "MeshVoxelizer.hpp"
+
+#include "utils/job-system/JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+uint32_t constexpr kMaxTileSize = 16;
+
+// the binning is cheap per triangle, the rasterization of a tile is not
+size_t constexpr kBinningGrainSize = 1 << 14;
+size_t constexpr kTileGrainSize    = 4;
+
+struct TileEntry {
+  uint32_t tile;
+  uint32_t triangle;
+};
+
+// a triangle in the voxel space of a tile, with the parts of the separating axis test that do not
+// depend on the voxel, the voxels are unit boxes, so their projected radius only depends on the
+// axis
+struct TriangleSetup {
+  // not normalized, so the normals of the voxels are weighted by the areas of the triangles
+  glm::vec3 normal;
+  // the voxel centers that overlap the plane are within the radius of the offset
+  float planeOffset;
+  float planeRadius;
+  // the cross products of the edges and the unit axes, the voxel center overlaps the triangle on
+  // an axis if its projection is within the bounds
+  std::array<glm::vec3, 9> axes;
+  std::array<float, 9> lowerBounds;
+  std::array<float, 9> upperBounds;
+  // the inclusive range of the voxels in the tile
+  glm::ivec3 voxelMin;
+  glm::ivec3 voxelMax;
+};
+
+// the inclusive range of the voxels that the bounds touch, the range is empty if any max is below
+// the min
+void _getVoxelRange(glm::ivec3 &oMin, glm::ivec3 &oMax, glm::vec3 boundsMin, glm::vec3 boundsMax,
+                    glm::ivec3 gridDim) {
+  oMin = glm::max(glm::ivec3{glm::floor(boundsMin)}, glm::ivec3{0});
+  oMax = glm::min(glm::ivec3{glm::floor(boundsMax)}, gridDim - 1);
+}
+
+bool _isRangeEmpty(glm::ivec3 min, glm::ivec3 max) {
+  return max.x < min.x || max.y < min.y || max.z < min.z;
+}
+
+glm::ivec3 _getTileIndex(uint32_t tile, glm::ivec3 tilesDim) {
+  auto const t = static_cast<int>(tile);
+  return {t % tilesDim.x, (t / tilesDim.x) % tilesDim.y, t / (tilesDim.x * tilesDim.y)};
+}
+
+// returns false for the triangles without area, and the ones that miss the tile
+bool _setupTriangle(TriangleSetup &oSetup, glm::vec3 v0, glm::vec3 v1, glm::vec3 v2,
+                    int tileSize) {
+  glm::vec3 const e0 = v1 - v0;
+  glm::vec3 const e1 = v2 - v1;
+  glm::vec3 const e2 = v0 - v2;
+  oSetup.normal      = glm::cross(e0, e1);
+  if (oSetup.normal == glm::vec3{0.F}) {
+    return false;
+  }
+
+  _getVoxelRange(oSetup.voxelMin, oSetup.voxelMax, glm::min(v0, glm::min(v1, v2)),
+                 glm::max(v0, glm::max(v1, v2)), glm::ivec3{tileSize});
+  if (_isRangeEmpty(oSetup.voxelMin, oSetup.voxelMax)) {
+    return false;
+  }
+
+  glm::vec3 const absNormal = glm::abs(oSetup.normal);
+  oSetup.planeOffset        = glm::dot(oSetup.normal, v0);
+  oSetup.planeRadius        = 0.5F * (absNormal.x + absNormal.y + absNormal.z);
+
+  std::array<glm::vec3, 3> const edges = {e0, e1, e2};
+  for (uint32_t i = 0; i < 3; i++) {
+    glm::vec3 const &e = edges[i];
+    // e cross x, e cross y, e cross z
+    oSetup.axes[i * 3 + 0] = {0.F, e.z, -e.y};
+    oSetup.axes[i * 3 + 1] = {-e.z, 0.F, e.x};
+    oSetup.axes[i * 3 + 2] = {e.y, -e.x, 0.F};
+  }
+  for (uint32_t i = 0; i < 9; i++) {
+    glm::vec3 const &axis = oSetup.axes[i];
+    float const p0        = glm::dot(axis, v0);
+    float const p1        = glm::dot(axis, v1);
+    float const p2        = glm::dot(axis, v2);
+    float const radius    = 0.5F * (std::abs(axis.x) + std::abs(axis.y) + std::abs(axis.z));
+    oSetup.lowerBounds[i] = std::min(p0, std::min(p1, p2)) - radius;
+    oSetup.upperBounds[i] = std::max(p0, std::max(p1, p2)) + radius;
+  }
+  return true;
+}
+
+// the axes of the voxel are covered by the voxel range, the voxels that only touch the triangle
+// overlap it, so the rasterization is conservative
+bool _overlapsVoxel(TriangleSetup const &setup, glm::vec3 voxelCenter) {
+  if (std::abs(glm::dot(setup.normal, voxelCenter) - setup.planeOffset) > setup.planeRadius) {
+    return false;
+  }
+  for (uint32_t i = 0; i < 9; i++) {
+    float const projection = glm::dot(setup.axes[i], voxelCenter);
+    if (projection < setup.lowerBounds[i] || projection > setup.upperBounds[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// walks the voxel columns along the dominant axis of the normal, so only the voxels around the
+// plane are tested, not all of the bounds, the range of a column is widened a little, the exact
+// test is done anyway
+template <typename Visit>
+void _forEachOverlappedVoxel(TriangleSetup const &setup, Visit const &visit) {
+  glm::vec3 const absNormal = glm::abs(setup.normal);
+  int k                     = absNormal.y > absNormal.x ? 1 : 0;
+  if (absNormal.z > absNormal[k]) {
+    k = 2;
+  }
+  int const a = (k + 1) % 3;
+  int const b = (k + 2) % 3;
+
+  float constexpr kColumnSlack = 1e-3F;
+  float const inverseNormalK   = 1.F / setup.normal[k];
+  float const normalA          = setup.normal[a];
+  float const normalB          = setup.normal[b];
+  // the voxel centers in the slab overlap the plane, a column along k gets its range from the slab
+  float const slabBegin = setup.planeOffset - setup.planeRadius;
+  float const slabEnd   = setup.planeOffset + setup.planeRadius;
+  int const minK        = setup.voxelMin[k];
+  int const maxK        = setup.voxelMax[k];
+
+  std::array<int, 3> voxel{};
+  for (voxel[b] = setup.voxelMin[b]; voxel[b] <= setup.voxelMax[b]; voxel[b]++) {
+    float const restB = normalB * (static_cast<float>(voxel[b]) + 0.5F);
+    for (voxel[a] = setup.voxelMin[a]; voxel[a] <= setup.voxelMax[a]; voxel[a]++) {
+      float const rest = restB + normalA * (static_cast<float>(voxel[a]) + 0.5F);
+      float const t0   = (slabBegin - rest) * inverseNormalK;
+      float const t1   = (slabEnd - rest) * inverseNormalK;
+      int const first =
+          std::max(minK, static_cast<int>(std::ceil(std::min(t0, t1) - 0.5F - kColumnSlack)));
+      int const last =
+          std::min(maxK, static_cast<int>(std::floor(std::max(t0, t1) - 0.5F + kColumnSlack)));
+      for (voxel[k] = first; voxel[k] <= last; voxel[k]++) {
+        glm::ivec3 const v{voxel[0], voxel[1], voxel[2]};
+        if (_overlapsVoxel(setup, glm::vec3{v} + 0.5F)) {
+          visit(v);
+        }
+      }
+    }
+  }
+}
+} // namespace
+
+void fitMeshIntoBox(TriangleMesh &mesh, glm::vec3 boxMin, glm::vec3 boxMax) {
+  if (mesh.positions.empty()) {
+    return;
+  }
+  glm::vec3 meshMin{std::numeric_limits<float>::max()};
+  glm::vec3 meshMax{std::numeric_limits<float>::lowest()};
+  for (glm::vec3 const &position : mesh.positions) {
+    meshMin = glm::min(meshMin, position);
+    meshMax = glm::max(meshMax, position);
+  }
+
+  glm::vec3 const meshSize = meshMax - meshMin;
+  glm::vec3 const boxSize  = boxMax - boxMin;
+  float scale              = std::numeric_limits<float>::max();
+  for (int axis = 0; axis < 3; axis++) {
+    if (meshSize[axis] > 0.F) {
+      scale = std::min(scale, boxSize[axis] / meshSize[axis]);
+    }
+  }
+  if (scale == std::numeric_limits<float>::max()) {
+    scale = 1.F;
+  }
+
+  glm::vec3 const scaledSize = meshSize * scale;
+  glm::vec3 const offset{boxMin.x + (boxSize.x - scaledSize.x) * 0.5F, boxMin.y,
+                         boxMin.z + (boxSize.z - scaledSize.z) * 0.5F};
+  for (glm::vec3 &position : mesh.positions) {
+    position = (position - meshMin) * scale + offset;
+  }
+}
+
+MeshVoxelizer::MeshVoxelizer(JobSystem *jobSystem, uint32_t voxelResolution, glm::uvec3 chunksDim)
+    : _jobSystem(jobSystem), _voxelResolution(voxelResolution), _chunksDim(chunksDim),
+      _tileSize(std::min(voxelResolution, kMaxTileSize)) {}
+
+void MeshVoxelizer::_parallelFor(size_t begin, size_t end, size_t grainSize,
+                                 std::function<void(size_t, size_t)> const &body) const {
+  if (_jobSystem == nullptr) {
+    body(begin, end);
+    return;
+  }
+  _jobSystem->parallelFor(begin, end, grainSize, body);
+}
+
+std::vector<ChunkFragments> MeshVoxelizer::voxelize(TriangleMesh const &mesh,
+                                                    uint32_t blockType) const {
+  auto const res      = static_cast<float>(_voxelResolution);
+  auto const tileSize = static_cast<int>(_tileSize);
+  glm::ivec3 const gridDim{_chunksDim * _voxelResolution};
+
+  // the tiles cover the voxels of the mesh bounds only
+  glm::vec3 meshMin{std::numeric_limits<float>::max()};
+  glm::vec3 meshMax{std::numeric_limits<float>::lowest()};
+  for (glm::vec3 const &position : mesh.positions) {
+    meshMin = glm::min(meshMin, position);
+    meshMax = glm::max(meshMax, position);
+  }
+  glm::ivec3 meshVoxelMin{};
+  glm::ivec3 meshVoxelMax{};
+  _getVoxelRange(meshVoxelMin, meshVoxelMax, meshMin * res, meshMax * res, gridDim);
+  if (mesh.indices.empty() || _isRangeEmpty(meshVoxelMin, meshVoxelMax)) {
+    return {};
+  }
+  glm::ivec3 const tileMin   = meshVoxelMin / tileSize;
+  glm::ivec3 const tilesDim  = meshVoxelMax / tileSize - tileMin + 1;
+  size_t const tileCount     = static_cast<size_t>(tilesDim.x) * tilesDim.y * tilesDim.z;
+  size_t const triangleCount = mesh.getTriangleCount();
+
+  // the triangles are binned to the tiles of their bounds in blocks, the blocks are merged in
+  // order, so the triangles of a tile stay in the order of the mesh
+  size_t const blockCount = (triangleCount + kBinningGrainSize - 1) / kBinningGrainSize;
+  std::vector<std::vector<TileEntry>> blockEntries(blockCount);
+  _parallelFor(0, blockCount, 1, [&](size_t blockBegin, size_t blockEnd) {
+    for (size_t block = blockBegin; block < blockEnd; block++) {
+      size_t const end = std::min(triangleCount, (block + 1) * kBinningGrainSize);
+      for (size_t triangle = block * kBinningGrainSize; triangle < end; triangle++) {
+        glm::vec3 const v0 = mesh.positions[mesh.indices[triangle * 3 + 0]] * res;
+        glm::vec3 const v1 = mesh.positions[mesh.indices[triangle * 3 + 1]] * res;
+        glm::vec3 const v2 = mesh.positions[mesh.indices[triangle * 3 + 2]] * res;
+        glm::ivec3 voxelMin{};
+        glm::ivec3 voxelMax{};
+        _getVoxelRange(voxelMin, voxelMax, glm::min(v0, glm::min(v1, v2)),
+                       glm::max(v0, glm::max(v1, v2)), gridDim);
+        if (_isRangeEmpty(voxelMin, voxelMax)) {
+          continue;
+        }
+
+        glm::ivec3 const first = voxelMin / tileSize - tileMin;
+        glm::ivec3 const last  = voxelMax / tileSize - tileMin;
+        for (int z = first.z; z <= last.z; z++) {
+          for (int y = first.y; y <= last.y; y++) {
+            for (int x = first.x; x <= last.x; x++) {
+              auto const tile = static_cast<uint32_t>((z * tilesDim.y + y) * tilesDim.x + x);
+              blockEntries[block].push_back({tile, static_cast<uint32_t>(triangle)});
+            }
+          }
+        }
+      }
+    }
+  });
+
+  // a counting sort of the entries by tile
+  std::vector<uint32_t> tileOffsets(tileCount + 1, 0);
+  for (auto const &entries : blockEntries) {
+    for (TileEntry const &entry : entries) {
+      tileOffsets[entry.tile + 1]++;
+    }
+  }
+  std::vector<uint32_t> occupiedTiles{};
+  for (size_t tile = 0; tile < tileCount; tile++) {
+    if (tileOffsets[tile + 1] != 0) {
+      occupiedTiles.push_back(static_cast<uint32_t>(tile));
+    }
+    tileOffsets[tile + 1] += tileOffsets[tile];
+  }
+  std::vector<uint32_t> tileTriangles(tileOffsets.back());
+  std::vector<uint32_t> tileCursors(tileOffsets.begin(), tileOffsets.end() - 1);
+  for (auto &entries : blockEntries) {
+    for (TileEntry const &entry : entries) {
+      tileTriangles[tileCursors[entry.tile]++] = entry.triangle;
+    }
+    entries = {};
+  }
+
+  std::vector<std::vector<G_FragmentListEntry>> tileFragments(occupiedTiles.size());
+  _parallelFor(0, occupiedTiles.size(), kTileGrainSize, [&](size_t begin, size_t end) {
+    size_t const tileVoxelCount = static_cast<size_t>(_tileSize) * _tileSize * _tileSize;
+    std::vector<glm::vec3> normalSums(tileVoxelCount);
+    // when the sides of a thin sheet cancel each other out, the normal of the first triangle is
+    // kept
+    std::vector<glm::vec3> firstNormals(tileVoxelCount);
+    std::vector<uint8_t> occupied(tileVoxelCount, 0);
+    // the voxels in the order they are hit, so a tile never walks all of its voxels
+    std::vector<uint32_t> hitVoxels{};
+
+    for (size_t i = begin; i < end; i++) {
+      uint32_t const tile         = occupiedTiles[i];
+      glm::ivec3 const tileOrigin = (tileMin + _getTileIndex(tile, tilesDim)) * tileSize;
+      glm::vec3 const origin{tileOrigin};
+
+      for (uint32_t entry = tileOffsets[tile]; entry < tileOffsets[tile + 1]; entry++) {
+        uint32_t const triangle = tileTriangles[entry];
+        // the vertices relative to the tile keep the precision of the tests in large worlds
+        TriangleSetup setup{};
+        if (!_setupTriangle(setup, mesh.positions[mesh.indices[triangle * 3 + 0]] * res - origin,
+                            mesh.positions[mesh.indices[triangle * 3 + 1]] * res - origin,
+                            mesh.positions[mesh.indices[triangle * 3 + 2]] * res - origin,
+                            tileSize)) {
+          continue;
+        }
+
+        _forEachOverlappedVoxel(setup, [&](glm::ivec3 voxel) {
+          auto const index = static_cast<uint32_t>((voxel.z * tileSize + voxel.y) * tileSize +
+                                                   voxel.x);
+          if (occupied[index] == 0) {
+            occupied[index]     = 1;
+            normalSums[index]   = setup.normal;
+            firstNormals[index] = setup.normal;
+            hitVoxels.push_back(index);
+            return;
+          }
+          normalSums[index] += setup.normal;
+        });
+      }
+
+      // a tile lies in a single chunk
+      glm::uvec3 const chunkVoxelOrigin{tileOrigin % static_cast<int>(_voxelResolution)};
+      std::vector<G_FragmentListEntry> &fragments = tileFragments[i];
+      fragments.reserve(hitVoxels.size());
+      for (uint32_t const index : hitVoxels) {
+        glm::uvec3 const voxel{index % _tileSize, (index / _tileSize) % _tileSize,
+                               index / (_tileSize * _tileSize)};
+        glm::vec3 const &sum   = normalSums[index];
+        glm::vec3 const &first = firstNormals[index];
+        bool const cancelled   = glm::dot(sum, sum) <= 1e-6F * glm::dot(first, first);
+        fragments.push_back(
+            packChunkFragment(chunkVoxelOrigin + voxel, blockType, cancelled ? first : sum));
+        occupied[index] = 0;
+      }
+      hitVoxels.clear();
+    }
+  });
+
+  // the tiles are gathered by chunk
+  std::vector<std::vector<G_FragmentListEntry>> chunkFragments(
+      static_cast<size_t>(_chunksDim.x) * _chunksDim.y * _chunksDim.z);
+  for (size_t i = 0; i < occupiedTiles.size(); i++) {
+    glm::ivec3 const tileOrigin = (tileMin + _getTileIndex(occupiedTiles[i], tilesDim)) * tileSize;
+    glm::uvec3 const chunkIndex{tileOrigin / static_cast<int>(_voxelResolution)};
+    auto &fragments = chunkFragments[chunkIndex.x + chunkIndex.y * _chunksDim.x +
+                                     chunkIndex.z * _chunksDim.x * _chunksDim.y];
+    fragments.insert(fragments.end(), tileFragments[i].begin(), tileFragments[i].end());
+  }
+
+  std::vector<ChunkFragments> result{};
+  for (size_t i = 0; i < chunkFragments.size(); i++) {
+    if (chunkFragments[i].empty()) {
+      continue;
+    }
+    auto const linearIndex = static_cast<uint32_t>(i);
+    glm::uvec3 const chunkIndex{linearIndex % _chunksDim.x,
+                                (linearIndex / _chunksDim.x) % _chunksDim.y,
+                                linearIndex / (_chunksDim.x * _chunksDim.y)};
+    result.push_back({chunkIndex, std::move(chunkFragments[i])});
+  }
+  return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ChunkOctreeBuilder.hpp"
+#include "TriangleMesh.hpp"
+
+#include "glm/glm.hpp" // IWYU pragma: export
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class JobSystem;
+
+// the fragments of the voxels of a chunk, in no particular order, see buildChunkOctreeFromFragments
+struct ChunkFragments {
+  glm::uvec3 chunkIndex;
+  std::vector<G_FragmentListEntry> fragments;
+};
+
+// scales the mesh uniformly and moves it, so its bounds fit in the box, centered on x and z, and
+// resting on the bottom of the box
+void fitMeshIntoBox(TriangleMesh &mesh, glm::vec3 boxMin, glm::vec3 boxMax);
+
+// a conservative rasterizer of triangle meshes into the chunks of the terrain, every voxel that a
+// triangle touches gets a fragment, the triangles are binned into cubic tiles of voxels first, a
+// tile lies in a single chunk and is rasterized by a single job, so the jobs share nothing, within
+// a tile a triangle is tested against the voxels of its bounds with the separating axis test
+class MeshVoxelizer {
+public:
+  // the job system is optional, everything is done on the calling thread without it
+  MeshVoxelizer(JobSystem *jobSystem, uint32_t voxelResolution, glm::uvec3 chunksDim);
+
+  // disable copy and move
+  MeshVoxelizer(MeshVoxelizer const &)            = delete;
+  MeshVoxelizer(MeshVoxelizer &&)                 = delete;
+  MeshVoxelizer &operator=(MeshVoxelizer const &) = delete;
+  MeshVoxelizer &operator=(MeshVoxelizer &&)      = delete;
+
+  // the mesh is in world space, where a chunk spans one unit, the parts outside of the chunks are
+  // clipped, the normal of a voxel is the area weighted normal of its triangles, the chunks
+  // without voxels are left out, the others are in the order of their linear index
+  [[nodiscard]] std::vector<ChunkFragments> voxelize(TriangleMesh const &mesh,
+                                                     uint32_t blockType) const;
+
+private:
+  JobSystem *_jobSystem;
+  uint32_t _voxelResolution;
+  glm::uvec3 _chunksDim;
+  // the edge of a tile in voxels, it divides the voxel resolution
+  uint32_t _tileSize;
+
+  void _parallelFor(size_t begin, size_t end, size_t grainSize,
+                    std::function<void(size_t, size_t)> const &body) const;
+};
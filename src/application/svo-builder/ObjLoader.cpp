@@ -0,0 +1,101 @@
+#include "ObjLoader.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace ObjLoader {
+namespace {
+bool _isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+char const *_skipSpaces(char const *c) {
+  while (_isSpace(*c)) {
+    c++;
+  }
+  return c;
+}
+
+// the obj indices start at 1, the negative ones count back from the last position, returns false
+// for the index 0 and the indices out of range
+bool _resolveIndex(uint32_t &oIndex, long index, size_t positionCount) {
+  long const resolved = index < 0 ? static_cast<long>(positionCount) + index : index - 1;
+  if (index == 0 || resolved < 0 || resolved >= static_cast<long>(positionCount)) {
+    return false;
+  }
+  oIndex = static_cast<uint32_t>(resolved);
+  return true;
+}
+
+// f v1 v2 v3 ..., where a vertex is v, v/vt, v/vt/vn or v//vn
+void _parseFace(TriangleMesh &oMesh, std::vector<uint32_t> &faceIndices, char const *c) {
+  faceIndices.clear();
+  while (true) {
+    c = _skipSpaces(c);
+    // strtol would skip the line break
+    if (*c == '\n') {
+      break;
+    }
+    char *end        = nullptr;
+    long const index = std::strtol(c, &end, 10);
+    if (end == c) {
+      break;
+    }
+    uint32_t resolved = 0;
+    if (!_resolveIndex(resolved, index, oMesh.positions.size())) {
+      return;
+    }
+    faceIndices.push_back(resolved);
+
+    // the texture coordinates and the normals are not used
+    c = end;
+    while (*c != '\0' && *c != '\n' && !_isSpace(*c)) {
+      c++;
+    }
+  }
+
+  for (size_t i = 2; i < faceIndices.size(); i++) {
+    oMesh.indices.push_back(faceIndices[0]);
+    oMesh.indices.push_back(faceIndices[i - 1]);
+    oMesh.indices.push_back(faceIndices[i]);
+  }
+}
+} // namespace
+
+bool fetchMeshFromFile(TriangleMesh &oMesh, std::string const &pathToFile) {
+  std::ifstream file(pathToFile, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  // the whole file is read at once, the scanned meshes have millions of lines
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  std::string const content = buffer.str();
+
+  oMesh = {};
+  std::vector<uint32_t> faceIndices{};
+  char const *c = content.c_str();
+  while (*c != '\0') {
+    c = _skipSpaces(c);
+    if (c[0] == 'v' && _isSpace(c[1])) {
+      char *end = nullptr;
+      glm::vec3 position{};
+      position.x = std::strtof(c + 2, &end);
+      position.y = std::strtof(end, &end);
+      position.z = std::strtof(end, &end);
+      oMesh.positions.push_back(position);
+    } else if (c[0] == 'f' && _isSpace(c[1])) {
+      _parseFace(oMesh, faceIndices, c + 2);
+    }
+
+    // the rest of the line is ignored
+    while (*c != '\0' && *c != '\n') {
+      c++;
+    }
+    if (*c == '\n') {
+      c++;
+    }
+  }
+  return true;
+}
+} // namespace ObjLoader
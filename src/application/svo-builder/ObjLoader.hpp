@@ -0,0 +1,12 @@
+#pragma once
+
+#include "TriangleMesh.hpp"
+
+#include <string>
+
+namespace ObjLoader {
+// only the positions and the faces are read, the faces with more than three vertices are split into
+// fans, the faces that refer to missing positions are skipped, returns false if the file cannot be
+// opened
+bool fetchMeshFromFile(TriangleMesh &oMesh, std::string const &pathToFile);
+}; // namespace ObjLoader
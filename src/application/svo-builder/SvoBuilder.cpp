@@ -1,23 +1,32 @@
 #include "SvoBuilder.hpp"
 
+#include "MeshVoxelizer.hpp"
+#include "ObjLoader.hpp"
 #include "SvoBuilderDataGpu.hpp"
+#include "SvoDagCompressor.hpp"
+#include "VoxelWorldMirror.hpp"
+#include "WideTreeBuilder.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
 #include "file-watcher/ShaderChangeListener.hpp"
+#include "utils/chunk-field/ChunkFieldGenerator.hpp"
 #include "utils/config/RootDir.h"
 #include "utils/io/ShaderFileReader.hpp"
+#include "utils/job-system/JobSystem.hpp"
 #include "utils/logger/Logger.hpp"
 #include "vulkan-wrapper/descriptor-set/DescriptorSetBundle.hpp"
 #include "vulkan-wrapper/memory/Buffer.hpp"
 #include "vulkan-wrapper/memory/Image.hpp"
 #include "vulkan-wrapper/pipeline/ComputePipeline.hpp"
-#include "vulkan-wrapper/utils/SimpleCommands.hpp"
 
 #include "config-container/ConfigContainer.hpp"
 #include "config-container/sub-config/BrushInfo.hpp"
 #include "config-container/sub-config/TerrainInfo.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <fstream>
+#include <tuple>
 
 namespace {
 
@@ -25,30 +34,162 @@ std::string _makeShaderFullPath(std::string const &shaderName) {
   return kPathToResourceFolder + "shaders/svo-builder/" + shaderName;
 }
 
+// a chunk spans one unit, it is only culled if all its corners are outside of the same clip plane,
+// the depth range is [0, 1]
+bool _isChunkInFrustum(glm::vec3 chunkMin, glm::mat4 const &vpMat) {
+  uint32_t outsideOfAll = 0x3F;
+  for (uint32_t corner = 0; corner < 8; corner++) {
+    glm::vec3 const offset{corner & 1U, (corner >> 1) & 1U, (corner >> 2) & 1U};
+    glm::vec4 const clipPos = vpMat * glm::vec4(chunkMin + offset, 1.F);
+
+    uint32_t outside = 0;
+    outside |= clipPos.x < -clipPos.w ? 1U : 0U;
+    outside |= clipPos.x > clipPos.w ? 2U : 0U;
+    outside |= clipPos.y < -clipPos.w ? 4U : 0U;
+    outside |= clipPos.y > clipPos.w ? 8U : 0U;
+    outside |= clipPos.z < 0.F ? 16U : 0U;
+    outside |= clipPos.z > clipPos.w ? 32U : 0U;
+    outsideOfAll &= outside;
+  }
+  return outsideOfAll == 0;
+}
+
+VkCommandBuffer _allocateCommandBuffer(VkDevice device, VkCommandPool commandPool) {
+  VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocInfo.commandPool        = commandPool;
+  allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = 1;
+
+  VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+  vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+  return commandBuffer;
+}
+
+// records one half (the release or the acquire) of a queue family ownership transfer, the command
+// buffer can be submitted again while a previous submission is still pending
+void _recordOwnershipTransfer(VkCommandBuffer commandBuffer, std::vector<Buffer *> const &buffers,
+                              uint32_t srcQueueFamily, uint32_t dstQueueFamily,
+                              VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                              VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+  std::vector<VkBufferMemoryBarrier> barriers{};
+  barriers.reserve(buffers.size());
+  for (Buffer *buffer : buffers) {
+    VkBufferMemoryBarrier barrier = buffer->getMemoryBarrier(srcAccess, dstAccess);
+    barrier.srcQueueFamilyIndex   = srcQueueFamily;
+    barrier.dstQueueFamilyIndex   = dstQueueFamily;
+    barriers.push_back(barrier);
+  }
+
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
+  vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr,
+                       static_cast<uint32_t>(barriers.size()), barriers.data(), 0, nullptr);
+  vkEndCommandBuffer(commandBuffer);
+}
+
+// makes the previous writes of the queue visible to any later access
+void _recordFullBarrier(VkCommandBuffer commandBuffer) {
+  VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+// the small builder buffers are written in the command buffer, so they need no staging
+template <typename T>
+void _recordBufferUpdate(VkCommandBuffer commandBuffer, Buffer *buffer, T const &data) {
+  vkCmdUpdateBuffer(commandBuffer, buffer->getVkBuffer(), 0, sizeof(T), &data);
+}
+
 } // namespace
 
 SvoBuilder::SvoBuilder(VulkanApplicationContext *appContext, Logger *logger,
                        ShaderCompiler *shaderCompiler, ShaderChangeListener *shaderChangeListener,
-                       ConfigContainer *configContainer)
+                       ConfigContainer *configContainer, JobSystem *jobSystem)
     : _appContext(appContext), _logger(logger), _shaderCompiler(shaderCompiler),
-      _shaderChangeListener(shaderChangeListener), _configContainer(configContainer) {}
+      _shaderChangeListener(shaderChangeListener), _configContainer(configContainer),
+      _jobSystem(jobSystem) {}
 
 SvoBuilder::~SvoBuilder() {
-  vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getCommandPool(), 1,
-                       &_octreeCreationCommandBuffer);
+  // the jobs still use the field generator
+  for (auto &job : _cpuChunkJobs) {
+    job.result.wait();
+  }
+  _waitForComputeTimeline(_computeTimelineValue);
+  _freeCompletedCommandBuffers();
+
+  std::vector<VkCommandBuffer> const computeCommandBuffers{
+      _octreeCreationCommandBuffer, _computeAcquireCommandBuffer, _computeReleaseCommandBuffer};
+  vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getComputeCommandPool(),
+                       static_cast<uint32_t>(computeCommandBuffers.size()),
+                       computeCommandBuffers.data());
+
+  std::vector<VkCommandBuffer> const graphicsCommandBuffers{_graphicsReleaseCommandBuffer,
+                                                            _graphicsAcquireCommandBuffer};
+  vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getCommandPool(),
+                       static_cast<uint32_t>(graphicsCommandBuffers.size()),
+                       graphicsCommandBuffers.data());
+
+  vkDestroySemaphore(_appContext->getDevice(), _timelineSemaphore, nullptr);
+  vkDestroySemaphore(_appContext->getDevice(), _computeTimelineSemaphore, nullptr);
 }
 
 glm::uvec3 SvoBuilder::getChunksDim() const { return _configContainer->terrainInfo->chunksDim; }
 
+// the 64-tree is not reduced, so it takes precedence over the dag compression
+bool SvoBuilder::isDagCompressed() const {
+  return _configContainer->terrainInfo->dagCompression && !isWideTree();
+}
+
+bool SvoBuilder::isWideTree() const { return _configContainer->terrainInfo->wideTree; }
+
+// both the dag and the 64-tree are built from the leaf words, which must carry the properties
+bool SvoBuilder::hasSeparateLeafAttributes() const {
+  return _configContainer->terrainInfo->separateLeafAttributes && !isDagCompressed() &&
+         !isWideTree();
+}
+
 void SvoBuilder::init() {
   _voxelLevelCount = static_cast<uint32_t>(std::log2(_configContainer->terrainInfo->chunkVoxelDim));
 
+  if (isWideTree()) {
+    if (_voxelLevelCount % 2 != 0) {
+      _logger->error("the 64-tree requires chunkVoxelDim to be a power of 4, got {}",
+                     _configContainer->terrainInfo->chunkVoxelDim);
+      exit(0);
+    }
+    if (_configContainer->terrainInfo->dagCompression) {
+      _logger->warn("dag compression is ignored when the 64-tree is used");
+    }
+  }
+  if (_configContainer->terrainInfo->separateLeafAttributes && !hasSeparateLeafAttributes()) {
+    _logger->warn("separate leaf attributes are ignored when the dag or the 64-tree is used");
+  }
+
   size_t constexpr kMb    = 1024 * 1024;
   size_t constexpr kGb    = 1024 * kMb;
   size_t octreeBufferSize = 2 * kGb;
 
   _chunkBufferMemoryAllocator = std::make_unique<CustomMemoryAllocator>(_logger, octreeBufferSize);
 
+  _dagCompressor = std::make_unique<SvoDagCompressor>(_chunkBufferMemoryAllocator.get());
+
+  if (_configContainer->terrainInfo->cpuWorldMirror) {
+    _voxelWorldMirror = std::make_unique<VoxelWorldMirror>(
+        _configContainer->terrainInfo->chunkVoxelDim, getChunksDim(), hasSeparateLeafAttributes());
+  }
+
+  // a job builds a whole chunk, so the field of a chunk is not split over the job system
+  if (_configContainer->terrainInfo->cpuChunkGeneration) {
+    _chunkFieldGenerator = std::make_unique<ChunkFieldGenerator>(
+        nullptr, _configContainer->terrainInfo->chunkVoxelDim, getChunksDim());
+    _logger->info("chunks are generated on the cpu, simd path: {}",
+                  ChunkFieldGenerator::getSimdPathName(_chunkFieldGenerator->getSimdPath()));
+  }
+  _voxelizeMesh();
+
   // images
   _createImages();
 
@@ -60,82 +201,313 @@ void SvoBuilder::init() {
   _createDescriptorSetBundle();
   _createPipelines();
   _recordCommandBuffers();
+
+  // queue handover
+  _createTimelineSemaphores();
+  _recordOwnershipTransferCommandBuffers();
+
+  _queueAllChunks();
+}
+
+// all the chunks are built by buildSceneStep
+void SvoBuilder::_queueAllChunks() {
+  glm::uvec3 const &chunksDim = getChunksDim();
+  _pendingChunks.clear();
+  _pendingChunks.reserve(static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z);
+  for (uint32_t z = 0; z < chunksDim.z; z++) {
+    for (uint32_t y = 0; y < chunksDim.y; y++) {
+      for (uint32_t x = 0; x < chunksDim.x; x++) {
+        _pendingChunks.push_back({x, y, z});
+      }
+    }
+  }
+
+  _discardCpuChunkJobs();
+
+  _builtChunkCount       = 0;
+  _minChunkBuildTimeMs   = std::numeric_limits<uint32_t>::max();
+  _maxChunkBuildTimeMs   = 0;
+  _totalChunkBuildTimeMs = 0;
+}
+
+// the running jobs cannot be cancelled, their results are dropped when they are collected
+void SvoBuilder::_discardCpuChunkJobs() {
+  for (auto &job : _cpuChunkJobs) {
+    job.discarded = true;
+  }
 }
 
 void SvoBuilder::onPipelineRebuilt() {
+  // the last appends may still be pending
+  _waitForComputeTimeline(_computeTimelineValue);
+  _freeCompletedCommandBuffers();
+  _gpuChunkBuild.reset();
+
   _recordCommandBuffers();
 
   _chunkBufferMemoryAllocator->freeAll();
   _chunkIndexToBufferAllocResult.clear();
+  _dagCompressor->reset();
+  if (_voxelWorldMirror != nullptr) {
+    _voxelWorldMirror->clear();
+  }
 
   _chunkIndexToFieldImagesMap.clear();
 
   _initBufferData();
 
-  buildScene();
+  // the scene is built again progressively from the render loop
+  _queueAllChunks();
 }
 
-// call me every time before building a new chunk
-void SvoBuilder::_resetBufferDataForNewChunkGeneration(ChunkIndex chunkIndex) {
+// call me every time before building a new chunk, the resets are recorded ahead of the build, so
+// they are ordered with it on the queue
+void SvoBuilder::_resetBufferDataForNewChunkGeneration(VkCommandBuffer commandBuffer) {
   uint32_t atomicCounterInitData = 1;
-  _counterBuffer->fillData(&atomicCounterInitData);
+  _recordBufferUpdate(commandBuffer, _counterBuffer.get(), atomicCounterInitData);
 
   G_OctreeBuildInfo buildInfo{};
   buildInfo.allocBegin = 0;
   buildInfo.allocNum   = 8;
-  _octreeBuildInfoBuffer->fillData(&buildInfo);
+  _recordBufferUpdate(commandBuffer, _octreeBuildInfoBuffer.get(), buildInfo);
 
   G_IndirectDispatchInfo indirectDispatchInfo{};
   indirectDispatchInfo.dispatchX = 1;
   indirectDispatchInfo.dispatchY = 1;
   indirectDispatchInfo.dispatchZ = 1;
-  _indirectAllocNumBuffer->fillData(&indirectDispatchInfo);
-  _indirectFragLengthBuffer->fillData(&indirectDispatchInfo);
+  _recordBufferUpdate(commandBuffer, _indirectAllocNumBuffer.get(), indirectDispatchInfo);
+  _recordBufferUpdate(commandBuffer, _indirectFragLengthBuffer.get(), indirectDispatchInfo);
 
   G_FragmentListInfo fragmentListInfo{};
   fragmentListInfo.voxelResolution    = _configContainer->terrainInfo->chunkVoxelDim;
   fragmentListInfo.voxelFragmentCount = 0;
-  _fragmentListInfoBuffer->fillData(&fragmentListInfo);
-
-  G_ChunksInfo chunksInfo{};
-  chunksInfo.chunksDim             = getChunksDim();
-  chunksInfo.currentlyWritingChunk = {chunkIndex.x, chunkIndex.y, chunkIndex.z};
-  _chunksInfoBuffer->fillData(&chunksInfo);
+  _recordBufferUpdate(commandBuffer, _fragmentListInfoBuffer.get(), fragmentListInfo);
 
   // the first 8 are not calculated, so pre-allocate them
   uint32_t octreeBufferSize = 8;
-  _octreeBufferLengthBuffer->fillData(&octreeBufferSize);
-}
-
-void SvoBuilder::buildScene() {
-  uint32_t zero = 0;
-  _octreeBufferWriteOffsetBuffer->fillData(&zero);
-
-  uint32_t minTimeMs = std::numeric_limits<uint32_t>::max();
-  uint32_t maxTimeMs = 0;
-  uint32_t avgTimeMs = 0;
-  for (uint32_t z = 0; z < _configContainer->terrainInfo->chunksDim.z; z++) {
-    for (uint32_t y = 0; y < _configContainer->terrainInfo->chunksDim.y; y++) {
-      for (uint32_t x = 0; x < _configContainer->terrainInfo->chunksDim.x; x++) {
-        ChunkIndex chunkIndex{x, y, z};
-
-        auto start = std::chrono::steady_clock::now();
-        _buildChunkFromNoise(chunkIndex);
-        auto end      = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        minTimeMs     = std::min(minTimeMs, static_cast<uint32_t>(duration));
-        maxTimeMs     = std::max(maxTimeMs, static_cast<uint32_t>(duration));
-        avgTimeMs += static_cast<uint32_t>(duration);
+  _recordBufferUpdate(commandBuffer, _octreeBufferLengthBuffer.get(), octreeBufferSize);
+
+  _recordFullBarrier(commandBuffer);
+}
+
+void SvoBuilder::buildSceneStep(glm::vec3 cameraPosition, glm::mat4 const &vpMat) {
+  if (isSceneBuilt()) {
+    return;
+  }
+
+  _sortPendingChunks(cameraPosition, vpMat);
+  if (_configContainer->terrainInfo->cpuChunkGeneration) {
+    _buildSceneStepOnCpu();
+  } else {
+    _buildSceneStepOnGpu();
+  }
+
+  if (isSceneBuilt()) {
+    _logSceneBuildStats();
+  }
+}
+
+// a chunk is built on the gpu while the frames are rendered, the step only waits for it within the
+// budget, the next chunk is started right after, so the compute queue is kept busy between steps
+void SvoBuilder::_buildSceneStepOnGpu() {
+  auto const stepEnd =
+      std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::duration<float, std::milli>(_configContainer->terrainInfo->buildBudgetMs));
+
+  while (true) {
+    if (_gpuChunkBuild.has_value()) {
+      auto const remainingNs = (stepEnd - std::chrono::steady_clock::now()).count();
+      auto const timeoutNs   = static_cast<uint64_t>(std::max<int64_t>(remainingNs, 0));
+      if (!_waitForComputeTimeline(_gpuChunkBuild->timelineValue, timeoutNs)) {
+        break;
       }
+      _finishGpuChunkBuild();
+    }
+    if (_pendingChunks.empty()) {
+      break;
+    }
+
+    ChunkIndex const chunkIndex = _pendingChunks.back();
+    _pendingChunks.pop_back();
+    _startChunkBuildFromNoise(chunkIndex);
+
+    if (std::chrono::steady_clock::now() >= stepEnd) {
+      break;
     }
   }
+}
 
-  avgTimeMs /= _configContainer->terrainInfo->chunksDim.x *
-               _configContainer->terrainInfo->chunksDim.y *
-               _configContainer->terrainInfo->chunksDim.z;
+// the workers are kept busy with the most important chunks, the render loop only uploads the
+// finished ones within the budget, so a step never waits for a job
+void SvoBuilder::_buildSceneStepOnCpu() {
+  size_t const maxJobCount = _jobSystem->getWorkerCount() + 1;
+  while (_cpuChunkJobs.size() < maxJobCount && !_pendingChunks.empty()) {
+    ChunkIndex const chunkIndex = _pendingChunks.back();
+    _pendingChunks.pop_back();
+    _cpuChunkJobs.push_back(
+        {chunkIndex,
+         _jobSystem->async([this, chunkIndex]() { return _buildChunkOctreeOnCpu(chunkIndex); }),
+         false});
+  }
 
-  _logger->info("min time: {} ms, max time: {} ms, avg time: {} ms", minTimeMs, maxTimeMs,
-                avgTimeMs);
+  auto const stepStart   = std::chrono::steady_clock::now();
+  bool sharedBuffersHeld = false;
+  for (size_t i = 0; i < _cpuChunkJobs.size();) {
+    CpuChunkJob &job = _cpuChunkJobs[i];
+    if (job.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      i++;
+      continue;
+    }
+
+    CpuChunkResult result       = job.result.get();
+    ChunkIndex const chunkIndex = job.chunkIndex;
+    bool const discarded        = job.discarded;
+    if (i + 1 < _cpuChunkJobs.size()) {
+      _cpuChunkJobs[i] = std::move(_cpuChunkJobs.back());
+    }
+    _cpuChunkJobs.pop_back();
+    if (discarded) {
+      continue;
+    }
+
+    // an empty chunk keeps the index 0 it was given when the buffers were initialized
+    if (!result.octree.nodes.empty()) {
+      if (!sharedBuffersHeld) {
+        _acquireSharedBuffers();
+        sharedBuffersHeld = true;
+      }
+      _appendChunkOctree(chunkIndex, std::move(result.octree));
+    }
+    _recordChunkBuilt(chunkIndex, result.buildTimeMs);
+
+    auto const stepTimeMs =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - stepStart);
+    if (stepTimeMs.count() >= _configContainer->terrainInfo->buildBudgetMs) {
+      break;
+    }
+  }
+  if (sharedBuffersHeld) {
+    _releaseSharedBuffers();
+  }
+}
+
+// runs on a worker, only touches the field generator and the mesh fragments, which are immutable
+// once created
+SvoBuilder::CpuChunkResult SvoBuilder::_buildChunkOctreeOnCpu(ChunkIndex chunkIndex) const {
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<uint16_t> field{};
+  _chunkFieldGenerator->generate(field, {chunkIndex.x, chunkIndex.y, chunkIndex.z});
+
+  CpuChunkResult result{};
+  result.octree = _buildChunkOctreeFromField(chunkIndex, field);
+
+  auto end           = std::chrono::steady_clock::now();
+  result.buildTimeMs = static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+  return result;
+}
+
+// the mesh is a layer above the field, it is merged again whenever the chunk is built from its
+// field, so the edits of the field never remove it
+ChunkOctree SvoBuilder::_buildChunkOctreeFromField(ChunkIndex chunkIndex,
+                                                   std::vector<uint16_t> const &field) const {
+  std::vector<G_FragmentListEntry> fragments =
+      extractChunkFragments(field.data(), _configContainer->terrainInfo->chunkVoxelDim);
+  // the mesh goes last, so it replaces the terrain where they overlap
+  if (!_meshFragments.empty()) {
+    auto const &meshFragments = _meshFragments[_getChunkLinearIndex(chunkIndex)];
+    fragments.insert(fragments.end(), meshFragments.begin(), meshFragments.end());
+  }
+  return buildChunkOctreeFromFragments(fragments, _configContainer->terrainInfo->chunkVoxelDim,
+                                       hasSeparateLeafAttributes());
+}
+
+// the mesh is voxelized once, the chunks take their fragments when they are built
+void SvoBuilder::_voxelizeMesh() {
+  TerrainInfo const *terrainInfo = _configContainer->terrainInfo.get();
+  if (terrainInfo->meshPath.empty()) {
+    return;
+  }
+  if (!terrainInfo->cpuChunkGeneration) {
+    _logger->warn("the mesh is ignored, it is only merged into the chunks built on the cpu");
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::string const pathToMesh = kPathToResourceFolder + terrainInfo->meshPath;
+  TriangleMesh mesh{};
+  if (!ObjLoader::fetchMeshFromFile(mesh, pathToMesh)) {
+    _logger->error("failed to open the mesh at {}", pathToMesh);
+    exit(0);
+  }
+  fitMeshIntoBox(mesh, terrainInfo->meshBoxMin, terrainInfo->meshBoxMax);
+
+  MeshVoxelizer const voxelizer{_jobSystem, terrainInfo->chunkVoxelDim, getChunksDim()};
+  glm::uvec3 const &chunksDim = getChunksDim();
+  _meshFragments.assign(static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z, {});
+  size_t voxelCount = 0;
+  for (ChunkFragments &chunk : voxelizer.voxelize(mesh, terrainInfo->meshBlockType)) {
+    voxelCount += chunk.fragments.size();
+    ChunkIndex const chunkIndex{chunk.chunkIndex.x, chunk.chunkIndex.y, chunk.chunkIndex.z};
+    _meshFragments[_getChunkLinearIndex(chunkIndex)] = std::move(chunk.fragments);
+  }
+
+  auto end      = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+  _logger->info("voxelized {} triangles of {} into {} voxels in {} ms", mesh.getTriangleCount(),
+                terrainInfo->meshPath, voxelCount, duration);
+}
+
+// the chunks in view go last, then the nearest ones, so they are taken from the back first
+void SvoBuilder::_sortPendingChunks(glm::vec3 cameraPosition, glm::mat4 const &vpMat) {
+  struct PendingChunk {
+    bool outOfView;
+    float distance;
+    ChunkIndex chunkIndex;
+  };
+  std::vector<PendingChunk> queue{};
+  queue.reserve(_pendingChunks.size());
+  for (ChunkIndex const &chunkIndex : _pendingChunks) {
+    glm::vec3 const chunkMin(chunkIndex.x, chunkIndex.y, chunkIndex.z);
+    queue.push_back({!_isChunkInFrustum(chunkMin, vpMat),
+                     glm::distance(chunkMin + glm::vec3{0.5F}, cameraPosition), chunkIndex});
+  }
+  std::sort(queue.begin(), queue.end(), [](PendingChunk const &a, PendingChunk const &b) {
+    return std::tie(a.outOfView, a.distance) > std::tie(b.outOfView, b.distance);
+  });
+
+  for (size_t i = 0; i < queue.size(); i++) {
+    _pendingChunks[i] = queue[i].chunkIndex;
+  }
+}
+
+void SvoBuilder::_recordChunkBuilt(ChunkIndex chunkIndex, uint32_t buildTimeMs) {
+  _minChunkBuildTimeMs = std::min(_minChunkBuildTimeMs, buildTimeMs);
+  _maxChunkBuildTimeMs = std::max(_maxChunkBuildTimeMs, buildTimeMs);
+  _totalChunkBuildTimeMs += buildTimeMs;
+  _builtChunkCount++;
+
+  // the tracer caches the geometry, so the new chunk is reported like an edit
+  glm::vec3 const chunkMin(chunkIndex.x, chunkIndex.y, chunkIndex.z);
+  _editedChunkBounds.push_back({chunkMin, chunkMin + glm::vec3{1.F}});
+}
+
+void SvoBuilder::_logSceneBuildStats() {
+  _logger->info("min time: {} ms, max time: {} ms, avg time: {} ms", _minChunkBuildTimeMs,
+                _maxChunkBuildTimeMs, _totalChunkBuildTimeMs / std::max(_builtChunkCount, 1U));
+
+  if (isDagCompressed()) {
+    size_t const sourceNodeCount = _dagCompressor->getSourceNodeCount();
+    size_t const storedNodeCount = _dagCompressor->getStoredNodeCount();
+    _logger->info("dag compression: {:.2f} mb -> {:.2f} mb ({:.2f}x)",
+                  static_cast<float>(sourceNodeCount * sizeof(uint32_t)) / (1024 * 1024),
+                  static_cast<float>(storedNodeCount * sizeof(uint32_t)) / (1024 * 1024),
+                  static_cast<float>(sourceNodeCount) /
+                      static_cast<float>(std::max<size_t>(storedNodeCount, 1)));
+  }
 
   _chunkBufferMemoryAllocator->printStats();
 }
@@ -189,130 +561,512 @@ void SvoBuilder::handleCursorHit(glm::vec3 hitPos, bool deletionMode) {
   chunkEditingInfo.operation = deletionMode ? 0U : 1U; // 0 for deletion, 1 for addition
   _chunkEditingInfoBuffer->fillData(&chunkEditingInfo);
 
+  // the edits reuse the builder buffers
+  _dropGpuChunkBuild();
+
+  // the edited octrees are read back before the shared buffers are acquired, so the waits for
+  // the edits are not queued behind the frames in flight
   const auto &chunks = _getEditingChunks(hitPos, _configContainer->brushInfo->size);
-  for (auto const &chunk : chunks) {
-    _editExistingChunk(chunk);
+  std::vector<ChunkOctree> octrees(chunks.size());
+  for (size_t i = 0; i < chunks.size(); i++) {
+    ChunkIndex const &chunk = chunks[i];
+    // the chunk is built by the edit, so the scene build must not overwrite it later
+    _pendingChunks.erase(std::remove(_pendingChunks.begin(), _pendingChunks.end(), chunk),
+                         _pendingChunks.end());
+    for (auto &job : _cpuChunkJobs) {
+      job.discarded = job.discarded || job.chunkIndex == chunk;
+    }
+
+    _editExistingChunk(octrees[i], chunk);
+  }
+
+  _acquireSharedBuffers();
+  for (size_t i = 0; i < chunks.size(); i++) {
+    ChunkIndex const &chunk = chunks[i];
+    if (octrees[i].nodes.empty()) {
+      _clearChunk(chunk);
+    } else {
+      _appendChunkOctree(chunk, std::move(octrees[i]));
+    }
+
+    glm::vec3 const chunkMin(chunk.x, chunk.y, chunk.z);
+    _editedChunkBounds.push_back({chunkMin, chunkMin + glm::vec3{1.F}});
+  }
+  _releaseSharedBuffers();
+}
+
+std::vector<SvoBuilder::ChunkBounds> SvoBuilder::takeEditedChunkBounds() {
+  std::vector<ChunkBounds> editedChunkBounds{};
+  editedChunkBounds.swap(_editedChunkBounds);
+  return editedChunkBounds;
+}
+
+void SvoBuilder::_createTimelineSemaphores() {
+  VkSemaphoreTypeCreateInfo semaphoreTypeInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+  semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  semaphoreTypeInfo.initialValue  = 0;
+
+  VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  semaphoreInfo.pNext = &semaphoreTypeInfo;
+  vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr, &_timelineSemaphore);
+  vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr,
+                    &_computeTimelineSemaphore);
+  _timelineValue        = 0;
+  _computeTimelineValue = 0;
+}
+
+// the buffers that are read by the tracer are owned by the graphics queue family outside the
+// builder's batches of work, the transfers are plain barriers if both families are the same
+void SvoBuilder::_recordOwnershipTransferCommandBuffers() {
+  auto const &device            = _appContext->getDevice();
+  uint32_t const graphicsFamily = _appContext->getGraphicsQueueIndex();
+  uint32_t const computeFamily  = _appContext->getComputeQueueIndex();
+
+  std::vector<Buffer *> const sharedBuffers{
+      _appendedOctreeBuffer.get(), _appendedLeafAttributeBuffer.get(), _chunkIndicesBuffer.get(),
+      _chunkBrickMaskBuffer.get(), _chunkGroupOccupancyBuffer.get()};
+
+  VkPipelineStageFlags constexpr kShaderAndTransfer =
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+  // the semaphore signal makes the previous writes available, so the releases after the reads of
+  // the tracer need no source access
+  _graphicsReleaseCommandBuffer = _allocateCommandBuffer(device, _appContext->getCommandPool());
+  _recordOwnershipTransfer(_graphicsReleaseCommandBuffer, sharedBuffers, graphicsFamily,
+                           computeFamily, kShaderAndTransfer, 0,
+                           VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+
+  _computeAcquireCommandBuffer =
+      _allocateCommandBuffer(device, _appContext->getComputeCommandPool());
+  _recordOwnershipTransfer(_computeAcquireCommandBuffer, sharedBuffers, graphicsFamily,
+                           computeFamily, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, kShaderAndTransfer,
+                           VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                               VK_ACCESS_TRANSFER_WRITE_BIT);
+
+  _computeReleaseCommandBuffer =
+      _allocateCommandBuffer(device, _appContext->getComputeCommandPool());
+  _recordOwnershipTransfer(_computeReleaseCommandBuffer, sharedBuffers, computeFamily,
+                           graphicsFamily, kShaderAndTransfer,
+                           VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+
+  _graphicsAcquireCommandBuffer = _allocateCommandBuffer(device, _appContext->getCommandPool());
+  _recordOwnershipTransfer(_graphicsAcquireCommandBuffer, sharedBuffers, computeFamily,
+                           graphicsFamily, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                           kShaderAndTransfer,
+                           VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+}
+
+// a wait or signal value of 0 means no wait or no signal
+void SvoBuilder::_submitWithTimeline(VkQueue queue, VkCommandBuffer commandBuffer,
+                                     uint64_t waitValue, uint64_t signalValue) {
+  VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.pNext = &timelineInfo;
+
+  VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+  if (waitValue != 0) {
+    timelineInfo.waitSemaphoreValueCount = 1;
+    timelineInfo.pWaitSemaphoreValues    = &waitValue;
+    submitInfo.waitSemaphoreCount        = 1;
+    submitInfo.pWaitSemaphores           = &_timelineSemaphore;
+    submitInfo.pWaitDstStageMask         = &waitStage;
+  }
+  if (signalValue != 0) {
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues    = &signalValue;
+    submitInfo.signalSemaphoreCount        = 1;
+    submitInfo.pSignalSemaphores           = &_timelineSemaphore;
   }
+
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers    = &commandBuffer;
+  vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+}
+
+// the release is queued behind the frames that are still reading the shared buffers, the compute
+// queue waits for it on the gpu, so the graphics queue is never idled
+void SvoBuilder::_acquireSharedBuffers() {
+  uint64_t const releasedValue = ++_timelineValue;
+  _submitWithTimeline(_appContext->getGraphicsQueue(), _graphicsReleaseCommandBuffer, 0,
+                      releasedValue);
+  _submitWithTimeline(_appContext->getComputeQueue(), _computeAcquireCommandBuffer,
+                      releasedValue, 0);
 }
 
-void SvoBuilder::_editExistingChunk(ChunkIndex chunkIndex) {
-  _resetBufferDataForNewChunkGeneration(chunkIndex);
+// the frames submitted after this are queued behind the acquire, which waits for the last writes
+// of the builder on the gpu
+void SvoBuilder::_releaseSharedBuffers() {
+  uint64_t const releasedValue = ++_timelineValue;
+  _submitWithTimeline(_appContext->getComputeQueue(), _computeReleaseCommandBuffer, 0,
+                      releasedValue);
+  _submitWithTimeline(_appContext->getGraphicsQueue(), _graphicsAcquireCommandBuffer,
+                      releasedValue, 0);
+}
 
-  VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+VkCommandBuffer SvoBuilder::_beginComputeCommands() {
+  VkCommandBuffer commandBuffer =
+      _allocateCommandBuffer(_appContext->getDevice(), _appContext->getComputeCommandPool());
+
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
+  _recordFullBarrier(commandBuffer);
+  return commandBuffer;
+}
+
+// the command buffer is freed once the timeline value is reached
+uint64_t SvoBuilder::_submitComputeCommands(VkCommandBuffer commandBuffer,
+                                            bool withOctreeCreation) {
+  vkEndCommandBuffer(commandBuffer);
+
+  std::vector<VkCommandBuffer> commandBuffers{commandBuffer};
+  if (withOctreeCreation) {
+    commandBuffers.push_back(_octreeCreationCommandBuffer);
+  }
+
+  uint64_t const signalValue = ++_computeTimelineValue;
+  VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  timelineInfo.signalSemaphoreValueCount = 1;
+  timelineInfo.pSignalSemaphoreValues    = &signalValue;
+
+  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.pNext                = &timelineInfo;
+  submitInfo.commandBufferCount   = static_cast<uint32_t>(commandBuffers.size());
+  submitInfo.pCommandBuffers      = commandBuffers.data();
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores    = &_computeTimelineSemaphore;
+  vkQueueSubmit(_appContext->getComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+
+  _pendingCommandBuffers.push_back({commandBuffer, signalValue});
+  _freeCompletedCommandBuffers();
+  return signalValue;
+}
+
+bool SvoBuilder::_waitForComputeTimeline(uint64_t value, uint64_t timeoutNs) {
+  VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores    = &_computeTimelineSemaphore;
+  waitInfo.pValues        = &value;
+  return vkWaitSemaphores(_appContext->getDevice(), &waitInfo, timeoutNs) == VK_SUCCESS;
+}
+
+void SvoBuilder::_freeCompletedCommandBuffers() {
+  uint64_t completedValue = 0;
+  vkGetSemaphoreCounterValue(_appContext->getDevice(), _computeTimelineSemaphore,
+                             &completedValue);
+  while (!_pendingCommandBuffers.empty() &&
+         _pendingCommandBuffers.front().timelineValue <= completedValue) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getComputeCommandPool(), 1,
+                         &_pendingCommandBuffers.front().commandBuffer);
+    _pendingCommandBuffers.pop_front();
+  }
+}
+
+// the steps of the edit are recorded into one submission, only that submission is waited for,
+// since the edited octree is read back right away, the octree is left empty if no voxel remains
+// with Terrain.cpuChunkGeneration, only the field is edited on the gpu, it is read back and the
+// chunk is built from it on the cpu, like the chunks of the scene build, so the mesh is kept
+void SvoBuilder::_editExistingChunk(ChunkOctree &oOctree, ChunkIndex chunkIndex) {
+  bool const buildOnCpu        = _configContainer->terrainInfo->cpuChunkGeneration;
+  uint32_t const chunkVoxelDim = _configContainer->terrainInfo->chunkVoxelDim;
+
+  // the saved field is created before the recording, it is left in the undefined layout, since
+  // the copy into it discards the content anyway
+  bool const hasSavedField =
+      _chunkIndexToFieldImagesMap.find(chunkIndex) != _chunkIndexToFieldImagesMap.end();
+  if (!hasSavedField) {
+    _logger->info("creating new image for chunk");
+    _chunkIndexToFieldImagesMap[chunkIndex] = std::make_unique<Image>(
+        _appContext, ImageDimensions{chunkVoxelDim + 1, chunkVoxelDim + 1, chunkVoxelDim + 1},
+        VK_FORMAT_R16_UINT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED);
+  }
+  Image *savedFieldImage = _chunkIndexToFieldImagesMap[chunkIndex].get();
+
+  VkCommandBuffer cmdBuffer = _beginComputeCommands();
+  _resetBufferDataForNewChunkGeneration(cmdBuffer);
 
   // if the chunk does not have save, create it to buffer
-  if (_chunkIndexToFieldImagesMap.find(chunkIndex) == _chunkIndexToFieldImagesMap.end()) {
+  if (!hasSavedField) {
     _logger->info("constructing new field image");
-    cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-    _chunkFieldConstructionPipeline->recordCommand(
-        cmdBuffer, 0, _configContainer->terrainInfo->chunkVoxelDim + 1,
-        _configContainer->terrainInfo->chunkVoxelDim + 1,
-        _configContainer->terrainInfo->chunkVoxelDim + 1);
-    endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                          _appContext->getGraphicsQueue(), cmdBuffer);
+    _pushChunkConstants(cmdBuffer, _chunkFieldConstructionPipeline.get(), chunkIndex);
+    _chunkFieldConstructionPipeline->recordCommand(cmdBuffer, 0, chunkVoxelDim + 1,
+                                                   chunkVoxelDim + 1, chunkVoxelDim + 1);
   }
   // otherwise, load from save to buffer, caching this doesn't offer performance boost
   else {
-    cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-    ImageForwardingPair f{_chunkIndexToFieldImagesMap[chunkIndex].get(),
-                          _chunkFieldImage.get(),
-                          VK_IMAGE_LAYOUT_GENERAL,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_GENERAL,
-                          VK_IMAGE_LAYOUT_GENERAL};
-    f.forwardCopy(cmdBuffer);
-    endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                          _appContext->getGraphicsQueue(), cmdBuffer);
+    ImageForwardingPair loadPair{savedFieldImage,         _chunkFieldImage.get(),
+                                 VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_UNDEFINED,
+                                 VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL};
+    loadPair.forwardCopy(cmdBuffer);
   }
+  _recordFullBarrier(cmdBuffer);
 
   // edit field image
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkFieldModificationPipeline->recordCommand(cmdBuffer, 0,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
-
-  // ensure the image has been created before copying
-  auto const &it = _chunkIndexToFieldImagesMap.find(chunkIndex);
-  if (it == _chunkIndexToFieldImagesMap.end()) {
-    _logger->info("creating new image for chunk");
-    _chunkIndexToFieldImagesMap[chunkIndex] =
-        std::make_unique<Image>(_appContext,
-                                ImageDimensions{_configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                _configContainer->terrainInfo->chunkVoxelDim + 1},
-                                VK_FORMAT_R16_UINT,
-                                VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-                                    VK_IMAGE_USAGE_TRANSFER_DST_BIT);
-  }
+  _pushChunkConstants(cmdBuffer, _chunkFieldModificationPipeline.get(), chunkIndex);
+  _chunkFieldModificationPipeline->recordCommand(cmdBuffer, 0, chunkVoxelDim + 1,
+                                                 chunkVoxelDim + 1, chunkVoxelDim + 1);
+  _recordFullBarrier(cmdBuffer);
 
   // save from buffer to image
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  ImageForwardingPair f{_chunkFieldImage.get(),  _chunkIndexToFieldImagesMap[chunkIndex].get(),
-                        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_UNDEFINED,
-                        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL};
-  f.forwardCopy(cmdBuffer);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
-
-  // remove svo buffer allocation rec, so new allocations can be made to this memory region
-  auto const &it2 = _chunkIndexToBufferAllocResult.find(chunkIndex);
-  if (it2 != _chunkIndexToBufferAllocResult.end()) {
-    _chunkBufferMemoryAllocator->deallocate(it2->second);
-    _chunkIndexToBufferAllocResult.erase(it2);
+  ImageForwardingPair savePair{_chunkFieldImage.get(),  savedFieldImage,
+                               VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_UNDEFINED,
+                               VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL};
+  savePair.forwardCopy(cmdBuffer);
+
+  if (buildOnCpu) {
+    uint32_t const fieldDim = chunkVoxelDim + 1;
+    std::vector<uint16_t> field(static_cast<size_t>(fieldDim) * fieldDim * fieldDim);
+    Buffer readbackBuffer(_appContext, field.size() * sizeof(uint16_t),
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryStyle::kHostVisible,
+                          OwnerQueue::kCompute);
+    _recordChunkFieldReadback(cmdBuffer, readbackBuffer.getVkBuffer());
+    _waitForComputeTimeline(_submitComputeCommands(cmdBuffer));
+    readbackBuffer.fetchData(field.data(), field.size() * sizeof(uint16_t));
+
+    oOctree = _buildChunkOctreeFromField(chunkIndex, field);
+    return;
   }
 
   // construct voxels into fragmentlist buffer
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkVoxelCreationPipeline->recordCommand(
-      cmdBuffer, 0, _configContainer->terrainInfo->chunkVoxelDim,
-      _configContainer->terrainInfo->chunkVoxelDim, _configContainer->terrainInfo->chunkVoxelDim);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
-
-  // check if the fragment list is empty, if so, we can skip the octree creation
+  _chunkVoxelCreationPipeline->recordCommand(cmdBuffer, 0, chunkVoxelDim, chunkVoxelDim,
+                                             chunkVoxelDim);
+  _recordFullBarrier(cmdBuffer);
+
+  // an empty chunk still runs through the octree creation, the result is not read then
+  _waitForComputeTimeline(_submitComputeCommands(cmdBuffer, true));
+
   G_FragmentListInfo fragmentListInfo{};
   _fragmentListInfoBuffer->fetchData(&fragmentListInfo);
   if (fragmentListInfo.voxelFragmentCount == 0) {
-    // alter the pointer stored in the chunk indices buffer
-    uint32_t zero = 0;
-    _octreeBufferWriteOffsetBuffer->fillData(&zero);
-    cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-    _chunkIndicesBufferUpdaterPipeline->recordCommand(cmdBuffer, 0, 1, 1, 1);
-    endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                          _appContext->getGraphicsQueue(), cmdBuffer);
-
     // but maintain the image, because the weight has been altered
     return;
   }
+  _fetchChunkOctree(oOctree, true);
+}
 
-  // octree construction
-  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  // wait until the image is ready
-  submitInfo.waitSemaphoreCount = 0;
-  // signal a semaphore after excecution finished
-  submitInfo.signalSemaphoreCount = 0;
-  // wait for no stage
-  VkPipelineStageFlags waitStages{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
-  submitInfo.pWaitDstStageMask = &waitStages;
+// the field, the voxels and the octree of the chunk are built in one submission, the builder
+// buffers are read back by _finishGpuChunkBuild, so only one build is in flight
+void SvoBuilder::_startChunkBuildFromNoise(ChunkIndex chunkIndex) {
+  auto const startTime         = std::chrono::steady_clock::now();
+  uint32_t const chunkVoxelDim = _configContainer->terrainInfo->chunkVoxelDim;
 
-  std::vector<VkCommandBuffer> commandBuffersToSubmit2{_octreeCreationCommandBuffer};
-  submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffersToSubmit2.size());
-  submitInfo.pCommandBuffers    = commandBuffersToSubmit2.data();
+  VkCommandBuffer cmdBuffer = _beginComputeCommands();
+  _resetBufferDataForNewChunkGeneration(cmdBuffer);
+
+  // construct field image
+  _pushChunkConstants(cmdBuffer, _chunkFieldConstructionPipeline.get(), chunkIndex);
+  _chunkFieldConstructionPipeline->recordCommand(cmdBuffer, 0, chunkVoxelDim + 1,
+                                                 chunkVoxelDim + 1, chunkVoxelDim + 1);
+  _recordFullBarrier(cmdBuffer);
+
+  // construct voxels into fragmentlist buffer
+  _chunkVoxelCreationPipeline->recordCommand(cmdBuffer, 0, chunkVoxelDim, chunkVoxelDim,
+                                             chunkVoxelDim);
+  _recordFullBarrier(cmdBuffer);
+
+  // an empty chunk still runs through the octree creation, the result is not read then
+  _gpuChunkBuild = GpuChunkBuild{chunkIndex, _submitComputeCommands(cmdBuffer, true), startTime};
+}
 
-  vkQueueSubmit(_appContext->getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(_appContext->getGraphicsQueue());
+// the readbacks go before the shared buffers are acquired, since the acquire waits for the frames
+// in flight, and the readbacks would be queued behind it
+void SvoBuilder::_finishGpuChunkBuild() {
+  GpuChunkBuild const build = *_gpuChunkBuild;
+  _gpuChunkBuild.reset();
+
+  if (!_configContainer->terrainInfo->chunkFieldDumpFolder.empty()) {
+    _dumpChunkField(build.chunkIndex);
+  }
+
+  // an empty chunk keeps the index 0 it was given when the buffers were initialized
+  G_FragmentListInfo fragmentListInfo{};
+  _fragmentListInfoBuffer->fetchData(&fragmentListInfo);
+  if (fragmentListInfo.voxelFragmentCount > 0) {
+    ChunkOctree octree{};
+    uint32_t const octreeBufferLength = _fetchChunkOctree(octree, false);
+    _acquireSharedBuffers();
+    _appendChunkOctree(build.chunkIndex, octreeBufferLength, std::move(octree));
+    _releaseSharedBuffers();
+  }
+
+  // from the submission to the readback, so the frames in between are included
+  auto const buildTimeMs =
+      static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now() - build.startTime)
+                                .count());
+  _recordChunkBuilt(build.chunkIndex, buildTimeMs);
+}
 
+// the build in flight shares the builder buffers with the edits, its chunk is built again later
+void SvoBuilder::_dropGpuChunkBuild() {
+  if (_gpuChunkBuild.has_value()) {
+    _pendingChunks.push_back(_gpuChunkBuild->chunkIndex);
+    _gpuChunkBuild.reset();
+  }
+}
+
+// copies the chunk field image into the buffer after the writes of the submission, the buffer is
+// read by the host once the submission has finished
+void SvoBuilder::_recordChunkFieldReadback(VkCommandBuffer commandBuffer, VkBuffer readbackBuffer) {
+  uint32_t const dim = _configContainer->terrainInfo->chunkVoxelDim + 1;
+
+  VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+  barrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
+  barrier.oldLayout           = VK_IMAGE_LAYOUT_GENERAL;
+  barrier.newLayout           = VK_IMAGE_LAYOUT_GENERAL;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image               = _chunkFieldImage->getVkImage();
+  barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+  VkBufferImageCopy region{};
+  region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.imageExtent      = {dim, dim, dim};
+  vkCmdCopyImageToBuffer(commandBuffer, _chunkFieldImage->getVkImage(), VK_IMAGE_LAYOUT_GENERAL,
+                         readbackBuffer, 1, &region);
+
+  VkMemoryBarrier hostReadBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  hostReadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  hostReadBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                       0, 1, &hostReadBarrier, 0, nullptr, 0, nullptr);
+}
+
+void SvoBuilder::_dumpChunkField(ChunkIndex chunkIndex) {
+  uint32_t const dim      = _configContainer->terrainInfo->chunkVoxelDim + 1;
+  VkDeviceSize const size = sizeof(uint16_t) * dim * dim * dim;
+  Buffer readbackBuffer(_appContext, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        MemoryStyle::kHostVisible, OwnerQueue::kCompute);
+
+  VkCommandBuffer cmdBuffer = _beginComputeCommands();
+  _recordChunkFieldReadback(cmdBuffer, readbackBuffer.getVkBuffer());
+  _waitForComputeTimeline(_submitComputeCommands(cmdBuffer));
+
+  std::vector<uint16_t> field(static_cast<size_t>(dim) * dim * dim);
+  readbackBuffer.fetchData(field.data(), size);
+
+  std::string const path = _configContainer->terrainInfo->chunkFieldDumpFolder + "chunkField_" +
+                           std::to_string(chunkIndex.x) + "_" + std::to_string(chunkIndex.y) +
+                           "_" + std::to_string(chunkIndex.z) + ".bin";
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    _logger->error("failed to write the chunk field to {}", path);
+    return;
+  }
+  file.write(reinterpret_cast<char const *>(field.data()), static_cast<std::streamsize>(size));
+  _logger->info("chunk field written to {}", path);
+}
+
+uint32_t SvoBuilder::_getChunkLinearIndex(ChunkIndex chunkIndex) const {
+  auto const &chunksDim = getChunksDim();
+  return chunkIndex.x + chunkIndex.y * chunksDim.x + chunkIndex.z * chunksDim.x * chunksDim.y;
+}
+
+// every 4x4x4 chunks form a chunk group, refer occupancy.glsl
+uint32_t SvoBuilder::_getChunkGroupCount() const {
+  uint32_t constexpr kChunkGroupDim = 4;
+  glm::uvec3 const groupsDim        = (getChunksDim() + kChunkGroupDim - 1U) / kChunkGroupDim;
+  return groupsDim.x * groupsDim.y * groupsDim.z;
+}
+
+uint32_t SvoBuilder::_fetchChunkOctree(ChunkOctree &oOctree, bool withNodes) {
   uint32_t octreeBufferLength = 0;
   _octreeBufferLengthBuffer->fetchData(&octreeBufferLength);
 
+  // the mapped memory is slow to be read randomly, so copy it out first, the plain octree is
+  // copied on the gpu, it is only read back if requested or for the mirror
+  if (withNodes || isDagCompressed() || isWideTree() || _voxelWorldMirror != nullptr) {
+    oOctree.nodes.resize(octreeBufferLength);
+    _chunkOctreeBuffer->fetchData(oOctree.nodes.data(), octreeBufferLength * sizeof(uint32_t));
+    if (hasSeparateLeafAttributes()) {
+      oOctree.leafAttributes.resize(octreeBufferLength);
+      _chunkLeafAttributeBuffer->fetchData(oOctree.leafAttributes.data(),
+                                           octreeBufferLength * sizeof(uint32_t));
+    }
+  }
+  return octreeBufferLength;
+}
+
+// moves the octree in the chunk octree buffer into the appended octree buffer, and points the chunk
+// indices buffer to it, the nodes of the octree are only used if they are fetched
+void SvoBuilder::_appendChunkOctree(ChunkIndex chunkIndex, uint32_t octreeBufferLength,
+                                    ChunkOctree octree) {
+  uint32_t rootNodeIndex = 0;
+  if (isDagCompressed()) {
+    rootNodeIndex = _appendChunkOctreeAsDag(chunkIndex, octree.nodes);
+  } else if (isWideTree()) {
+    rootNodeIndex = _appendChunkOctreeAsWideTree(chunkIndex, octree.nodes);
+  } else {
+    rootNodeIndex = _appendChunkOctreeAsOctree(chunkIndex, octreeBufferLength);
+  }
+  _updateChunkIndex(chunkIndex, rootNodeIndex + 1U);
+
+  if (_voxelWorldMirror != nullptr) {
+    _voxelWorldMirror->setChunk({chunkIndex.x, chunkIndex.y, chunkIndex.z}, std::move(octree));
+  }
+}
+
+// the same as above, for an octree that was read back earlier or built on the cpu, it is staged
+// through the chunk octree buffers when it is appended as is
+void SvoBuilder::_appendChunkOctree(ChunkIndex chunkIndex, ChunkOctree octree) {
+  auto const octreeBufferLength = static_cast<uint32_t>(octree.nodes.size());
+  if (!isDagCompressed() && !isWideTree()) {
+    _fillChunkOctreeBuffer(octree.nodes.data(), octreeBufferLength * sizeof(uint32_t));
+    // the copies that read the attributes are the ones waited for above
+    if (hasSeparateLeafAttributes()) {
+      _chunkLeafAttributeBuffer->fillData(octree.leafAttributes.data(),
+                                          octreeBufferLength * sizeof(uint32_t));
+    }
+  }
+  _appendChunkOctree(chunkIndex, octreeBufferLength, std::move(octree));
+}
+
+// the chunk is left without voxels, it points to no octree
+void SvoBuilder::_clearChunk(ChunkIndex chunkIndex) {
+  // remove svo buffer allocation rec, so new allocations can be made to this memory region
+  auto const &it = _chunkIndexToBufferAllocResult.find(chunkIndex);
+  if (it != _chunkIndexToBufferAllocResult.end()) {
+    _chunkBufferMemoryAllocator->deallocate(it->second);
+    _chunkIndexToBufferAllocResult.erase(it);
+  }
+  if (isDagCompressed()) {
+    _dagCompressor->release(_getChunkLinearIndex(chunkIndex));
+  }
+  if (_voxelWorldMirror != nullptr) {
+    _voxelWorldMirror->setChunk({chunkIndex.x, chunkIndex.y, chunkIndex.z}, {});
+  }
+
+  // alter the pointer stored in the chunk indices buffer
+  _updateChunkIndex(chunkIndex, 0);
+}
+
+// the buffers are host visible, so the copies that still read them are waited for
+void SvoBuilder::_fillChunkOctreeBuffer(void const *data, VkDeviceSize size) {
+  _waitForComputeTimeline(_chunkOctreeBufferReadValue);
+  _chunkOctreeBuffer->fillData(data, size);
+}
+
+// copies the chunk octree buffer as is, returns the node index of the root node group
+uint32_t SvoBuilder::_appendChunkOctreeAsOctree(ChunkIndex chunkIndex,
+                                                uint32_t octreeBufferLength) {
+  // remove allocation
+  auto const &it = _chunkIndexToBufferAllocResult.find(chunkIndex);
+  if (it != _chunkIndexToBufferAllocResult.end()) {
+    _chunkBufferMemoryAllocator->deallocate(it->second);
+    // erasing is omitted here, since we are going to overwrite it anyway
+  }
   _chunkIndexToBufferAllocResult[chunkIndex] =
       _chunkBufferMemoryAllocator->allocate(octreeBufferLength * sizeof(uint32_t));
   uint32_t writeOffsetInBytes = _chunkIndexToBufferAllocResult[chunkIndex].offset();
 
-  // print offset in mb
   _logger->info("memory offset: {} mb", static_cast<float>(writeOffsetInBytes) / (1024 * 1024));
 
   VkBufferCopy bufCopy = {
@@ -321,105 +1075,109 @@ void SvoBuilder::_editExistingChunk(ChunkIndex chunkIndex) {
       octreeBufferLength * sizeof(uint32_t), // size
   };
 
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
+  VkCommandBuffer cmdBuffer = _beginComputeCommands();
   // copy staging buffer to main buffer
   vkCmdCopyBuffer(cmdBuffer, _chunkOctreeBuffer->getVkBuffer(),
                   _appendedOctreeBuffer->getVkBuffer(), 1, &bufCopy);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  // the attributes share the offsets of the nodes
+  if (hasSeparateLeafAttributes()) {
+    vkCmdCopyBuffer(cmdBuffer, _chunkLeafAttributeBuffer->getVkBuffer(),
+                    _appendedLeafAttributeBuffer->getVkBuffer(), 1, &bufCopy);
+  }
+  _chunkOctreeBufferReadValue = _submitComputeCommands(cmdBuffer);
+
+  return writeOffsetInBytes / sizeof(uint32_t);
+}
 
-  uint32_t writeOffsetInUint32 = writeOffsetInBytes / sizeof(uint32_t) + 1U;
-  _octreeBufferWriteOffsetBuffer->fillData(&writeOffsetInUint32);
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
+// a write offset of 0 points the chunk to no octree
+void SvoBuilder::_updateChunkIndex(ChunkIndex chunkIndex, uint32_t octreeBufferWriteOffset) {
+  VkCommandBuffer cmdBuffer = _beginComputeCommands();
   // write the chunks image, according to the accumulated buffer offset
   // we should do it here, since we can cull null chunks here after the voxels are decided
+  _pushChunkConstants(cmdBuffer, _chunkIndicesBufferUpdaterPipeline.get(), chunkIndex,
+                      octreeBufferWriteOffset);
   _chunkIndicesBufferUpdaterPipeline->recordCommand(cmdBuffer, 0, 1, 1, 1);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  _submitComputeCommands(cmdBuffer);
 }
 
-void SvoBuilder::_buildChunkFromNoise(ChunkIndex chunkIndex) {
-  _resetBufferDataForNewChunkGeneration(chunkIndex);
-
-  VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
-
-  // construct field image
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkFieldConstructionPipeline->recordCommand(cmdBuffer, 0,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
-
-  // construct voxels into fragmentlist buffer
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkVoxelCreationPipeline->recordCommand(
-      cmdBuffer, 0, _configContainer->terrainInfo->chunkVoxelDim,
-      _configContainer->terrainInfo->chunkVoxelDim, _configContainer->terrainInfo->chunkVoxelDim);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
-
-  // intermediate step: check if the fragment list is empty, if so, we can skip the octree creation
-  G_FragmentListInfo fragmentListInfo{};
-  _fragmentListInfoBuffer->fetchData(&fragmentListInfo);
-  if (fragmentListInfo.voxelFragmentCount == 0) {
-    return;
+// reduces the chunk octree to a dag on the cpu, only the node groups that cannot be found in the
+// existing chunks are uploaded, returns the node index of the root node group
+uint32_t SvoBuilder::_appendChunkOctreeAsDag(ChunkIndex chunkIndex,
+                                             std::vector<uint32_t> const &octreeNodes) {
+  auto start = std::chrono::steady_clock::now();
+
+  auto const result = _dagCompressor->compress(_getChunkLinearIndex(chunkIndex),
+                                               octreeNodes.data(), octreeNodes.size());
+
+  if (!result.uploadNodes.empty()) {
+    VkDeviceSize const uploadSize = result.uploadNodes.size() * sizeof(uint32_t);
+    // the chunk octree buffer has been consumed, so it is reused as the staging buffer
+    _fillChunkOctreeBuffer(result.uploadNodes.data(), uploadSize);
+
+    VkBufferCopy bufCopy = {
+        0,                                          // srcOffset
+        result.uploadNodeOffset * sizeof(uint32_t), // dstOffset,
+        uploadSize,                                 // size
+    };
+
+    VkCommandBuffer cmdBuffer = _beginComputeCommands();
+    vkCmdCopyBuffer(cmdBuffer, _chunkOctreeBuffer->getVkBuffer(),
+                    _appendedOctreeBuffer->getVkBuffer(), 1, &bufCopy);
+    _chunkOctreeBufferReadValue = _submitComputeCommands(cmdBuffer);
   }
 
-  // octree construction
-  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  // wait until the image is ready
-  submitInfo.waitSemaphoreCount = 0;
-  // signal a semaphore after excecution finished
-  submitInfo.signalSemaphoreCount = 0;
-  // wait for no stage
-  VkPipelineStageFlags waitStages{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
-  submitInfo.pWaitDstStageMask = &waitStages;
+  auto end        = std::chrono::steady_clock::now();
+  auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
 
-  std::vector<VkCommandBuffer> commandBuffersToSubmit2{_octreeCreationCommandBuffer};
-  submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffersToSubmit2.size());
-  submitInfo.pCommandBuffers    = commandBuffersToSubmit2.data();
+  float const ratio = static_cast<float>(result.sourceNodeCount) /
+                      static_cast<float>(std::max<size_t>(result.uploadNodes.size(), 1));
+  _logger->info("chunk ({}, {}, {}) dag: {} -> {} nodes ({:.2f}x), {} groups shared, {:.2f} ms",
+                chunkIndex.x, chunkIndex.y, chunkIndex.z, result.sourceNodeCount,
+                result.uploadNodes.size(), ratio, result.reusedGroupCount,
+                static_cast<float>(durationUs) / 1000.F);
 
-  vkQueueSubmit(_appContext->getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(_appContext->getGraphicsQueue());
+  return result.rootGroupIndex;
+}
 
-  uint32_t octreeBufferLength = 0;
-  _octreeBufferLengthBuffer->fetchData(&octreeBufferLength);
+// converts the chunk octree to the 64-tree on the cpu and uploads it in place of the octree,
+// returns the node index of the root node
+uint32_t SvoBuilder::_appendChunkOctreeAsWideTree(ChunkIndex chunkIndex,
+                                                  std::vector<uint32_t> const &octreeNodes) {
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<uint32_t> const wideTree =
+      buildWideTreeFromOctree(octreeNodes.data(), octreeNodes.size(), _voxelLevelCount);
+  VkDeviceSize const uploadSize = wideTree.size() * sizeof(uint32_t);
 
-  // remove allocation
   auto const &it = _chunkIndexToBufferAllocResult.find(chunkIndex);
   if (it != _chunkIndexToBufferAllocResult.end()) {
     _chunkBufferMemoryAllocator->deallocate(it->second);
-    // erasing is omitted here, since we are going to overwrite it anyway
   }
-  _chunkIndexToBufferAllocResult[chunkIndex] =
-      _chunkBufferMemoryAllocator->allocate(octreeBufferLength * sizeof(uint32_t));
+  _chunkIndexToBufferAllocResult[chunkIndex] = _chunkBufferMemoryAllocator->allocate(uploadSize);
   uint32_t writeOffsetInBytes = _chunkIndexToBufferAllocResult[chunkIndex].offset();
 
-  _logger->info("memory offset: {} mb", static_cast<float>(writeOffsetInBytes) / (1024 * 1024));
+  // the chunk octree buffer has been consumed, so it is reused as the staging buffer
+  _fillChunkOctreeBuffer(wideTree.data(), uploadSize);
 
   VkBufferCopy bufCopy = {
-      0,                                     // srcOffset
-      writeOffsetInBytes,                    // dstOffset,
-      octreeBufferLength * sizeof(uint32_t), // size
+      0,                  // srcOffset
+      writeOffsetInBytes, // dstOffset,
+      uploadSize,         // size
   };
 
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  // copy staging buffer to main buffer
+  VkCommandBuffer cmdBuffer = _beginComputeCommands();
   vkCmdCopyBuffer(cmdBuffer, _chunkOctreeBuffer->getVkBuffer(),
                   _appendedOctreeBuffer->getVkBuffer(), 1, &bufCopy);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  _chunkOctreeBufferReadValue = _submitComputeCommands(cmdBuffer);
 
-  uint32_t writeOffsetInUint32 = writeOffsetInBytes / sizeof(uint32_t) + 1U;
-  _octreeBufferWriteOffsetBuffer->fillData(&writeOffsetInUint32);
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  // write the chunks image, according to the accumulated buffer offset
-  // we should do it here, since we can cull null chunks here after the voxels are decided
-  _chunkIndicesBufferUpdaterPipeline->recordCommand(cmdBuffer, 0, 1, 1, 1);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  auto end        = std::chrono::steady_clock::now();
+  auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+  _logger->info("chunk ({}, {}, {}) 64-tree: {} -> {} words, {:.2f} ms", chunkIndex.x,
+                chunkIndex.y, chunkIndex.z, octreeNodes.size(), wideTree.size(),
+                static_cast<float>(durationUs) / 1000.F);
+
+  return writeOffsetInBytes / sizeof(uint32_t);
 }
 
 void SvoBuilder::_createImages() {
@@ -434,6 +1192,8 @@ void SvoBuilder::_createImages() {
 }
 
 // voxData is passed in to decide the size of some buffers dureing allocation
+// the buffers that are only used by the builder are owned by the compute queue, the ones read by
+// the tracer are handed over around every batch of work, see _recordOwnershipTransferCommandBuffers
 void SvoBuilder::_createBuffers(size_t maximumOctreeBufferSize) {
   _chunkIndicesBuffer = std::make_unique<Buffer>(
       _appContext,
@@ -441,8 +1201,20 @@ void SvoBuilder::_createBuffers(size_t maximumOctreeBufferSize) {
           _configContainer->terrainInfo->chunksDim.y * _configContainer->terrainInfo->chunksDim.z,
       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
+  _chunkBrickMaskBuffer = std::make_unique<Buffer>(
+      _appContext,
+      sizeof(glm::uvec2) * _configContainer->terrainInfo->chunksDim.x *
+          _configContainer->terrainInfo->chunksDim.y * _configContainer->terrainInfo->chunksDim.z,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _chunkGroupOccupancyBuffer =
+      std::make_unique<Buffer>(_appContext, sizeof(uint32_t) * _getChunkGroupCount(),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
   _counterBuffer = std::make_unique<Buffer>(
-      _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+      _appContext, sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated, OwnerQueue::kCompute);
 
   uint32_t sizeInWorstCase =
       std::ceil(static_cast<float>(_configContainer->terrainInfo->chunkVoxelDim *
@@ -459,54 +1231,80 @@ void SvoBuilder::_createBuffers(size_t maximumOctreeBufferSize) {
           _configContainer->terrainInfo->chunkVoxelDim *
           _configContainer->terrainInfo->chunkVoxelDim,
       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-      MemoryStyle::kHostVisible);
+      MemoryStyle::kHostVisible, OwnerQueue::kCompute);
+
+  // the attribute buffers are only bound as placeholders when the attributes are kept in the
+  // leaves, the chunk attributes are read back with the chunk octree, so they are host visible
+  size_t const chunkLeafAttributeBufferSize =
+      hasSeparateLeafAttributes() ? sizeof(uint32_t) *
+                                        _configContainer->terrainInfo->chunkVoxelDim *
+                                        _configContainer->terrainInfo->chunkVoxelDim *
+                                        _configContainer->terrainInfo->chunkVoxelDim
+                                  : sizeof(uint32_t);
+  _chunkLeafAttributeBuffer = std::make_unique<Buffer>(
+      _appContext, chunkLeafAttributeBufferSize,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      MemoryStyle::kHostVisible, OwnerQueue::kCompute);
 
-  _indirectFragLengthBuffer = std::make_unique<Buffer>(_appContext, sizeof(G_IndirectDispatchInfo),
-                                                       VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
-                                                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                       MemoryStyle::kDedicated);
+  _indirectFragLengthBuffer =
+      std::make_unique<Buffer>(_appContext, sizeof(G_IndirectDispatchInfo),
+                               VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                               MemoryStyle::kDedicated, OwnerQueue::kCompute);
 
   _appendedOctreeBuffer = std::make_unique<Buffer>(_appContext, maximumOctreeBufferSize,
                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
                                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                                    MemoryStyle::kDedicated);
 
+  _appendedLeafAttributeBuffer = std::make_unique<Buffer>(
+      _appContext, hasSeparateLeafAttributes() ? maximumOctreeBufferSize : sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+
   uint32_t maximumFragmentListBufferSize =
       sizeof(G_FragmentListEntry) * _configContainer->terrainInfo->chunkVoxelDim *
       _configContainer->terrainInfo->chunkVoxelDim * _configContainer->terrainInfo->chunkVoxelDim;
-  _fragmentListBuffer =
-      std::make_unique<Buffer>(_appContext, maximumFragmentListBufferSize,
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _fragmentListBuffer = std::make_unique<Buffer>(
+      _appContext, maximumFragmentListBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      MemoryStyle::kDedicated, OwnerQueue::kCompute);
 
   _logger->info("fragment list buffer size: {} mb",
                 static_cast<float>(maximumFragmentListBufferSize) / (1024 * 1024));
 
-  _octreeBuildInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_OctreeBuildInfo),
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
-
-  _indirectAllocNumBuffer = std::make_unique<Buffer>(_appContext, sizeof(G_IndirectDispatchInfo),
-                                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
-                                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                     MemoryStyle::kDedicated);
-
-  _fragmentListInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_FragmentListInfo),
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
-
-  _chunksInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_ChunksInfo),
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
-
-  _chunkEditingInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_ChunkEditingInfo),
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _octreeBuildInfoBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_OctreeBuildInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated, OwnerQueue::kCompute);
+
+  _indirectAllocNumBuffer =
+      std::make_unique<Buffer>(_appContext, sizeof(G_IndirectDispatchInfo),
+                               VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                               MemoryStyle::kDedicated, OwnerQueue::kCompute);
+
+  // read back after every chunk, so host visible
+  _fragmentListInfoBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_FragmentListInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kHostVisible, OwnerQueue::kCompute);
+
+  _chunksInfoBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_ChunksInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated, OwnerQueue::kCompute);
+
+  // only written between the edits, which are waited for
+  _chunkEditingInfoBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_ChunkEditingInfo), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      MemoryStyle::kHostVisible, OwnerQueue::kCompute);
 
   _octreeBufferLengthBuffer = std::make_unique<Buffer>(
-      _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
-
-  _octreeBufferWriteOffsetBuffer = std::make_unique<Buffer>(
-      _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+      _appContext, sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kHostVisible, OwnerQueue::kCompute);
 }
 
 void SvoBuilder::_initBufferData() {
@@ -516,6 +1314,26 @@ void SvoBuilder::_initBufferData() {
                                        _configContainer->terrainInfo->chunksDim.z,
                                    0);
   _chunkIndicesBuffer->fillData(chunksData.data());
+
+  std::vector<glm::uvec2> brickMasks(chunksData.size(), glm::uvec2{0, 0});
+  _chunkBrickMaskBuffer->fillData(brickMasks.data());
+
+  std::vector<uint32_t> chunkGroupsData(_getChunkGroupCount(), 0);
+  _chunkGroupOccupancyBuffer->fillData(chunkGroupsData.data());
+
+  // the chunk being written is pushed per dispatch, so this never changes
+  G_ChunksInfo chunksInfo{};
+  chunksInfo.chunksDim      = getChunksDim();
+  chunksInfo.dagCompression = isDagCompressed() ? 1U : 0U;
+  _chunksInfoBuffer->fillData(&chunksInfo);
+}
+
+void SvoBuilder::_pushChunkConstants(VkCommandBuffer commandBuffer, ComputePipeline *pipeline,
+                                     ChunkIndex chunkIndex, uint32_t octreeBufferWriteOffset) {
+  G_ChunkPushConstants pushConstants{};
+  pushConstants.currentlyWritingChunk   = {chunkIndex.x, chunkIndex.y, chunkIndex.z};
+  pushConstants.octreeBufferWriteOffset = octreeBufferWriteOffset;
+  pipeline->pushConstants(commandBuffer, pushConstants);
 }
 
 void SvoBuilder::_createDescriptorSetBundle() {
@@ -534,8 +1352,11 @@ void SvoBuilder::_createDescriptorSetBundle() {
   _descriptorSetBundle->bindStorageBuffer(8, _fragmentListInfoBuffer.get());
   _descriptorSetBundle->bindStorageBuffer(9, _chunksInfoBuffer.get());
   _descriptorSetBundle->bindStorageBuffer(10, _octreeBufferLengthBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(11, _octreeBufferWriteOffsetBuffer.get());
   _descriptorSetBundle->bindStorageBuffer(12, _chunkEditingInfoBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(13, _chunkLeafAttributeBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(14, _appendedOctreeBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(15, _chunkBrickMaskBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(16, _chunkGroupOccupancyBuffer.get());
 
   _descriptorSetBundle->create();
 }
@@ -543,39 +1364,48 @@ void SvoBuilder::_createDescriptorSetBundle() {
 void SvoBuilder::_createPipelines() {
   _chunkIndicesBufferUpdaterPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkIndicesBufferUpdater.comp"),
-      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _chunkFieldConstructionPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkFieldConstruction.comp"),
-      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _chunkFieldModificationPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkFieldModification.comp"),
-      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _chunkVoxelCreationPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkVoxelCreation.comp"),
-      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _chunkModifyArgPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkModifyArg.comp"),
-      WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _initNodePipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("octreeInitNode.comp"),
-      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _tagNodePipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("octreeTagNode.comp"),
-      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _allocNodePipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("octreeAllocNode.comp"),
-      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 
   _modifyArgPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("octreeModifyArg.comp"),
-      WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ChunkPushConstants));
 }
 
 void SvoBuilder::_recordCommandBuffers() { _recordOctreeCreationCommandBuffer(); }
@@ -583,13 +1413,15 @@ void SvoBuilder::_recordCommandBuffers() { _recordOctreeCreationCommandBuffer();
 void SvoBuilder::_recordOctreeCreationCommandBuffer() {
   VkCommandBufferAllocateInfo allocInfo{};
   allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  allocInfo.commandPool        = _appContext->getCommandPool();
+  allocInfo.commandPool        = _appContext->getComputeCommandPool();
   allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
   allocInfo.commandBufferCount = 1;
 
   vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &_octreeCreationCommandBuffer);
 
+  // a dropped build may still be pending when the buffer is submitted by an edit
   VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
   vkBeginCommandBuffer(_octreeCreationCommandBuffer, &beginInfo);
 
   // create the standard memory barrier
@@ -650,5 +1482,12 @@ void SvoBuilder::_recordOctreeCreationCommandBuffer() {
     }
   }
 
+  // the chunk octree buffer is host visible, it is read back once the submission has finished
+  VkMemoryBarrier hostReadBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  hostReadBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+  hostReadBarrier.dstAccessMask   = VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostReadBarrier, 0, nullptr, 0, nullptr);
+
   vkEndCommandBuffer(_octreeCreationCommandBuffer);
 }
@@ -1,13 +1,20 @@
 #pragma once
 
+#include "ChunkOctreeBuilder.hpp"
 #include "custom-mem-alloc/CustomMemoryAllocator.hpp"
 #include "scheduler/Scheduler.hpp"
 #include "volk.h"
 
 #include "glm/glm.hpp" // IWYU pragma: export
 
+#include <chrono>
+#include <deque>
+#include <future>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 struct ConfigContainer;
 
@@ -19,6 +26,10 @@ class Buffer;
 class Image;
 class ShaderCompiler;
 class ShaderChangeListener;
+class SvoDagCompressor;
+class JobSystem;
+class ChunkFieldGenerator;
+class VoxelWorldMirror;
 
 class SvoBuilder : public PipelineScheduler {
 private:
@@ -43,8 +54,15 @@ private:
   };
 
 public:
+  // the world space bounds of a chunk, a chunk spans one unit
+  struct ChunkBounds {
+    glm::vec3 min;
+    glm::vec3 max;
+  };
+
   SvoBuilder(VulkanApplicationContext *appContext, Logger *logger, ShaderCompiler *shaderCompiler,
-             ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer);
+             ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer,
+             JobSystem *jobSystem);
   ~SvoBuilder() override;
 
   // disable copy and move
@@ -56,15 +74,37 @@ public:
   void init();
   void onPipelineRebuilt() override;
 
-  void buildScene();
+  // builds the pending chunks of the scene within the per-frame budget, the chunks in the view
+  // frustum go first, then the nearest ones, called once per frame from the render loop, so the
+  // frames are shown while the scene is being built, the built chunks are reported as edited
+  void buildSceneStep(glm::vec3 cameraPosition, glm::mat4 const &vpMat);
+  [[nodiscard]] bool isSceneBuilt() const {
+    return _pendingChunks.empty() && _cpuChunkJobs.empty() && !_gpuChunkBuild.has_value();
+  }
 
   void handleCursorHit(glm::vec3 hitPos, bool deletionMode);
 
+  // returns the bounds of the chunks edited since the last call, so the caches of the tracer that
+  // depend on the geometry can be updated partially
+  std::vector<ChunkBounds> takeEditedChunkBounds();
+
   Buffer *getAppendedOctreeBuffer() { return _appendedOctreeBuffer.get(); }
+  Buffer *getAppendedLeafAttributeBuffer() { return _appendedLeafAttributeBuffer.get(); }
   Buffer *getChunkIndicesBuffer() { return _chunkIndicesBuffer.get(); }
+  Buffer *getChunkBrickMaskBuffer() { return _chunkBrickMaskBuffer.get(); }
+  Buffer *getChunkGroupOccupancyBuffer() { return _chunkGroupOccupancyBuffer.get(); }
+  // the cpu copy of the chunk octrees, null without Terrain.cpuWorldMirror
+  VoxelWorldMirror *getVoxelWorldMirror() { return _voxelWorldMirror.get(); }
 
   [[nodiscard]] uint32_t getVoxelLevelCount() const { return _voxelLevelCount; }
   [[nodiscard]] glm::uvec3 getChunksDim() const;
+  // when enabled, child pointers in the appended octree buffer are absolute
+  [[nodiscard]] bool isDagCompressed() const;
+  // when enabled, the appended octree buffer holds 64-trees, see WideTreeBuilder.hpp
+  [[nodiscard]] bool isWideTree() const;
+  // when enabled, leaf properties are stored in the appended leaf attribute buffer, at the same
+  // index as the leaf node
+  [[nodiscard]] bool hasSeparateLeafAttributes() const;
 
 private:
   VulkanApplicationContext *_appContext;
@@ -73,21 +113,130 @@ private:
   ShaderChangeListener *_shaderChangeListener;
 
   ConfigContainer *_configContainer;
+  JobSystem *_jobSystem;
 
   uint32_t _voxelLevelCount = 0;
 
+  // the chunks not built yet, they are prioritized again every step, as the camera moves
+  std::vector<ChunkIndex> _pendingChunks;
+  uint32_t _builtChunkCount       = 0;
+  uint32_t _minChunkBuildTimeMs   = std::numeric_limits<uint32_t>::max();
+  uint32_t _maxChunkBuildTimeMs   = 0;
+  uint32_t _totalChunkBuildTimeMs = 0;
+  void _queueAllChunks();
+  void _sortPendingChunks(glm::vec3 cameraPosition, glm::mat4 const &vpMat);
+  void _buildSceneStepOnGpu();
+  void _buildSceneStepOnCpu();
+  void _recordChunkBuilt(ChunkIndex chunkIndex, uint32_t buildTimeMs);
+  void _logSceneBuildStats();
+
+  // the chunk whose field, voxels and octree are being built on the gpu, its result is read back
+  // from the builder buffers by a later step, once the timeline value is reached
+  struct GpuChunkBuild {
+    ChunkIndex chunkIndex;
+    uint64_t timelineValue;
+    std::chrono::steady_clock::time_point startTime;
+  };
+  std::optional<GpuChunkBuild> _gpuChunkBuild;
+  void _startChunkBuildFromNoise(ChunkIndex chunkIndex);
+  void _finishGpuChunkBuild();
+  void _dropGpuChunkBuild();
+
+  // with Terrain.cpuChunkGeneration, the field, the fragments and the octree of a chunk are built
+  // by a job, the gpu only copies the result into the appended octree buffer
+  struct CpuChunkResult {
+    ChunkOctree octree;
+    uint32_t buildTimeMs;
+  };
+  struct CpuChunkJob {
+    ChunkIndex chunkIndex;
+    std::future<CpuChunkResult> result;
+    // the chunk was edited or the scene was rebuilt while the job was running
+    bool discarded;
+  };
+  std::unique_ptr<ChunkFieldGenerator> _chunkFieldGenerator;
+  std::vector<CpuChunkJob> _cpuChunkJobs;
+  [[nodiscard]] CpuChunkResult _buildChunkOctreeOnCpu(ChunkIndex chunkIndex) const;
+  [[nodiscard]] ChunkOctree _buildChunkOctreeFromField(ChunkIndex chunkIndex,
+                                                       std::vector<uint16_t> const &field) const;
+  void _discardCpuChunkJobs();
+
+  // the fragments of the mesh of Terrain.meshPath by the linear chunk index, they are merged into
+  // the chunks built on the cpu, including the edited ones, empty without a mesh
+  std::vector<std::vector<G_FragmentListEntry>> _meshFragments;
+  void _voxelizeMesh();
+
   std::unique_ptr<DescriptorSetBundle> _descriptorSetBundle;
   std::unique_ptr<CustomMemoryAllocator> _chunkBufferMemoryAllocator;
+  std::unique_ptr<SvoDagCompressor> _dagCompressor;
+  std::unique_ptr<VoxelWorldMirror> _voxelWorldMirror;
 
   VkCommandBuffer _octreeCreationCommandBuffer = VK_NULL_HANDLE;
 
+  // the builder runs on the compute queue, the handovers of the shared buffers between the
+  // compute and the graphics queue are ordered by the timeline semaphore
+  VkSemaphore _timelineSemaphore                = VK_NULL_HANDLE;
+  uint64_t _timelineValue                       = 0;
+  VkCommandBuffer _graphicsReleaseCommandBuffer = VK_NULL_HANDLE;
+  VkCommandBuffer _computeAcquireCommandBuffer  = VK_NULL_HANDLE;
+  VkCommandBuffer _computeReleaseCommandBuffer  = VK_NULL_HANDLE;
+  VkCommandBuffer _graphicsAcquireCommandBuffer = VK_NULL_HANDLE;
+
+  // the work of the builder itself is ordered by the queue, this timeline is only signaled by the
+  // compute queue, so the cpu can wait for a single submission instead of idling the queue
+  VkSemaphore _computeTimelineSemaphore = VK_NULL_HANDLE;
+  uint64_t _computeTimelineValue        = 0;
+  // the last submission that reads the host visible chunk octree buffers, which must be reached
+  // before the buffers are written from the cpu
+  uint64_t _chunkOctreeBufferReadValue = 0;
+  struct PendingCommandBuffer {
+    VkCommandBuffer commandBuffer;
+    uint64_t timelineValue;
+  };
+  std::deque<PendingCommandBuffer> _pendingCommandBuffers;
+
+  void _createTimelineSemaphores();
+  void _recordOwnershipTransferCommandBuffers();
+  void _submitWithTimeline(VkQueue queue, VkCommandBuffer commandBuffer, uint64_t waitValue,
+                           uint64_t signalValue);
+  // hands the shared buffers over to the compute queue, call before a batch of work
+  void _acquireSharedBuffers();
+  // hands the shared buffers back to the graphics queue, call after a batch of work
+  void _releaseSharedBuffers();
+
+  // the command buffer begins with a barrier against the previous submissions to the queue
+  VkCommandBuffer _beginComputeCommands();
+  // returns the timeline value that is signaled once the submission has finished, the octree
+  // creation command buffer is appended if requested
+  uint64_t _submitComputeCommands(VkCommandBuffer commandBuffer, bool withOctreeCreation = false);
+  // returns false if the value is not reached within the timeout
+  bool _waitForComputeTimeline(uint64_t value, uint64_t timeoutNs = UINT64_MAX);
+  void _freeCompletedCommandBuffers();
+
   std::vector<ChunkIndex> _getEditingChunks(glm::vec3 centerPos, float radius);
+  std::vector<ChunkBounds> _editedChunkBounds;
 
   void _recordCommandBuffers();
   void _recordOctreeCreationCommandBuffer();
 
-  void _editExistingChunk(ChunkIndex chunkIndex);
-  void _buildChunkFromNoise(ChunkIndex chunkIndex);
+  void _editExistingChunk(ChunkOctree &oOctree, ChunkIndex chunkIndex);
+  void _recordChunkFieldReadback(VkCommandBuffer commandBuffer, VkBuffer readbackBuffer);
+  // writes the chunk field image as raw R16 values, to check the cpu generator against
+  void _dumpChunkField(ChunkIndex chunkIndex);
+  // reads back the octree that was just built in the chunk octree buffer, returns its length, the
+  // nodes are only read if requested or needed by the append
+  uint32_t _fetchChunkOctree(ChunkOctree &oOctree, bool withNodes);
+  void _appendChunkOctree(ChunkIndex chunkIndex, uint32_t octreeBufferLength, ChunkOctree octree);
+  void _appendChunkOctree(ChunkIndex chunkIndex, ChunkOctree octree);
+  void _clearChunk(ChunkIndex chunkIndex);
+  void _fillChunkOctreeBuffer(void const *data, VkDeviceSize size);
+  uint32_t _appendChunkOctreeAsOctree(ChunkIndex chunkIndex, uint32_t octreeBufferLength);
+  uint32_t _appendChunkOctreeAsDag(ChunkIndex chunkIndex, std::vector<uint32_t> const &octreeNodes);
+  uint32_t _appendChunkOctreeAsWideTree(ChunkIndex chunkIndex,
+                                        std::vector<uint32_t> const &octreeNodes);
+  void _updateChunkIndex(ChunkIndex chunkIndex, uint32_t octreeBufferWriteOffset);
+  [[nodiscard]] uint32_t _getChunkLinearIndex(ChunkIndex chunkIndex) const;
+  [[nodiscard]] uint32_t _getChunkGroupCount() const;
 
   /// IMAGES
   std::unique_ptr<Image> _chunkFieldImage;
@@ -99,15 +248,19 @@ private:
 
   /// BUFFERS
   std::unique_ptr<Buffer> _chunkIndicesBuffer;
+  // the occupancy structure above the octrees, see occupancy.glsl
+  std::unique_ptr<Buffer> _chunkBrickMaskBuffer;
+  std::unique_ptr<Buffer> _chunkGroupOccupancyBuffer;
   std::unique_ptr<Buffer> _appendedOctreeBuffer;
+  std::unique_ptr<Buffer> _appendedLeafAttributeBuffer;
   std::unique_ptr<Buffer> _chunksInfoBuffer;
   std::unique_ptr<Buffer> _chunkEditingInfoBuffer;
   std::unique_ptr<Buffer> _octreeBufferLengthBuffer;
-  std::unique_ptr<Buffer> _octreeBufferWriteOffsetBuffer;
 
   std::unique_ptr<Buffer> _indirectFragLengthBuffer;
   std::unique_ptr<Buffer> _counterBuffer;
   std::unique_ptr<Buffer> _chunkOctreeBuffer;
+  std::unique_ptr<Buffer> _chunkLeafAttributeBuffer;
   std::unique_ptr<Buffer> _fragmentListBuffer;
   std::unique_ptr<Buffer> _octreeBuildInfoBuffer;
   std::unique_ptr<Buffer> _indirectAllocNumBuffer;
@@ -115,7 +268,10 @@ private:
 
   void _createBuffers(size_t octreeBufferSize);
   void _initBufferData();
-  void _resetBufferDataForNewChunkGeneration(ChunkIndex chunkIndex);
+  void _resetBufferDataForNewChunkGeneration(VkCommandBuffer commandBuffer);
+  // the chunk that the following dispatches of the pipeline work on
+  static void _pushChunkConstants(VkCommandBuffer commandBuffer, ComputePipeline *pipeline,
+                                  ChunkIndex chunkIndex, uint32_t octreeBufferWriteOffset = 0);
 
   /// PIPELINES
 
@@ -0,0 +1,176 @@
+#include "SvoDagCompressor.hpp"
+
+#include <cassert>
+
+namespace {
+
+uint32_t constexpr kHasChildBit      = 0x80000000U;
+uint32_t constexpr kLeafBit          = 0x40000000U;
+uint32_t constexpr kChildPointerMask = 0x3FFFFFFFU;
+
+bool _isInnerNode(uint32_t node) { return (node & kHasChildBit) != 0 && (node & kLeafBit) == 0; }
+
+} // namespace
+
+std::size_t SvoDagCompressor::NodeGroupHash::operator()(NodeGroup const &group) const {
+  // fnv-1a over the 8 nodes and the local mask
+  uint64_t h = 14695981039346656037ULL;
+  for (uint32_t const node : group.nodes) {
+    h ^= node;
+    h *= 1099511628211ULL;
+  }
+  h ^= group.localMask;
+  h *= 1099511628211ULL;
+  return static_cast<std::size_t>(h);
+}
+
+SvoDagCompressor::SvoDagCompressor(CustomMemoryAllocator *allocator) : _allocator(allocator) {}
+
+SvoDagCompressor::~SvoDagCompressor() = default;
+
+SvoDagCompressor::GroupRef SvoDagCompressor::_reduceGroup(ReductionContext &ctx,
+                                                         uint32_t groupIndex) {
+  assert(groupIndex + 8 <= ctx.nodeCount && "node group is out of range");
+
+  NodeGroup group{};
+  for (uint32_t i = 0; i < 8; i++) {
+    uint32_t const node = ctx.nodes[groupIndex + i];
+    if (!_isInnerNode(node)) {
+      // leaves (with their properties) and empty nodes are kept as is
+      group.nodes[i] = node;
+      continue;
+    }
+    GroupRef const child = _reduceGroup(ctx, node & kChildPointerMask);
+    group.nodes[i]       = kHasChildBit | child.index;
+    if (child.isLocal) {
+      group.localMask |= static_cast<uint8_t>(1U << i);
+    }
+  }
+
+  // a group that points to a newly created group can never be found in the shared groups
+  if (group.localMask == 0) {
+    auto const it = _sharedGroups.find(group);
+    if (it != _sharedGroups.end()) {
+      ctx.referencedAllocations.insert(it->second.allocationOffset);
+      ctx.reusedGroupCount++;
+      return {it->second.groupIndex, false};
+    }
+  }
+
+  auto const it = ctx.localGroups.find(group);
+  if (it != ctx.localGroups.end()) {
+    return {it->second, true};
+  }
+
+  auto const localIndex = static_cast<uint32_t>(ctx.newGroups.size());
+  ctx.localGroups.emplace(group, localIndex);
+  ctx.newGroups.push_back(group);
+  return {localIndex, true};
+}
+
+SvoDagCompressor::CompressionResult
+SvoDagCompressor::compress(uint32_t chunkId, uint32_t const *nodes, size_t nodeCount) {
+  CompressionResult result{};
+  result.sourceNodeCount = nodeCount;
+
+  ReductionContext ctx{};
+  ctx.nodes     = nodes;
+  ctx.nodeCount = nodeCount;
+
+  // children are always reduced before their parents, so the new groups are in post order
+  GroupRef const root     = _reduceGroup(ctx, 0);
+  result.reusedGroupCount = ctx.reusedGroupCount;
+
+  ChunkRecord record{};
+  record.sourceNodeCount = nodeCount;
+
+  if (ctx.newGroups.empty()) {
+    result.rootGroupIndex = root.index;
+  } else {
+    size_t const newNodeCount = ctx.newGroups.size() * 8;
+
+    DagAllocation dagAllocation{};
+    dagAllocation.allocation = _allocator->allocate(newNodeCount * sizeof(uint32_t));
+    size_t const allocationOffset = dagAllocation.allocation.offset();
+    auto const baseNodeIndex      = static_cast<uint32_t>(allocationOffset / sizeof(uint32_t));
+    assert(baseNodeIndex + newNodeCount <= kChildPointerMask && "child pointer overflow");
+
+    // resolve the local group indices to absolute node indices
+    result.uploadNodeOffset = baseNodeIndex;
+    result.uploadNodes.reserve(newNodeCount);
+    dagAllocation.groups.reserve(ctx.newGroups.size());
+    for (size_t g = 0; g < ctx.newGroups.size(); g++) {
+      NodeGroup group = ctx.newGroups[g];
+      for (uint32_t i = 0; i < 8; i++) {
+        if ((group.localMask & (1U << i)) != 0) {
+          uint32_t const localIndex = group.nodes[i] & kChildPointerMask;
+          group.nodes[i]            = kHasChildBit | (baseNodeIndex + localIndex * 8);
+        }
+      }
+      group.localMask = 0;
+
+      auto const groupIndex = static_cast<uint32_t>(baseNodeIndex + g * 8);
+      _sharedGroups.emplace(group, GroupLocation{groupIndex, allocationOffset});
+      result.uploadNodes.insert(result.uploadNodes.end(), group.nodes.begin(), group.nodes.end());
+      dagAllocation.groups.push_back(group);
+    }
+
+    result.rootGroupIndex = root.isLocal ? baseNodeIndex + root.index * 8 : root.index;
+
+    _allocations.emplace(allocationOffset, std::move(dagAllocation));
+    ctx.referencedAllocations.insert(allocationOffset);
+    _storedNodeCount += newNodeCount;
+  }
+
+  for (size_t const allocationOffset : ctx.referencedAllocations) {
+    _allocations.at(allocationOffset).refCount++;
+    record.referencedAllocations.push_back(allocationOffset);
+  }
+
+  // the previous version is released only now, so its groups could be reused above
+  release(chunkId);
+  _chunkRecords.emplace(chunkId, std::move(record));
+  _sourceNodeCount += nodeCount;
+
+  return result;
+}
+
+void SvoDagCompressor::_releaseRecord(ChunkRecord const &record) {
+  for (size_t const allocationOffset : record.referencedAllocations) {
+    auto it = _allocations.find(allocationOffset);
+    assert(it != _allocations.end() && "referenced allocation is missing");
+
+    DagAllocation &dagAllocation = it->second;
+    if (--dagAllocation.refCount > 0) {
+      continue;
+    }
+
+    for (NodeGroup const &group : dagAllocation.groups) {
+      auto const groupIt = _sharedGroups.find(group);
+      if (groupIt != _sharedGroups.end() && groupIt->second.allocationOffset == allocationOffset) {
+        _sharedGroups.erase(groupIt);
+      }
+    }
+    _storedNodeCount -= dagAllocation.groups.size() * 8;
+    _allocator->deallocate(dagAllocation.allocation);
+    _allocations.erase(it);
+  }
+  _sourceNodeCount -= record.sourceNodeCount;
+}
+
+void SvoDagCompressor::release(uint32_t chunkId) {
+  auto const it = _chunkRecords.find(chunkId);
+  if (it == _chunkRecords.end()) {
+    return;
+  }
+  _releaseRecord(it->second);
+  _chunkRecords.erase(it);
+}
+
+void SvoDagCompressor::reset() {
+  _sharedGroups.clear();
+  _allocations.clear();
+  _chunkRecords.clear();
+  _sourceNodeCount = 0;
+  _storedNodeCount = 0;
+}
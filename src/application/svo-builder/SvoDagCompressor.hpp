@@ -0,0 +1,113 @@
+#pragma once
+
+#include "custom-mem-alloc/CustomMemoryAllocator.hpp"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// reduces the chunk octrees into a sparse voxel DAG by merging identical node groups (the 8
+// siblings that a child pointer points to), bottom-up, both within a chunk and across all the
+// chunks that are currently alive
+
+// in the reduced form, child pointers are absolute node indices of the appended octree buffer,
+// since a node group can be shared by multiple chunks
+class SvoDagCompressor {
+public:
+  struct CompressionResult {
+    // absolute node index of the root node group of the chunk
+    uint32_t rootGroupIndex = 0;
+    // the nodes that should be written to the appended octree buffer, at uploadNodeOffset, this is
+    // empty if the whole chunk can be made of existing node groups
+    std::vector<uint32_t> uploadNodes{};
+    uint32_t uploadNodeOffset = 0;
+
+    size_t sourceNodeCount  = 0;
+    size_t reusedGroupCount = 0;
+  };
+
+  SvoDagCompressor(CustomMemoryAllocator *allocator);
+  ~SvoDagCompressor();
+
+  // disable copy and move
+  SvoDagCompressor(SvoDagCompressor const &)            = delete;
+  SvoDagCompressor(SvoDagCompressor &&)                 = delete;
+  SvoDagCompressor &operator=(SvoDagCompressor const &) = delete;
+  SvoDagCompressor &operator=(SvoDagCompressor &&)      = delete;
+
+  // nodes is the octree produced by the svo builder, with the root node group at index 0 and child
+  // pointers relative to the start of the chunk
+  // the old version of the chunk (if any) is released after the new version is reduced, so that
+  // the unchanged parts of an edited chunk can be reused
+  CompressionResult compress(uint32_t chunkId, uint32_t const *nodes, size_t nodeCount);
+
+  // drop the references of the chunk, node groups that are no longer referenced are freed
+  void release(uint32_t chunkId);
+
+  // forget all node groups, the allocator is freed by its owner
+  void reset();
+
+  [[nodiscard]] size_t getSourceNodeCount() const { return _sourceNodeCount; }
+  [[nodiscard]] size_t getStoredNodeCount() const { return _storedNodeCount; }
+
+private:
+  CustomMemoryAllocator *_allocator;
+
+  struct NodeGroup {
+    std::array<uint32_t, 8> nodes{};
+    // marks the child pointers that are indices of groups created in the current pass
+    uint8_t localMask = 0;
+
+    bool operator==(NodeGroup const &other) const {
+      return localMask == other.localMask && nodes == other.nodes;
+    }
+  };
+
+  struct NodeGroupHash {
+    std::size_t operator()(NodeGroup const &group) const;
+  };
+
+  struct GroupLocation {
+    uint32_t groupIndex;
+    size_t allocationOffset;
+  };
+
+  struct DagAllocation {
+    CustomMemoryAllocationResult allocation;
+    std::vector<NodeGroup> groups;
+    uint32_t refCount = 0;
+  };
+
+  struct ChunkRecord {
+    std::vector<size_t> referencedAllocations;
+    size_t sourceNodeCount = 0;
+  };
+
+  struct GroupRef {
+    uint32_t index;
+    bool isLocal;
+  };
+
+  // states of a single compression pass
+  struct ReductionContext {
+    uint32_t const *nodes = nullptr;
+    size_t nodeCount      = 0;
+    std::unordered_map<NodeGroup, uint32_t, NodeGroupHash> localGroups;
+    std::vector<NodeGroup> newGroups;
+    std::unordered_set<size_t> referencedAllocations;
+    size_t reusedGroupCount = 0;
+  };
+
+  std::unordered_map<NodeGroup, GroupLocation, NodeGroupHash> _sharedGroups;
+  // keyed by the offset of the allocation, in bytes
+  std::unordered_map<size_t, DagAllocation> _allocations;
+  std::unordered_map<uint32_t, ChunkRecord> _chunkRecords;
+
+  size_t _sourceNodeCount = 0;
+  size_t _storedNodeCount = 0;
+
+  GroupRef _reduceGroup(ReductionContext &ctx, uint32_t groupIndex);
+  void _releaseRecord(ChunkRecord const &record);
+};
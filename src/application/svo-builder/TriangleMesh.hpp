@@ -0,0 +1,15 @@
+#pragma once
+
+#include "glm/glm.hpp" // IWYU pragma: export
+
+#include <cstdint>
+#include <vector>
+
+// the triangles are counter clockwise when seen from the front, so the normals point out of them
+struct TriangleMesh {
+  std::vector<glm::vec3> positions;
+  // three per triangle
+  std::vector<uint32_t> indices;
+
+  [[nodiscard]] size_t getTriangleCount() const { return indices.size() / 3; }
+};
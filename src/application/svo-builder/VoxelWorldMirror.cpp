@@ -0,0 +1,400 @@
+#include "VoxelWorldMirror.hpp"
+
+#include "utils/job-system/JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+// refer svoMarching.glsl for the node words
+uint32_t constexpr kLeafBits         = 0xC0000000U;
+uint32_t constexpr kChildPointerMask = 0x3FFFFFFFU;
+uint32_t constexpr kBlockTypeMask    = 0xFFU;
+uint32_t constexpr kBlockTypeEmpty   = 0;
+
+// the rays of a packet are cast under one lock
+size_t constexpr kRaycastBatchGrainSize = 64;
+
+float constexpr kInfinity = std::numeric_limits<float>::infinity();
+
+// the t of the ray at its entry and its exit of the box, the entry is negative if the origin is
+// inside, oEntryAxis is -1 then
+bool _intersectBox(float &oTEntry, float &oTExit, int &oEntryAxis, glm::vec3 origin,
+                   glm::vec3 direction, glm::vec3 boxMin, glm::vec3 boxMax) {
+  oTEntry    = -kInfinity;
+  oTExit     = kInfinity;
+  oEntryAxis = -1;
+  for (int axis = 0; axis < 3; axis++) {
+    if (direction[axis] == 0.F) {
+      if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) {
+        return false;
+      }
+      continue;
+    }
+    float const t0    = (boxMin[axis] - origin[axis]) / direction[axis];
+    float const t1    = (boxMax[axis] - origin[axis]) / direction[axis];
+    float const tNear = std::min(t0, t1);
+    float const tFar  = std::max(t0, t1);
+    if (tNear > oTEntry) {
+      oTEntry    = tNear;
+      oEntryAxis = axis;
+    }
+    oTExit = std::min(oTExit, tFar);
+  }
+  if (oTEntry < 0.F) {
+    oEntryAxis = -1;
+  }
+  return oTEntry <= oTExit && oTExit >= 0.F;
+}
+
+// the normal of the face that is entered along the axis, the dominant axis of the direction is
+// used when the ray starts inside of the voxel
+glm::vec3 _getEntryNormal(int entryAxis, glm::vec3 direction) {
+  if (entryAxis < 0) {
+    glm::vec3 const absDirection = glm::abs(direction);
+    entryAxis                    = absDirection.x >= absDirection.y
+                                       ? (absDirection.x >= absDirection.z ? 0 : 2)
+                                       : (absDirection.y >= absDirection.z ? 1 : 2);
+  }
+  glm::vec3 normal{0.F};
+  normal[entryAxis] = direction[entryAxis] > 0.F ? -1.F : 1.F;
+  return normal;
+}
+
+} // namespace
+
+VoxelWorldMirror::VoxelWorldMirror(uint32_t voxelResolution, glm::uvec3 chunksDim,
+                                   bool separateLeafAttributes)
+    : _voxelResolution(voxelResolution),
+      _voxelLevelCount(static_cast<uint32_t>(std::log2(voxelResolution))), _chunksDim(chunksDim),
+      _separateLeafAttributes(separateLeafAttributes),
+      _chunks(static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z) {}
+
+void VoxelWorldMirror::setChunk(glm::uvec3 chunkIndex, ChunkOctree octree) {
+  std::unique_ptr<Chunk const> chunk = nullptr;
+  if (!octree.nodes.empty()) {
+    uint64_t const brickMask = _computeBrickMask(octree);
+    chunk                    = std::make_unique<Chunk const>(Chunk{std::move(octree), brickMask});
+  }
+
+  size_t const linearIndex = chunkIndex.x + chunkIndex.y * _chunksDim.x +
+                             static_cast<size_t>(chunkIndex.z) * _chunksDim.x * _chunksDim.y;
+  {
+    std::unique_lock const lock(_mutex);
+    _chunks[linearIndex].swap(chunk);
+  }
+  // the replaced chunk is freed out of the lock
+}
+
+void VoxelWorldMirror::clear() {
+  std::vector<std::unique_ptr<Chunk const>> chunks(_chunks.size());
+  {
+    std::unique_lock const lock(_mutex);
+    _chunks.swap(chunks);
+  }
+}
+
+VoxelWorldMirror::Chunk const *VoxelWorldMirror::_getChunk(glm::ivec3 chunkIndex) const {
+  if (glm::any(glm::lessThan(chunkIndex, glm::ivec3{0})) ||
+      glm::any(glm::greaterThanEqual(chunkIndex, glm::ivec3{_chunksDim}))) {
+    return nullptr;
+  }
+  size_t const linearIndex = chunkIndex.x + chunkIndex.y * _chunksDim.x +
+                             static_cast<size_t>(chunkIndex.z) * _chunksDim.x * _chunksDim.y;
+  return _chunks[linearIndex].get();
+}
+
+// the bricks are the grandchildren of the root node group, refer chunkIndicesBufferUpdater.comp
+uint64_t VoxelWorldMirror::_computeBrickMask(ChunkOctree const &octree) const {
+  if (_voxelLevelCount < 2) {
+    return ~uint64_t{0};
+  }
+
+  uint64_t brickMask = 0;
+  for (uint32_t i = 0; i < 8; i++) {
+    uint32_t const child = octree.nodes[i];
+    if (child == 0) {
+      continue;
+    }
+    for (uint32_t j = 0; j < 8; j++) {
+      bool const occupied = octree.nodes[(child & kChildPointerMask) + j] != 0;
+      if (!occupied) {
+        continue;
+      }
+      uint32_t const brickX = ((i & 1U) << 1) | (j & 1U);
+      uint32_t const brickY = (i & 2U) | ((j >> 1) & 1U);
+      uint32_t const brickZ = ((i >> 1) & 2U) | ((j >> 2) & 1U);
+      brickMask |= uint64_t{1} << (brickX + brickY * 4 + brickZ * 16);
+    }
+  }
+  return brickMask;
+}
+
+bool VoxelWorldMirror::_hasOccupiedBrick(Chunk const &chunk, glm::ivec3 localVoxelMin,
+                                         glm::ivec3 localVoxelMax) const {
+  if (_voxelLevelCount < 2) {
+    return true;
+  }
+  auto const brickSize      = static_cast<int>(_voxelResolution / 4);
+  glm::ivec3 const brickMin = localVoxelMin / brickSize;
+  glm::ivec3 const brickMax = localVoxelMax / brickSize;
+  for (int z = brickMin.z; z <= brickMax.z; z++) {
+    for (int y = brickMin.y; y <= brickMax.y; y++) {
+      for (int x = brickMin.x; x <= brickMax.x; x++) {
+        if (((chunk.brickMask >> (x + y * 4 + z * 16)) & 1U) != 0) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+// the octants of a node group are ordered x | y << 1 | z << 2, see ChunkOctreeBuilder.cpp
+uint32_t VoxelWorldMirror::_findNode(uint32_t &oBlockType, ChunkOctree const &octree,
+                                     glm::uvec3 localVoxel) const {
+  uint32_t groupIndex = 0;
+  for (uint32_t level = 0; level < _voxelLevelCount; level++) {
+    uint32_t const shift = _voxelLevelCount - 1 - level;
+    uint32_t const octant =
+        ((localVoxel.x >> shift) & 1U) | (((localVoxel.y >> shift) & 1U) << 1) |
+        (((localVoxel.z >> shift) & 1U) << 2);
+    uint32_t const nodeIndex = groupIndex + octant;
+    uint32_t const node      = octree.nodes[nodeIndex];
+
+    if (node == 0) {
+      oBlockType = kBlockTypeEmpty;
+      return 1U << shift;
+    }
+    if ((node & kLeafBits) == kLeafBits) {
+      uint32_t const properties =
+          _separateLeafAttributes ? octree.leafAttributes[nodeIndex] : node & kChildPointerMask;
+      oBlockType = properties & kBlockTypeMask;
+      return 1U << shift;
+    }
+    groupIndex = node & kChildPointerMask;
+  }
+  // not reached for a well formed octree, the leaves are at the last level
+  oBlockType = kBlockTypeEmpty;
+  return 1;
+}
+
+uint32_t VoxelWorldMirror::getVoxel(glm::ivec3 voxel) const {
+  auto const resolution = static_cast<int>(_voxelResolution);
+  glm::ivec3 const chunkIndex{glm::floor(glm::vec3{voxel} / static_cast<float>(resolution))};
+
+  std::shared_lock const lock(_mutex);
+  Chunk const *chunk = _getChunk(chunkIndex);
+  if (chunk == nullptr) {
+    return kBlockTypeEmpty;
+  }
+  uint32_t blockType = kBlockTypeEmpty;
+  _findNode(blockType, chunk->octree, glm::uvec3{voxel - chunkIndex * resolution});
+  return blockType;
+}
+
+bool VoxelWorldMirror::raycast(RaycastHit &oHit, glm::vec3 origin, glm::vec3 direction,
+                               float maxT) const {
+  std::shared_lock const lock(_mutex);
+  return _raycast(oHit, origin, direction, maxT);
+}
+
+void VoxelWorldMirror::raycastBatch(std::vector<RaycastHit> &oHits, std::vector<Ray> const &rays,
+                                    JobSystem *jobSystem) const {
+  oHits.resize(rays.size());
+  auto const castPacket = [this, &oHits, &rays](size_t begin, size_t end) {
+    std::shared_lock const lock(_mutex);
+    for (size_t i = begin; i < end; i++) {
+      _raycast(oHits[i], rays[i].origin, rays[i].direction, rays[i].maxT);
+    }
+  };
+
+  if (jobSystem == nullptr) {
+    castPacket(0, rays.size());
+    return;
+  }
+  jobSystem->parallelFor(0, rays.size(), kRaycastBatchGrainSize, castPacket);
+}
+
+// a hierarchical dda in voxel space, the ray skips the empty chunks and the empty nodes as a
+// whole, the next cell is found from the exit face of the current one, so the cells are stepped
+// exactly, without nudging the ray by an epsilon
+bool VoxelWorldMirror::_raycast(RaycastHit &oHit, glm::vec3 origin, glm::vec3 direction,
+                                float maxT) const {
+  oHit           = {};
+  auto const res = static_cast<float>(_voxelResolution);
+
+  float const directionLength = glm::length(direction);
+  if (directionLength == 0.F) {
+    return false;
+  }
+  glm::vec3 const d = direction / directionLength;
+  glm::vec3 const o = origin * res;
+  float const tMax  = maxT * res;
+
+  glm::ivec3 const worldVoxelDim = glm::ivec3{_chunksDim} * static_cast<int>(_voxelResolution);
+  float tEntry                   = 0.F;
+  float tExit                    = 0.F;
+  int entryAxis                  = -1;
+  if (!_intersectBox(tEntry, tExit, entryAxis, o, d, glm::vec3{0.F}, glm::vec3{worldVoxelDim})) {
+    return false;
+  }
+  float t = std::max(tEntry, 0.F);
+  if (t > tMax) {
+    return false;
+  }
+  // the entry point is on the boundary of the world, so clamping picks the voxel that is entered
+  glm::ivec3 voxel = glm::clamp(glm::ivec3{glm::floor(o + d * t)}, glm::ivec3{0},
+                                worldVoxelDim - 1);
+
+  auto const resolution = static_cast<int>(_voxelResolution);
+  while (true) {
+    glm::ivec3 const chunkIndex = voxel / resolution;
+    Chunk const *chunk          = _getChunk(chunkIndex);
+
+    int cellSize       = resolution;
+    uint32_t blockType = kBlockTypeEmpty;
+    if (chunk != nullptr) {
+      cellSize = static_cast<int>(
+          _findNode(blockType, chunk->octree, glm::uvec3{voxel - chunkIndex * resolution}));
+    }
+
+    if (blockType != kBlockTypeEmpty) {
+      oHit.position  = (o + d * t) / res;
+      oHit.normal    = _getEntryNormal(entryAxis, d);
+      oHit.voxel     = voxel;
+      oHit.blockType = blockType;
+      oHit.t         = t / res;
+      return true;
+    }
+
+    // the cells are aligned to their size
+    glm::ivec3 const cellMin = voxel - voxel % cellSize;
+    float tNext              = kInfinity;
+    int exitAxis             = -1;
+    for (int axis = 0; axis < 3; axis++) {
+      if (d[axis] == 0.F) {
+        continue;
+      }
+      float const boundary =
+          static_cast<float>(d[axis] > 0.F ? cellMin[axis] + cellSize : cellMin[axis]);
+      float const tAxis = (boundary - o[axis]) / d[axis];
+      if (tAxis < tNext) {
+        tNext    = tAxis;
+        exitAxis = axis;
+      }
+    }
+    if (exitAxis < 0 || tNext > tMax) {
+      return false;
+    }
+
+    t = std::max(t, tNext);
+    glm::ivec3 nextVoxel =
+        glm::clamp(glm::ivec3{glm::floor(o + d * t)}, cellMin, cellMin + cellSize - 1);
+    nextVoxel[exitAxis] = d[exitAxis] > 0.F ? cellMin[exitAxis] + cellSize : cellMin[exitAxis] - 1;
+    if (nextVoxel[exitAxis] < 0 || nextVoxel[exitAxis] >= worldVoxelDim[exitAxis]) {
+      return false;
+    }
+    voxel     = nextVoxel;
+    entryAxis = exitAxis;
+  }
+}
+
+// voxelMin and voxelMax are inclusive, the nodes outside of the range are skipped as a whole
+template <typename OverlapTest>
+bool VoxelWorldMirror::_overlap(glm::ivec3 voxelMin, glm::ivec3 voxelMax,
+                                OverlapTest const &overlapsNode,
+                                std::vector<glm::ivec3> *oVoxels) const {
+  auto const resolution          = static_cast<int>(_voxelResolution);
+  glm::ivec3 const worldVoxelDim = glm::ivec3{_chunksDim} * resolution;
+  voxelMin                       = glm::max(voxelMin, glm::ivec3{0});
+  voxelMax                       = glm::min(voxelMax, worldVoxelDim - 1);
+  if (glm::any(glm::greaterThan(voxelMin, voxelMax))) {
+    return false;
+  }
+
+  struct NodeGroup {
+    uint32_t index;
+    glm::ivec3 min;
+    int childSize;
+  };
+  std::vector<NodeGroup> stack{};
+  bool overlapped = false;
+
+  std::shared_lock const lock(_mutex);
+  glm::ivec3 const chunkMin = voxelMin / resolution;
+  glm::ivec3 const chunkMax = voxelMax / resolution;
+  for (int z = chunkMin.z; z <= chunkMax.z; z++) {
+    for (int y = chunkMin.y; y <= chunkMax.y; y++) {
+      for (int x = chunkMin.x; x <= chunkMax.x; x++) {
+        Chunk const *chunk          = _getChunk({x, y, z});
+        glm::ivec3 const chunkVoxel = glm::ivec3{x, y, z} * resolution;
+        if (chunk == nullptr ||
+            !_hasOccupiedBrick(*chunk, glm::max(voxelMin - chunkVoxel, glm::ivec3{0}),
+                               glm::min(voxelMax - chunkVoxel, glm::ivec3{resolution - 1}))) {
+          continue;
+        }
+
+        stack.push_back({0, chunkVoxel, resolution / 2});
+        while (!stack.empty()) {
+          NodeGroup const group = stack.back();
+          stack.pop_back();
+
+          for (uint32_t octant = 0; octant < 8; octant++) {
+            glm::ivec3 const offset{octant & 1U, (octant >> 1) & 1U, (octant >> 2) & 1U};
+            glm::ivec3 const nodeMin = group.min + offset * group.childSize;
+            glm::ivec3 const nodeMax = nodeMin + group.childSize - 1;
+            if (glm::any(glm::lessThan(nodeMax, voxelMin)) ||
+                glm::any(glm::greaterThan(nodeMin, voxelMax)) ||
+                !overlapsNode(glm::vec3{nodeMin}, static_cast<float>(group.childSize))) {
+              continue;
+            }
+
+            uint32_t const node = chunk->octree.nodes[group.index + octant];
+            if (node == 0) {
+              continue;
+            }
+            // the leaves are at the last level, so a leaf is a voxel
+            if ((node & kLeafBits) == kLeafBits) {
+              if (oVoxels == nullptr) {
+                return true;
+              }
+              oVoxels->push_back(nodeMin);
+              overlapped = true;
+              continue;
+            }
+            stack.push_back({node & kChildPointerMask, nodeMin, group.childSize / 2});
+          }
+        }
+      }
+    }
+  }
+  return overlapped;
+}
+
+bool VoxelWorldMirror::overlapSphere(glm::vec3 center, float radius,
+                                     std::vector<glm::ivec3> *oVoxels) const {
+  auto const res              = static_cast<float>(_voxelResolution);
+  glm::vec3 const voxelCenter = center * res;
+  float const voxelRadius     = radius * res;
+  auto const overlapsNode     = [voxelCenter, voxelRadius](glm::vec3 nodeMin, float nodeSize) {
+    glm::vec3 const closest = glm::clamp(voxelCenter, nodeMin, nodeMin + nodeSize);
+    glm::vec3 const offset  = closest - voxelCenter;
+    return glm::dot(offset, offset) <= voxelRadius * voxelRadius;
+  };
+  return _overlap(glm::ivec3{glm::floor(voxelCenter - voxelRadius)},
+                  glm::ivec3{glm::floor(voxelCenter + voxelRadius)}, overlapsNode, oVoxels);
+}
+
+// a voxel overlaps the box if they share a volume, touching faces do not count
+bool VoxelWorldMirror::overlapBox(glm::vec3 boxMin, glm::vec3 boxMax,
+                                  std::vector<glm::ivec3> *oVoxels) const {
+  auto const res          = static_cast<float>(_voxelResolution);
+  auto const overlapsNode = [](glm::vec3 /*nodeMin*/, float /*nodeSize*/) { return true; };
+  return _overlap(glm::ivec3{glm::floor(boxMin * res)}, glm::ivec3{glm::ceil(boxMax * res)} - 1,
+                  overlapsNode, oVoxels);
+}
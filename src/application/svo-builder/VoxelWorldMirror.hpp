@@ -0,0 +1,106 @@
+#pragma once
+
+#include "ChunkOctreeBuilder.hpp"
+
+#include "glm/glm.hpp" // IWYU pragma: export
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+class JobSystem;
+
+// a cpu copy of the chunk octrees, in the layout of the chunk octree buffer, so the world can be
+// queried without a round trip to the gpu, SvoBuilder sets a chunk whenever it appends one, the
+// queries can be made from any thread, the positions are in world space, where a chunk spans one
+// unit, and the voxels are in world voxel coordinates, the chunk index times the chunk resolution
+// plus the voxel in the chunk
+class VoxelWorldMirror {
+public:
+  struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    float maxT;
+  };
+
+  struct RaycastHit {
+    // where the ray enters the voxel
+    glm::vec3 position;
+    // the axis aligned normal of the face that is entered
+    glm::vec3 normal;
+    glm::ivec3 voxel;
+    // 0 if the ray missed, the voxels of the octrees are never empty
+    uint32_t blockType;
+    // in world units along the normalized direction
+    float t;
+  };
+
+  VoxelWorldMirror(uint32_t voxelResolution, glm::uvec3 chunksDim, bool separateLeafAttributes);
+
+  // disable copy and move
+  VoxelWorldMirror(VoxelWorldMirror const &)            = delete;
+  VoxelWorldMirror(VoxelWorldMirror &&)                 = delete;
+  VoxelWorldMirror &operator=(VoxelWorldMirror const &) = delete;
+  VoxelWorldMirror &operator=(VoxelWorldMirror &&)      = delete;
+
+  // an empty octree removes the chunk
+  void setChunk(glm::uvec3 chunkIndex, ChunkOctree octree);
+  void clear();
+
+  // the block type of the voxel, 0 if it is empty or out of the world
+  [[nodiscard]] uint32_t getVoxel(glm::ivec3 voxel) const;
+
+  // the first voxel along the ray within maxT, the direction does not need to be normalized
+  bool raycast(RaycastHit &oHit, glm::vec3 origin, glm::vec3 direction, float maxT) const;
+
+  // oHits has a hit per ray, the rays are spread over the job system in packets, the job system
+  // is optional
+  void raycastBatch(std::vector<RaycastHit> &oHits, std::vector<Ray> const &rays,
+                    JobSystem *jobSystem) const;
+
+  // returns whether any voxel overlaps the sphere, the overlapping voxels are collected when
+  // oVoxels is given, otherwise the search stops at the first one
+  bool overlapSphere(glm::vec3 center, float radius,
+                     std::vector<glm::ivec3> *oVoxels = nullptr) const;
+
+  // the same as overlapSphere, for a world space box, the voxels that only touch the box do not
+  // overlap it
+  bool overlapBox(glm::vec3 boxMin, glm::vec3 boxMax,
+                  std::vector<glm::ivec3> *oVoxels = nullptr) const;
+
+  [[nodiscard]] uint32_t getVoxelResolution() const { return _voxelResolution; }
+
+private:
+  uint32_t _voxelResolution;
+  uint32_t _voxelLevelCount;
+  glm::uvec3 _chunksDim;
+  bool _separateLeafAttributes;
+
+  struct Chunk {
+    ChunkOctree octree;
+    // the 4x4x4 bricks of the chunk that hold voxels, the same as the chunk brick mask buffer of
+    // the tracer, the overlap queries test them before they descend the octree
+    uint64_t brickMask;
+  };
+
+  // the queries share the lock, the chunks are swapped in under the exclusive lock
+  mutable std::shared_mutex _mutex;
+  // indexed by the linear chunk index, null for the empty and the unbuilt chunks
+  std::vector<std::unique_ptr<Chunk const>> _chunks;
+
+  [[nodiscard]] Chunk const *_getChunk(glm::ivec3 chunkIndex) const;
+  [[nodiscard]] uint64_t _computeBrickMask(ChunkOctree const &octree) const;
+  // whether any brick of the chunk in the inclusive range of the local voxels holds voxels
+  [[nodiscard]] bool _hasOccupiedBrick(Chunk const &chunk, glm::ivec3 localVoxelMin,
+                                       glm::ivec3 localVoxelMax) const;
+  // the size in voxels of the deepest node that holds the voxel, the block type is 0 if the node
+  // is empty
+  uint32_t _findNode(uint32_t &oBlockType, ChunkOctree const &octree, glm::uvec3 localVoxel) const;
+  bool _raycast(RaycastHit &oHit, glm::vec3 origin, glm::vec3 direction, float maxT) const;
+  // the overlap test of a node is given in voxel space, the children are only visited if it
+  // passes
+  template <typename OverlapTest>
+  bool _overlap(glm::ivec3 voxelMin, glm::ivec3 voxelMax, OverlapTest const &overlapsNode,
+                std::vector<glm::ivec3> *oVoxels) const;
+};
@@ -0,0 +1,86 @@
+#include "WideTreeBuilder.hpp"
+
+#include <array>
+#include <cassert>
+
+namespace {
+
+uint32_t constexpr kHasChildBit      = 0x80000000U;
+uint32_t constexpr kLeafBit          = 0x40000000U;
+uint32_t constexpr kChildPointerMask = 0x3FFFFFFFU;
+
+uint32_t constexpr kWideNodeSize = 3;
+
+// gathers the 4x4x4 grandchildren of an octree node group, indexed by x + y * 4 + z * 16
+std::array<uint32_t, 64> _gatherCells(uint32_t const *octreeNodes, size_t octreeNodeCount,
+                                      uint32_t groupIndex) {
+  std::array<uint32_t, 64> cells{};
+  for (uint32_t i = 0; i < 8; i++) {
+    assert(groupIndex + i < octreeNodeCount && "octree node is out of range");
+    uint32_t const child = octreeNodes[groupIndex + i];
+    if ((child & kHasChildBit) == 0) {
+      continue;
+    }
+    // the builder only creates leaves at the last level
+    assert((child & kLeafBit) == 0 && "unexpected leaf in the middle of the octree");
+
+    uint32_t const grandChildGroup = child & kChildPointerMask;
+    for (uint32_t j = 0; j < 8; j++) {
+      assert(grandChildGroup + j < octreeNodeCount && "octree node is out of range");
+      // the octree child index is x | y << 1 | z << 2
+      uint32_t const x = ((i & 1U) << 1) | (j & 1U);
+      uint32_t const y = (i & 2U) | ((j >> 1) & 1U);
+      uint32_t const z = ((i >> 1) & 2U) | ((j >> 2) & 1U);
+      cells[x + y * 4 + z * 16] = octreeNodes[grandChildGroup + j];
+    }
+  }
+  return cells;
+}
+
+// fills the node at nodeIndex, whose cells are the grandchildren of the octree group
+void _buildNode(std::vector<uint32_t> &wideTree, uint32_t const *octreeNodes,
+                size_t octreeNodeCount, uint32_t nodeIndex, uint32_t groupIndex,
+                uint32_t remainingLevels) {
+  auto const cells = _gatherCells(octreeNodes, octreeNodeCount, groupIndex);
+
+  uint64_t childMask  = 0;
+  uint32_t childCount = 0;
+  for (uint32_t bit = 0; bit < 64; bit++) {
+    if ((cells[bit] & kHasChildBit) != 0) {
+      childMask |= 1ULL << bit;
+      childCount++;
+    }
+  }
+
+  bool const isLastLevel   = remainingLevels == 1;
+  auto const firstChild    = static_cast<uint32_t>(wideTree.size());
+  wideTree[nodeIndex]      = static_cast<uint32_t>(childMask);
+  wideTree[nodeIndex + 1]  = static_cast<uint32_t>(childMask >> 32);
+  wideTree[nodeIndex + 2]  = firstChild;
+  wideTree.resize(wideTree.size() + childCount * (isLastLevel ? 1 : kWideNodeSize));
+
+  uint32_t rank = 0;
+  for (uint32_t bit = 0; bit < 64; bit++) {
+    if ((childMask & (1ULL << bit)) == 0) {
+      continue;
+    }
+    if (isLastLevel) {
+      wideTree[firstChild + rank] = cells[bit];
+    } else {
+      _buildNode(wideTree, octreeNodes, octreeNodeCount, firstChild + rank * kWideNodeSize,
+                 cells[bit] & kChildPointerMask, remainingLevels - 1);
+    }
+    rank++;
+  }
+}
+
+} // namespace
+
+std::vector<uint32_t> buildWideTreeFromOctree(uint32_t const *octreeNodes, size_t octreeNodeCount,
+                                              uint32_t voxelLevelCount) {
+  assert(voxelLevelCount % 2 == 0 && "the 64-tree requires an even octree level count");
+
+  std::vector<uint32_t> wideTree(kWideNodeSize, 0);
+  _buildNode(wideTree, octreeNodes, octreeNodeCount, 0, 0, voxelLevelCount / 2);
+  return wideTree;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// converts a chunk octree into the sparse 64-tree layout that is traced by wideTreeMarching.glsl
+
+// the octree is the one produced by the svo builder, with the root node group at index 0 and child
+// pointers relative to the start of the chunk, voxelLevelCount must be even
+
+// every node of the 64-tree takes 3 words: the 64 bit child mask (low, high) and the pointer to the
+// first child, the existing children are compacted, nodes of the last level point to the voxels,
+// which are the octree leaves as is, the root node is at index 0
+std::vector<uint32_t> buildWideTreeFromOctree(uint32_t const *octreeNodes, size_t octreeNodeCount,
+                                              uint32_t voxelLevelCount);
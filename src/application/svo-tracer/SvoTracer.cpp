@@ -7,18 +7,24 @@
 #include "file-watcher/ShaderChangeListener.hpp"
 #include "utils/config/RootDir.h"
 #include "utils/io/ShaderFileReader.hpp"
+#include "utils/io/TextureArrayBlob.hpp"
 #include "utils/logger/Logger.hpp"
 #include "vulkan-wrapper/descriptor-set/DescriptorSetBundle.hpp"
 #include "vulkan-wrapper/memory/Buffer.hpp"
 #include "vulkan-wrapper/memory/BufferBundle.hpp"
+#include "vulkan-wrapper/memory/DynamicUniformBuffer.hpp"
 #include "vulkan-wrapper/memory/Image.hpp"
 #include "vulkan-wrapper/pipeline/ComputePipeline.hpp"
+#include "vulkan-wrapper/render-graph/RenderGraph.hpp"
 #include "vulkan-wrapper/sampler/Sampler.hpp"
 
 #include "config-container/ConfigContainer.hpp"
 #include "config-container/sub-config/SvoTracerInfo.hpp"
 #include "config-container/sub-config/SvoTracerTweakingInfo.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 // should also be synchronized with the shader
@@ -29,6 +35,18 @@ constexpr uint32_t kMultiScatteringLutHeight = 32;
 constexpr uint32_t kSkyViewLutWidth          = 200;
 constexpr uint32_t kSkyViewLutHeight         = 200;
 
+// should be synchronized with wavefront.glsl
+constexpr uint32_t kWavefrontIndirectQueue = 0;
+constexpr uint32_t kWavefrontShadowQueue   = 1;
+constexpr uint32_t kWavefrontQueueCount    = 2;
+// a pixel queues at most one indirect ray and two shadow rays
+constexpr uint32_t kWavefrontRaysPerPixel = 3;
+// a bin per direction octant and origin chunk
+constexpr uint32_t kWavefrontOctantCount = 8;
+
+// should be synchronized with adaptiveSampling.glsl
+constexpr uint32_t kAdaptiveTileSize = 8;
+
 namespace {
 float halton(int base, int index) {
   float f = 1.F;
@@ -47,6 +65,22 @@ std::string _makeShaderFullPath(std::string const &shaderName) {
   return kPathToResourceFolder + "shaders/svo-tracer/" + shaderName;
 }
 
+// the ids are declared in svoTracerSpecializationConstants.glsl
+SpecializationConstants _makeSpecializationConstants(SvoTracerTweakingInfo const &td) {
+  return {
+      {0, static_cast<uint32_t>(td.debugB1)},
+      {1, static_cast<uint32_t>(td.debugI1)},
+      {2, static_cast<uint32_t>(td.visualizeChunks)},
+      {3, static_cast<uint32_t>(td.visualizeOctree)},
+      {4, static_cast<uint32_t>(td.beamOptimization)},
+      {5, static_cast<uint32_t>(td.traceIndirectRay)},
+      {6, static_cast<uint32_t>(td.taa)},
+      {7, static_cast<uint32_t>(td.wavefrontTracing)},
+      {8, static_cast<uint32_t>(td.radianceCache)},
+      {9, static_cast<uint32_t>(td.adaptiveSampling)},
+  };
+}
+
 // translated from shader code
 double constexpr kPi = 3.14159265358979323846;
 
@@ -68,10 +102,11 @@ glm::vec3 _getSunDir(float sunAltitude, float sunAzimuth) {
 
 SvoTracer::SvoTracer(VulkanApplicationContext *appContext, Logger *logger, size_t framesInFlight,
                      Window *window, ShaderCompiler *shaderCompiler,
-                     ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer)
+                     ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer,
+                     JobSystem *jobSystem)
     : _appContext(appContext), _logger(logger), _window(window), _shaderCompiler(shaderCompiler),
       _shaderChangeListener(shaderChangeListener), _configContainer(configContainer),
-      _framesInFlight(framesInFlight) {
+      _jobSystem(jobSystem), _framesInFlight(framesInFlight) {
   _camera          = std::make_unique<Camera>(_window, configContainer);
   _shadowMapCamera = std::make_unique<ShadowMapCamera>(configContainer);
 
@@ -100,18 +135,42 @@ void SvoTracer::_updateImageResolutions() {
   _logger->info("rendering res: {}x{}", _lowResWidth, _lowResHeight);
 }
 
+uint32_t SvoTracer::_getBeamResolutionWidth() const {
+  return static_cast<uint32_t>(
+             std::ceil(static_cast<float>(_lowResWidth) /
+                       static_cast<float>(_configContainer->svoTracerInfo->beamResolution))) +
+         1;
+}
+
+uint32_t SvoTracer::_getBeamResolutionHeight() const {
+  return static_cast<uint32_t>(
+             std::ceil(static_cast<float>(_lowResHeight) /
+                       static_cast<float>(_configContainer->svoTracerInfo->beamResolution))) +
+         1;
+}
+
 void SvoTracer::init(SvoBuilder *svoBuilder) {
   _svoBuilder = svoBuilder;
 
   _createSamplers();
 
+  // the toggles decide the passes that are recorded, and the buffers that are allocated
+  _wavefrontTracing = _configContainer->svoTracerTweakingInfo->wavefrontTracing;
+  _radianceCache    = _configContainer->svoTracerTweakingInfo->radianceCache;
+  _adaptiveSampling = _configContainer->svoTracerTweakingInfo->adaptiveSampling;
+
   // images
   _createImages();
   _createImageForwardingPairs();
 
   // buffers
-  _createBuffersAndBufferBundles();
+  _createBuffers();
   _initBufferData();
+  _createWavefrontBuffers();
+  _createAdaptiveSamplingBuffers();
+
+  // binds the memory of the transient images, so it goes before the descriptor sets
+  _createRenderGraph();
 
   // pipelines
   _createDescriptorSetBundle();
@@ -135,6 +194,12 @@ void SvoTracer::onSwapchainResize() {
   _createSwapchainRelatedImages();
   _createImageForwardingPairs();
 
+  // the queues and the tiles are sized by the rendering resolution
+  _createWavefrontBuffers();
+  _createAdaptiveSamplingBuffers();
+
+  _createRenderGraph();
+
   // pipelines
   _createDescriptorSetBundle();
   _updatePipelinesDescriptorBundles();
@@ -151,7 +216,53 @@ void SvoTracer::_createTaaSamplingOffsets() {
   }
 }
 
-void SvoTracer::onPipelineRebuilt() { _recordRenderingCommandBuffers(); }
+void SvoTracer::onPipelineRebuilt() {
+  _shadowMapValid = false;
+  _recordRenderingCommandBuffers();
+}
+
+void SvoTracer::onTweakableTogglesChanged() {
+  SpecializationConstants const specializationConstants =
+      _makeSpecializationConstants(*_configContainer->svoTracerTweakingInfo);
+  bool const wavefrontTracing = _configContainer->svoTracerTweakingInfo->wavefrontTracing;
+  bool const radianceCache    = _configContainer->svoTracerTweakingInfo->radianceCache;
+  bool const adaptiveSampling = _configContainer->svoTracerTweakingInfo->adaptiveSampling;
+
+  bool variantChanged = false;
+  for (ComputePipeline *pipeline :
+       {_transmittanceLutPipeline.get(), _multiScatteringLutPipeline.get(),
+        _skyViewLutPipeline.get(), _shadowMapPipeline.get(), _svoCourseBeamPipeline.get(),
+        _svoTracingPipeline.get(), _godRayPipeline.get(), _temporalFilterPipeline.get(),
+        _aTrousPipeline.get(), _backgroundBlitPipeline.get(), _taaUpscalingPipeline.get(),
+        _postProcessingPipeline.get(), _wavefrontBinCountPipeline.get(),
+        _wavefrontBinScanPipeline.get(), _wavefrontBinScatterPipeline.get(),
+        _wavefrontIndirectRayPipeline.get(), _wavefrontShadowRayPipeline.get(),
+        _wavefrontResolvePipeline.get(), _radianceCacheUpdatePipeline.get(),
+        _tileClassifyPipeline.get(), _svoShadingPipeline.get()}) {
+    variantChanged |= pipeline->setSpecializationConstants(specializationConstants);
+  }
+  if (variantChanged) {
+    _shadowMapValid = false;
+  }
+
+  // the render graph only compares the buffers when it is compiled, so the ray buffers are
+  // replaced without compiling it again, only the descriptor sets point to them
+  bool const wavefrontTracingChanged = wavefrontTracing != _wavefrontTracing;
+  if (wavefrontTracingChanged) {
+    _wavefrontTracing = wavefrontTracing;
+    _createWavefrontRayBuffers();
+    _createDescriptorSetBundle();
+    _updatePipelinesDescriptorBundles();
+  }
+
+  // the passes are enabled by the toggles, so they are recorded again as well
+  if (variantChanged || wavefrontTracingChanged || radianceCache != _radianceCache ||
+      adaptiveSampling != _adaptiveSampling) {
+    _radianceCache    = radianceCache;
+    _adaptiveSampling = adaptiveSampling;
+    _recordRenderingCommandBuffers();
+  }
+}
 
 void SvoTracer::_createSamplers() {
   {
@@ -183,17 +294,32 @@ void SvoTracer::_createSwapchainRelatedImages() { _createFullSizedImages(); }
 
 void SvoTracer::_createBlueNoiseImages() {
   auto _loadNoise = [this](std::unique_ptr<Image> &noiseImage, std::string const &&stbnPath) {
-    _logger->info("loading blue noise images from {}", stbnPath);
-
     constexpr int kBlueNoiseArraySize = 64;
+    constexpr VkImageUsageFlags kUsage =
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    // packed by the texture-array-packer app, the pngs are only decoded if it is missing
+    std::string const blobPath =
+        kPathToResourceFolder + "/textures/stbn/" + stbnPath + "array.bin";
+    auto const blob = TextureArrayBlob::map(blobPath, _logger);
+    if (blob != nullptr && blob->getHeader().layerCount == kBlueNoiseArraySize &&
+        blob->getHeader().bytesPerPixel == 4) {
+      TextureArrayBlob::Header const &header = blob->getHeader();
+      _logger->info("loading blue noise array from {}", blobPath);
+      noiseImage = std::make_unique<Image>(
+          _appContext, ImageDimensions{header.width, header.height}, header.layerCount,
+          VK_FORMAT_R8G8B8A8_UNORM, blob->getData(), kUsage);
+      return;
+    }
+
+    _logger->info("loading blue noise images from {}", stbnPath);
     std::vector<std::string> filenames{};
     filenames.reserve(kBlueNoiseArraySize);
     for (int i = 0; i < kBlueNoiseArraySize; i++) {
       filenames.emplace_back(kPathToResourceFolder + "/textures/stbn/" + stbnPath +
                              std::to_string(i) + ".png");
     }
-    noiseImage = std::make_unique<Image>(
-        _appContext, filenames, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    noiseImage = std::make_unique<Image>(_appContext, filenames, _jobSystem, kUsage);
   };
 
   _loadNoise(_scalarBlueNoise, "scalar_2d_1d_1d/stbn_scalar_2Dx1Dx1D_128x128x64x1_");
@@ -230,57 +356,52 @@ void SvoTracer::_createShadowMapImage() {
 }
 
 // https://docs.vulkan.org/spec/latest/chapters/formats.html
+// the images that do not carry data to the next frame are transient, their memory is bound by the
+// render graph, and shared between the images that are never alive at the same time
 void SvoTracer::_createFullSizedImages() {
   // the sky hdr view is very sensitive to gradient, so a high precision format is a must
   _backgroundImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
+      Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                 VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
 
   // w = 16 -> 3, w = 17 -> 4
-  _beamDepthImage = std::make_unique<Image>(
-      _appContext,
-      ImageDimensions{
-          static_cast<uint32_t>(
-              std::ceil(static_cast<float>(_lowResWidth) /
-                        static_cast<float>(_configContainer->svoTracerInfo->beamResolution)) +
-              1),
-          static_cast<uint32_t>(
-              std::ceil(static_cast<float>(_lowResHeight) /
-                        static_cast<float>(_configContainer->svoTracerInfo->beamResolution)) +
-              1)},
+  _beamDepthImage = Image::createWithoutMemory(
+      _appContext, ImageDimensions{_getBeamResolutionWidth(), _getBeamResolutionHeight()},
       VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
 
-  _rawImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                      VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _rawImage = Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                         VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
 
   _instantImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
+      Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                 VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
 
-  _depthImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                        VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _depthImage =
+      Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                 VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
 
-  _octreeVisualizationImage = std::make_unique<Image>(
+  _octreeVisualizationImage = Image::createWithoutMemory(
       _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_B10G11R11_UFLOAT_PACK32,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
-  _hitImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                      VK_FORMAT_R8_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _hitImage = Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                         VK_FORMAT_R8_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
 
   _temporalHistLengthImage =
       std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
                               VK_FORMAT_R8_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
 
-  _motionImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                         VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
-  _normalImage = std::make_unique<Image>(
+  _motionImage =
+      Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                 VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _normalImage = Image::createWithoutMemory(
       _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
   _lastNormalImage = std::make_unique<Image>(
       _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
-  _positionImage = std::make_unique<Image>(
+  _positionImage = Image::createWithoutMemory(
       _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32G32B32A32_SFLOAT,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
 
@@ -288,7 +409,7 @@ void SvoTracer::_createFullSizedImages() {
       _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32G32B32A32_SFLOAT,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
-  _voxHashImage = std::make_unique<Image>(
+  _voxHashImage = Image::createWithoutMemory(
       _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
   _lastVoxHashImage = std::make_unique<Image>(
@@ -298,7 +419,7 @@ void SvoTracer::_createFullSizedImages() {
   // precision issues occurred when using VK_FORMAT_B10G11R11_UFLOAT_PACK32 to store hdr accumed
   // results, it can be observed when using a very low alpha blending value.
   // so either use VK_FORMAT_R32_UINT with custom RGBE packer / unpacker
-  _accumedImage = std::make_unique<Image>(
+  _accumedImage = Image::createWithoutMemory(
       _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
   _lastAccumedImage = std::make_unique<Image>(
@@ -314,26 +435,27 @@ void SvoTracer::_createFullSizedImages() {
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
   // same for taa images, use VK_FORMAT_R16G16B16A16_SFLOAT to enable accelerated sampling
-  _taaImage = std::make_unique<Image>(_appContext, ImageDimensions{_highResWidth, _highResHeight},
-                                      VK_FORMAT_R16G16B16A16_SFLOAT,
-                                      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+  _taaImage = Image::createWithoutMemory(
+      _appContext, ImageDimensions{_highResWidth, _highResHeight}, VK_FORMAT_R16G16B16A16_SFLOAT,
+      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
   _lastTaaImage = std::make_unique<Image>(
       _appContext, ImageDimensions{_highResWidth, _highResHeight}, VK_FORMAT_R16G16B16A16_SFLOAT,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
       _defaultSampler->getVkSampler());
 
-  _blittedImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                          VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _blittedImage =
+      Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                 VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
 
   // both of the ping and pong can be dumped to the render target image and the lastAccumedImage
   _aTrousPingImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
+      Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                 VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
 
   // also serves as the output image
   _aTrousPongImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
+      Image::createWithoutMemory(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+                                 VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
 
   _renderTargetImage = std::make_unique<Image>(
       _appContext, ImageDimensions{_highResWidth, _highResHeight},
@@ -379,59 +501,129 @@ void SvoTracer::_createImageForwardingPairs() {
 
 // these buffers are modified by the CPU side every frame, and we have multiple frames in flight,
 // so we need to create multiple copies of them, they are fairly small though
-void SvoTracer::_createBuffersAndBufferBundles() {
+void SvoTracer::_createBuffers() {
   // buffers
   _sceneInfoBuffer =
       std::make_unique<Buffer>(_appContext, sizeof(G_SceneInfo), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                                MemoryStyle::kDedicated);
 
-  _aTrousIterationBuffer = std::make_unique<Buffer>(_appContext, sizeof(uint32_t),
-                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                    MemoryStyle::kDedicated);
+  _outputInfoBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_OutputInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
 
-  _aTrousIterationStagingBuffers.clear();
-  _aTrousIterationStagingBuffers.reserve(_configContainer->svoTracerInfo->aTrousSizeMax);
-  for (int i = 0; i < _configContainer->svoTracerInfo->aTrousSizeMax; i++) {
-    _aTrousIterationStagingBuffers.emplace_back(std::make_unique<Buffer>(
-        _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryStyle::kDedicated));
-  }
+  // one slice per frame in flight, selected by dynamic offsets
+  _renderInfoUniformBuffer =
+      std::make_unique<DynamicUniformBuffer>(_appContext, _framesInFlight, sizeof(G_RenderInfo));
+
+  _environmentInfoUniformBuffer = std::make_unique<DynamicUniformBuffer>(
+      _appContext, _framesInFlight, sizeof(G_EnvironmentInfo));
+
+  _tweakableParametersUniformBuffer = std::make_unique<DynamicUniformBuffer>(
+      _appContext, _framesInFlight, sizeof(G_TweakableParameters));
+
+  _temporalFilterInfoUniformBuffer = std::make_unique<DynamicUniformBuffer>(
+      _appContext, _framesInFlight, sizeof(G_TemporalFilterInfo));
+
+  _spatialFilterInfoUniformBuffer = std::make_unique<DynamicUniformBuffer>(
+      _appContext, _framesInFlight, sizeof(G_SpatialFilterInfo));
+
+  // the output info is copied here at the end of each frame, and read once the frame has completed
+  _outputInfoReadbackBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_OutputInfo),
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryStyle::kHostVisible);
+
+  _radianceCacheBuffer = std::make_unique<Buffer>(
+      _appContext,
+      static_cast<VkDeviceSize>(_configContainer->svoTracerInfo->radianceCacheSize) *
+          sizeof(G_RadianceCacheEntry),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  // written by the CPU every frame, so it is host visible
+  _shadowMapUpdateBuffer = std::make_unique<Buffer>(
+      _appContext, _framesInFlight * sizeof(G_ShadowMapUpdateInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+      MemoryStyle::kHostVisible);
+}
 
-  _outputInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_OutputInfo),
+// the rays are queued by svoTracing, then binned and traced by the wavefront passes
+void SvoTracer::_createWavefrontBuffers() {
+  VkDeviceSize const pixelCount = static_cast<VkDeviceSize>(_lowResWidth) * _lowResHeight;
+  glm::uvec3 const chunksDim    = _svoBuilder->getChunksDim();
+  VkDeviceSize const binCount =
+      kWavefrontOctantCount * static_cast<VkDeviceSize>(chunksDim.x * chunksDim.y * chunksDim.z);
+
+  _createWavefrontRayBuffers();
+
+  // also holds the indirect dispatch arguments of the tracing kernels
+  _wavefrontQueueInfoBuffer = std::make_unique<Buffer>(
+      _appContext, kWavefrontQueueCount * sizeof(G_WavefrontQueueInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+
+  _wavefrontBinBuffer = std::make_unique<Buffer>(
+      _appContext, kWavefrontQueueCount * binCount * sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+
+  _wavefrontPixelBuffer =
+      std::make_unique<Buffer>(_appContext, pixelCount * sizeof(G_WavefrontPixel),
                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+}
+
+// the ray queues are the largest buffers of the tracer, they are only sized by the resolution
+// while the wavefront tracing is enabled, otherwise a single ray keeps the bindings valid
+void SvoTracer::_createWavefrontRayBuffers() {
+  VkDeviceSize const rayCount =
+      _wavefrontTracing
+          ? kWavefrontRaysPerPixel * static_cast<VkDeviceSize>(_lowResWidth) * _lowResHeight
+          : 1;
 
-  // buffer bundles
-  _renderInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_RenderInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+  _wavefrontRayBuffer =
+      std::make_unique<Buffer>(_appContext, rayCount * sizeof(G_WavefrontRay),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
-  _environmentInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_EnvironmentInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+  _wavefrontSortedRayBuffer =
+      std::make_unique<Buffer>(_appContext, rayCount * sizeof(G_WavefrontRay),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+}
 
-  _tweakableParametersBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_TweakableParameters),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+void SvoTracer::_createAdaptiveSamplingBuffers() {
+  VkDeviceSize const tileCount =
+      static_cast<VkDeviceSize>((_lowResWidth + kAdaptiveTileSize - 1) / kAdaptiveTileSize) *
+      ((_lowResHeight + kAdaptiveTileSize - 1) / kAdaptiveTileSize);
 
-  _temporalFilterInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_TemporalFilterInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+  _tileSampleCountBuffer =
+      std::make_unique<Buffer>(_appContext, tileCount * sizeof(uint32_t),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
-  _spatialFilterInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_SpatialFilterInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+  _tileListBuffer =
+      std::make_unique<Buffer>(_appContext, tileCount * sizeof(uint32_t),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _tileDispatchBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_TileDispatchInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
 }
 
 void SvoTracer::_initBufferData() {
   G_SceneInfo sceneData = {_configContainer->svoTracerInfo->beamResolution,
-                           _svoBuilder->getVoxelLevelCount(), _svoBuilder->getChunksDim()};
+                           _svoBuilder->getVoxelLevelCount(), _svoBuilder->getChunksDim(),
+                           _svoBuilder->isDagCompressed() ? 1U : 0U};
   _sceneInfoBuffer->fillData(&sceneData);
 
-  for (uint32_t i = 0; i < _configContainer->svoTracerInfo->aTrousSizeMax; i++) {
-    uint32_t aTrousIteration = i;
-    _aTrousIterationStagingBuffers[i]->fillData(&aTrousIteration);
+  // so the frames that have not been rendered yet are not read as valid stats
+  G_OutputInfo const outputInfo{};
+  for (size_t i = 0; i < _framesInFlight; i++) {
+    _outputInfoReadbackBufferBundle->getBuffer(i)->fillData(&outputInfo);
   }
+
+  // all the entries start empty
+  _radianceCacheBuffer->fillData();
 }
 
 void SvoTracer::_recordRenderingCommandBuffers() {
@@ -450,155 +642,377 @@ void SvoTracer::_recordRenderingCommandBuffers() {
 
   vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, _tracingCommandBuffers.data());
 
-  VkMemoryBarrier uboWritingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
-  uboWritingBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-  uboWritingBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-  // create the general memory barrier
-  VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
-  memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-  memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-
   for (uint32_t frameIndex = 0; frameIndex < _tracingCommandBuffers.size(); frameIndex++) {
     auto &cmdBuffer = _tracingCommandBuffers[frameIndex];
 
     VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
     vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
-    // make all host writes to the ubo visible to the shaders
-    vkCmdPipelineBarrier(cmdBuffer,
-                         VK_PIPELINE_STAGE_HOST_BIT,           // source stage
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // destination stage
-                         0,                                    // dependency flags
-                         1,                                    // memory barrier count
-                         &uboWritingBarrier,                   // memory barriers
-                         0,                                    // buffer memory barrier count
-                         nullptr,                              // buffer memory barriers
-                         0,                                    // image memory barrier count
-                         nullptr                               // image memory barriers
-    );
-
-    // _renderTargetImage->clearImage(cmdBuffer);
-    _transmittanceLutPipeline->recordCommand(cmdBuffer, frameIndex, kTransmittanceLutWidth,
-                                             kTransmittanceLutHeight, 1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    _multiScatteringLutPipeline->recordCommand(cmdBuffer, frameIndex, kMultiScatteringLutWidth,
-                                               kMultiScatteringLutHeight, 1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    _skyViewLutPipeline->recordCommand(cmdBuffer, frameIndex, kSkyViewLutWidth, kSkyViewLutHeight,
-                                       1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    _shadowMapPipeline->recordCommand(cmdBuffer, frameIndex,
-                                      _configContainer->svoTracerInfo->shadowMapResolution,
-                                      _configContainer->svoTracerInfo->shadowMapResolution, 1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    _svoCourseBeamPipeline->recordCommand(
-        cmdBuffer, frameIndex,
-        static_cast<uint32_t>(
-            std::ceil(static_cast<float>(_lowResWidth) /
-                      static_cast<float>(_configContainer->svoTracerInfo->beamResolution))) +
-            1,
-        static_cast<uint32_t>(
-            std::ceil(static_cast<float>(_lowResHeight) /
-                      static_cast<float>(_configContainer->svoTracerInfo->beamResolution))) +
-            1,
-        1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    _svoTracingPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    _godRayPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    _temporalFilterPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
-
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
-
-    for (int i = 0; i < _configContainer->svoTracerInfo->aTrousSizeMax; i++) {
-      VkBufferCopy bufCopy = {
-          0,                                 // srcOffset
-          0,                                 // dstOffset,
-          _aTrousIterationBuffer->getSize(), // size
-      };
-
-      vkCmdCopyBuffer(cmdBuffer, _aTrousIterationStagingBuffers[i]->getVkBuffer(),
-                      _aTrousIterationBuffer->getVkBuffer(), 1, &bufCopy);
-
-      VkMemoryBarrier bufferCopyMemoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
-      bufferCopyMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-      bufferCopyMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-      vkCmdPipelineBarrier(cmdBuffer,
-                           VK_PIPELINE_STAGE_TRANSFER_BIT,       // source stage
-                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // destination stage
-                           0,                                    // dependency flags
-                           1,                                    // memory barrier count
-                           &bufferCopyMemoryBarrier,             // memory barriers
-                           0,                                    // buffer memory barrier count
-                           nullptr,                              // buffer memory barriers
-                           0,                                    // image memory barrier count
-                           nullptr                               // image memory barriers
-      );
-
-      _aTrousPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
-
-      vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr,
-                           0, nullptr);
-    }
+    // the barriers between the passes, including the one for the host writes to the ubo, are
+    // emitted by the render graph
+    _renderGraph->record(cmdBuffer, frameIndex);
 
-    _backgroundBlitPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+    vkEndCommandBuffer(cmdBuffer);
+  }
+}
 
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
+void SvoTracer::_createRenderGraph() {
+  _renderGraph = std::make_unique<RenderGraph>(_appContext, _logger);
 
-    _taaUpscalingPipeline->recordCommand(cmdBuffer, frameIndex, _highResWidth, _highResHeight, 1);
+  for (Image *image :
+       {_backgroundImage.get(), _beamDepthImage.get(), _rawImage.get(), _instantImage.get(),
+        _depthImage.get(), _octreeVisualizationImage.get(), _hitImage.get(), _motionImage.get(),
+        _normalImage.get(), _positionImage.get(), _voxHashImage.get(), _accumedImage.get(),
+        _taaImage.get(), _blittedImage.get(), _aTrousPingImage.get(), _aTrousPongImage.get()}) {
+    _renderGraph->addTransientImage(image);
+  }
 
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
+  // the passes are declared in the order of the original recording, the graph only reorders the
+  // independent ones
+  _renderGraph->addPass({"transmittanceLut",
+                         RenderGraph::Stage::kCompute,
+                         {_transmittanceLutImage.get()},
+                         {_transmittanceLutImage.get()},
+                         [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+                           _transmittanceLutPipeline->recordCommand(cmdBuffer, frameIndex,
+                                                                    kTransmittanceLutWidth,
+                                                                    kTransmittanceLutHeight, 1);
+                         }});
+
+  _renderGraph->addPass(
+      {"multiScatteringLut",
+       RenderGraph::Stage::kCompute,
+       {_transmittanceLutImage.get(), _multiScatteringLutImage.get()},
+       {_multiScatteringLutImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _multiScatteringLutPipeline->recordCommand(cmdBuffer, frameIndex, kMultiScatteringLutWidth,
+                                                    kMultiScatteringLutHeight, 1);
+       }});
+
+  _renderGraph->addPass({"skyViewLut",
+                         RenderGraph::Stage::kCompute,
+                         {_transmittanceLutImage.get(), _multiScatteringLutImage.get()},
+                         {_skyViewLutImage.get()},
+                         [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+                           _skyViewLutPipeline->recordCommand(cmdBuffer, frameIndex,
+                                                              kSkyViewLutWidth, kSkyViewLutHeight,
+                                                              1);
+                         }});
+
+  _renderGraph->addPass(
+      {"shadowMap",
+       RenderGraph::Stage::kCompute,
+       {_shadowMapImage.get(), _shadowMapUpdateBuffer.get()},
+       {_shadowMapImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _shadowMapPipeline->pushConstants(cmdBuffer, G_ShadowMapPushConstants{frameIndex});
+         _shadowMapPipeline->recordIndirectCommand(cmdBuffer, frameIndex,
+                                                   _shadowMapUpdateBuffer->getVkBuffer(),
+                                                   frameIndex * sizeof(G_ShadowMapUpdateInfo));
+       }});
+
+  _renderGraph->addPass({"svoCoarseBeam",
+                         RenderGraph::Stage::kCompute,
+                         {_beamDepthImage.get()},
+                         {_beamDepthImage.get()},
+                         [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+                           _svoCourseBeamPipeline->recordCommand(cmdBuffer, frameIndex,
+                                                                 _getBeamResolutionWidth(),
+                                                                 _getBeamResolutionHeight(), 1);
+                         }});
+
+  // the primary ray statistics are accumulated over the whole frame, so they are cleared right
+  // before the tracing pass
+  _renderGraph->addPass({"outputInfoReset",
+                         RenderGraph::Stage::kTransfer,
+                         {},
+                         {_outputInfoBuffer.get()},
+                         [this](VkCommandBuffer cmdBuffer, uint32_t /*frameIndex*/) {
+                           vkCmdFillBuffer(cmdBuffer, _outputInfoBuffer->getVkBuffer(),
+                                           offsetof(G_OutputInfo, primaryRayIterSumLow),
+                                           3 * sizeof(uint32_t), 0);
+                         }});
+
+  _renderGraph->addPass({"wavefrontReset",
+                         RenderGraph::Stage::kTransfer,
+                         {},
+                         {_wavefrontQueueInfoBuffer.get(), _wavefrontBinBuffer.get()},
+                         [this](VkCommandBuffer cmdBuffer, uint32_t /*frameIndex*/) {
+                           vkCmdFillBuffer(cmdBuffer, _wavefrontQueueInfoBuffer->getVkBuffer(), 0,
+                                           VK_WHOLE_SIZE, 0);
+                           vkCmdFillBuffer(cmdBuffer, _wavefrontBinBuffer->getVkBuffer(), 0,
+                                           VK_WHOLE_SIZE, 0);
+                         },
+                         [this]() { return _wavefrontTracing; }});
+
+  // the adaptive shading is left out in the wavefront mode, see svoTracerSpecializationConstants
+  auto const isAdaptiveShading = [this]() { return _adaptiveSampling && !_wavefrontTracing; };
+
+  _renderGraph->addPass({"tileReset",
+                         RenderGraph::Stage::kTransfer,
+                         {},
+                         {_tileDispatchBuffer.get()},
+                         [this](VkCommandBuffer cmdBuffer, uint32_t /*frameIndex*/) {
+                           G_TileDispatchInfo const dispatchInfo{0, 1, 1};
+                           vkCmdUpdateBuffer(cmdBuffer, _tileDispatchBuffer->getVkBuffer(), 0,
+                                             sizeof(G_TileDispatchInfo), &dispatchInfo);
+                         },
+                         isAdaptiveShading});
+
+  // reads the history before it is updated by this frame
+  _renderGraph->addPass(
+      {"tileClassify",
+       RenderGraph::Stage::kCompute,
+       {_temporalHistLengthImage.get(), _lastAccumedImage.get(), _tileDispatchBuffer.get()},
+       {_tileSampleCountBuffer.get(), _tileListBuffer.get(), _tileDispatchBuffer.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _tileClassifyPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight,
+                                              1);
+       },
+       isAdaptiveShading});
+
+  // in the wavefront mode, the voxel hits are shaded by the wavefront passes instead
+  _renderGraph->addPass(
+      {"svoTracing",
+       RenderGraph::Stage::kCompute,
+       {_beamDepthImage.get(), _skyViewLutImage.get(), _transmittanceLutImage.get(),
+        _shadowMapImage.get(), _wavefrontQueueInfoBuffer.get(), _radianceCacheBuffer.get()},
+       {_backgroundImage.get(), _depthImage.get(), _hitImage.get(), _instantImage.get(),
+        _motionImage.get(), _normalImage.get(), _octreeVisualizationImage.get(),
+        _positionImage.get(), _rawImage.get(), _voxHashImage.get(), _outputInfoBuffer.get(),
+        _wavefrontRayBuffer.get(), _wavefrontQueueInfoBuffer.get(), _wavefrontPixelBuffer.get(),
+        _radianceCacheBuffer.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _svoTracingPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+       }});
+
+  // copies the output info into the readback slot of this frame, the host reads it once the frame
+  // has completed, so the render loop is never stalled by it
+  _renderGraph->addPass(
+      {"outputInfoReadback",
+       RenderGraph::Stage::kTransfer,
+       {_outputInfoBuffer.get()},
+       {},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         VkBufferCopy bufCopy = {
+             0,                    // srcOffset
+             0,                    // dstOffset,
+             sizeof(G_OutputInfo), // size
+         };
+         vkCmdCopyBuffer(cmdBuffer, _outputInfoBuffer->getVkBuffer(),
+                         _outputInfoReadbackBufferBundle->getBuffer(frameIndex)->getVkBuffer(), 1,
+                         &bufCopy);
+
+         // the readback slot is not tracked by the graph, so its host read is made visible here
+         VkMemoryBarrier hostReadBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+         hostReadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+         hostReadBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+         vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                              VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostReadBarrier, 0, nullptr, 0,
+                              nullptr);
+       }});
+
+  _addWavefrontPasses();
+
+  _renderGraph->addPass(
+      {"svoShading",
+       RenderGraph::Stage::kCompute,
+       {_tileListBuffer.get(), _tileSampleCountBuffer.get(), _tileDispatchBuffer.get(),
+        _hitImage.get(), _normalImage.get(), _positionImage.get(), _rawImage.get(),
+        _skyViewLutImage.get(), _transmittanceLutImage.get(), _radianceCacheBuffer.get()},
+       {_rawImage.get(), _radianceCacheBuffer.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _svoShadingPipeline->recordIndirectCommand(cmdBuffer, frameIndex,
+                                                    _tileDispatchBuffer->getVkBuffer());
+       },
+       isAdaptiveShading});
+
+  // after the queries of the frame, so the entries claimed by them are accumulated at once
+  _renderGraph->addPass(
+      {"radianceCacheUpdate",
+       RenderGraph::Stage::kCompute,
+       {_radianceCacheBuffer.get(), _skyViewLutImage.get(), _transmittanceLutImage.get()},
+       {_radianceCacheBuffer.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _radianceCacheUpdatePipeline->recordCommand(
+             cmdBuffer, frameIndex, _configContainer->svoTracerInfo->radianceCacheUpdateBudget, 1,
+             1);
+       },
+       [this]() { return _radianceCache; }});
+
+  _renderGraph->addPass(
+      {"godRay",
+       RenderGraph::Stage::kCompute,
+       {_depthImage.get(), _shadowMapImage.get(), _skyViewLutImage.get(),
+        _transmittanceLutImage.get(), _instantImage.get()},
+       {_instantImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _godRayPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+       }});
+
+  _renderGraph->addPass(
+      {"temporalFilter",
+       RenderGraph::Stage::kCompute,
+       {_hitImage.get(), _lastAccumedImage.get(), _lastNormalImage.get(),
+        _lastPositionImage.get(), _motionImage.get(), _normalImage.get(), _positionImage.get(),
+        _rawImage.get(), _temporalHistLengthImage.get(), _tileSampleCountBuffer.get()},
+       {_aTrousPongImage.get(), _accumedImage.get(), _temporalHistLengthImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _temporalFilterPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight,
+                                                1);
+       }});
 
-    _postProcessingPipeline->recordCommand(cmdBuffer, frameIndex, _highResWidth, _highResHeight, 1);
+  for (int i = 0; i < _configContainer->svoTracerInfo->aTrousSizeMax; i++) {
+    // the iteration is pushed, so the iterations are only separated by the ping pong barriers
+    _renderGraph->addPass(
+        {"aTrous",
+         RenderGraph::Stage::kCompute,
+         {_depthImage.get(), _hitImage.get(), _normalImage.get(), _positionImage.get(),
+          _temporalHistLengthImage.get(), _voxHashImage.get(), _aTrousPingImage.get(),
+          _aTrousPongImage.get()},
+         {_aTrousPingImage.get(), _aTrousPongImage.get()},
+         [this, i](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+           _aTrousPipeline->pushConstants(cmdBuffer,
+                                          G_ATrousPushConstants{static_cast<uint32_t>(i)});
+           _aTrousPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+         }});
+  }
 
-    // copy to history images
-    _normalForwardingPair->forwardCopy(cmdBuffer);
-    _positionForwardingPair->forwardCopy(cmdBuffer);
-    _voxHashForwardingPair->forwardCopy(cmdBuffer);
-    _accumedForwardingPair->forwardCopy(cmdBuffer);
-    _godRayAccumedForwardingPair->forwardCopy(cmdBuffer);
-    _taaForwardingPair->forwardCopy(cmdBuffer);
+  _renderGraph->addPass(
+      {"backgroundBlit",
+       RenderGraph::Stage::kCompute,
+       {_aTrousPongImage.get(), _backgroundImage.get(), _hitImage.get(), _instantImage.get()},
+       {_blittedImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _backgroundBlitPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight,
+                                                1);
+       }});
+
+  _renderGraph->addPass(
+      {"taaUpscaling",
+       RenderGraph::Stage::kCompute,
+       {_blittedImage.get(), _lastTaaImage.get(), _motionImage.get()},
+       {_taaImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _taaUpscalingPipeline->recordCommand(cmdBuffer, frameIndex, _highResWidth, _highResHeight,
+                                              1);
+       }});
+
+  _renderGraph->addPass(
+      {"postProcessing",
+       RenderGraph::Stage::kCompute,
+       {_blittedImage.get(), _octreeVisualizationImage.get(), _rawImage.get(),
+        _shadowMapImage.get(), _taaImage.get(), _renderTargetImage.get()},
+       {_renderTargetImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _postProcessingPipeline->recordCommand(cmdBuffer, frameIndex, _highResWidth,
+                                                _highResHeight, 1);
+       }});
+
+  // the forwarding pairs transition the layouts around the copies themselves
+  _renderGraph->addPass(
+      {"historyCopy",
+       RenderGraph::Stage::kTransfer,
+       {_normalImage.get(), _positionImage.get(), _voxHashImage.get(), _accumedImage.get(),
+        _godRayAccumedImage.get(), _taaImage.get()},
+       {_lastNormalImage.get(), _lastPositionImage.get(), _lastVoxHashImage.get(),
+        _lastAccumedImage.get(), _lastGodRayAccumedImage.get(), _lastTaaImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t /*frameIndex*/) {
+         _normalForwardingPair->forwardCopy(cmdBuffer);
+         _positionForwardingPair->forwardCopy(cmdBuffer);
+         _voxHashForwardingPair->forwardCopy(cmdBuffer);
+         _accumedForwardingPair->forwardCopy(cmdBuffer);
+         _godRayAccumedForwardingPair->forwardCopy(cmdBuffer);
+         _taaForwardingPair->forwardCopy(cmdBuffer);
+       }});
+
+  _renderGraph->compile();
+}
 
-    vkEndCommandBuffer(cmdBuffer);
-  }
+// the indirect queue is binned and traced first, since its hits queue more shadow rays, the rays
+// are sorted by a counting sort over the bins, then traced in the bin order
+void SvoTracer::_addWavefrontPasses() {
+  uint32_t const pixelCount = _lowResWidth * _lowResHeight;
+  auto const isEnabled      = [this]() { return _wavefrontTracing; };
+
+  auto const addBinningPasses = [this, &isEnabled](uint32_t queue, uint32_t capacity) {
+    // the passes dispatch over the capacity of the queue, the threads after the ray count return
+    _renderGraph->addPass(
+        {"wavefrontBinCount",
+         RenderGraph::Stage::kCompute,
+         {_wavefrontRayBuffer.get(), _wavefrontQueueInfoBuffer.get(), _wavefrontBinBuffer.get()},
+         {_wavefrontRayBuffer.get(), _wavefrontBinBuffer.get()},
+         [this, queue, capacity](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+           _wavefrontBinCountPipeline->pushConstants(cmdBuffer, G_WavefrontPushConstants{queue});
+           _wavefrontBinCountPipeline->recordCommand(cmdBuffer, frameIndex, capacity, 1, 1);
+         },
+         isEnabled});
+
+    // also writes the dispatch arguments of the queue
+    _renderGraph->addPass(
+        {"wavefrontBinScan",
+         RenderGraph::Stage::kCompute,
+         {_wavefrontQueueInfoBuffer.get(), _wavefrontBinBuffer.get()},
+         {_wavefrontQueueInfoBuffer.get(), _wavefrontBinBuffer.get()},
+         [this, queue](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+           _wavefrontBinScanPipeline->pushConstants(cmdBuffer, G_WavefrontPushConstants{queue});
+           _wavefrontBinScanPipeline->recordCommand(cmdBuffer, frameIndex, 256, 1, 1);
+         },
+         isEnabled});
+
+    _renderGraph->addPass(
+        {"wavefrontBinScatter",
+         RenderGraph::Stage::kCompute,
+         {_wavefrontRayBuffer.get(), _wavefrontQueueInfoBuffer.get(), _wavefrontBinBuffer.get()},
+         {_wavefrontSortedRayBuffer.get()},
+         [this, queue, capacity](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+           _wavefrontBinScatterPipeline->pushConstants(cmdBuffer, G_WavefrontPushConstants{queue});
+           _wavefrontBinScatterPipeline->recordCommand(cmdBuffer, frameIndex, capacity, 1, 1);
+         },
+         isEnabled});
+  };
+
+  addBinningPasses(kWavefrontIndirectQueue, pixelCount);
+
+  _renderGraph->addPass(
+      {"wavefrontIndirectRay",
+       RenderGraph::Stage::kCompute,
+       {_wavefrontSortedRayBuffer.get(), _wavefrontQueueInfoBuffer.get(),
+        _skyViewLutImage.get(), _transmittanceLutImage.get(), _radianceCacheBuffer.get()},
+       {_wavefrontPixelBuffer.get(), _wavefrontRayBuffer.get(), _wavefrontQueueInfoBuffer.get(),
+        _radianceCacheBuffer.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _wavefrontIndirectRayPipeline->recordIndirectCommand(
+             cmdBuffer, frameIndex, _wavefrontQueueInfoBuffer->getVkBuffer(),
+             kWavefrontIndirectQueue * sizeof(G_WavefrontQueueInfo));
+       },
+       isEnabled});
+
+  addBinningPasses(kWavefrontShadowQueue, 2 * pixelCount);
+
+  _renderGraph->addPass(
+      {"wavefrontShadowRay",
+       RenderGraph::Stage::kCompute,
+       {_wavefrontSortedRayBuffer.get(), _wavefrontQueueInfoBuffer.get(),
+        _skyViewLutImage.get(), _transmittanceLutImage.get()},
+       {_wavefrontPixelBuffer.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _wavefrontShadowRayPipeline->recordIndirectCommand(
+             cmdBuffer, frameIndex, _wavefrontQueueInfoBuffer->getVkBuffer(),
+             kWavefrontShadowQueue * sizeof(G_WavefrontQueueInfo));
+       },
+       isEnabled});
+
+  _renderGraph->addPass(
+      {"wavefrontResolve",
+       RenderGraph::Stage::kCompute,
+       {_wavefrontPixelBuffer.get(), _rawImage.get()},
+       {_rawImage.get()},
+       [this](VkCommandBuffer cmdBuffer, uint32_t frameIndex) {
+         _wavefrontResolvePipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth,
+                                                  _lowResHeight, 1);
+       },
+       isEnabled});
 }
 
 void SvoTracer::_recordDeliveryCommandBuffers() {
@@ -646,16 +1060,103 @@ void SvoTracer::_recordDeliveryCommandBuffers() {
 }
 
 void SvoTracer::drawFrame(size_t currentFrame) {
+  _updatePrimaryRayStats(currentFrame);
   _updateShadowMapCamera();
+  _updateShadowMapUpdateInfo(currentFrame);
   _updateUboData(currentFrame);
 }
 
+// the frame that last used this slot has been waited for, so its readback is complete
+void SvoTracer::_updatePrimaryRayStats(size_t currentFrame) {
+  G_OutputInfo outputInfo{};
+  _outputInfoReadbackBufferBundle->getBuffer(currentFrame)->fetchData(&outputInfo);
+  if (outputInfo.primaryRayCount == 0) {
+    return;
+  }
+  uint64_t const iterSum = (static_cast<uint64_t>(outputInfo.primaryRayIterSumHigh) << 32U) |
+                           outputInfo.primaryRayIterSumLow;
+  _primaryRayIterAverage =
+      static_cast<float>(static_cast<double>(iterSum) / outputInfo.primaryRayCount);
+}
+
 void SvoTracer::_updateShadowMapCamera() {
   glm::vec3 sunDir = _getSunDir(_configContainer->svoTracerTweakingInfo->sunAltitude,
                                 _configContainer->svoTracerTweakingInfo->sunAzimuth);
   _shadowMapCamera->updateCameraVectors(_camera->getPosition(), sunDir);
 }
 
+// the edited chunks are projected onto the shadow map, the texels they cover are traced again,
+// the whole map is traced when the shadow camera moves or the sun changes
+void SvoTracer::_updateShadowMapUpdateInfo(size_t currentFrame) {
+  auto const resolution =
+      static_cast<uint32_t>(_configContainer->svoTracerInfo->shadowMapResolution);
+  glm::mat4 const vpMatShadowMapCam =
+      _shadowMapCamera->getProjectionMatrix() * _shadowMapCamera->getViewMatrix();
+
+  // always taken, so the edits made before a full update are not traced twice
+  std::vector<SvoBuilder::ChunkBounds> const editedChunkBounds =
+      _svoBuilder->takeEditedChunkBounds();
+
+  G_ShadowMapUpdateInfo updateInfo{};
+  if (!_shadowMapValid || vpMatShadowMapCam != _shadowMapVpMat) {
+    updateInfo.rects[0]  = glm::uvec4(0, 0, resolution, resolution);
+    updateInfo.rectCount = 1;
+
+    _shadowMapValid = true;
+    _shadowMapVpMat = vpMatShadowMapCam;
+  } else {
+    for (auto const &bounds : editedChunkBounds) {
+      glm::vec2 uvMin{1.F};
+      glm::vec2 uvMax{0.F};
+      for (uint32_t corner = 0; corner < 8; corner++) {
+        glm::vec3 const worldPos{(corner & 1U) != 0 ? bounds.max.x : bounds.min.x,
+                                 (corner & 2U) != 0 ? bounds.max.y : bounds.min.y,
+                                 (corner & 4U) != 0 ? bounds.max.z : bounds.min.z};
+        glm::vec4 const clipPos = vpMatShadowMapCam * glm::vec4(worldPos, 1.F);
+        glm::vec2 uv            = (glm::vec2(clipPos) / clipPos.w + 1.F) * 0.5F;
+        // flip y axis, same as projectWorldPosToShadowMapUv
+        uv.y  = 1.F - uv.y;
+        uvMin = glm::min(uvMin, uv);
+        uvMax = glm::max(uvMax, uv);
+      }
+
+      // padded by a texel, the footprint is clamped to the map
+      auto const resolutionF = static_cast<float>(resolution);
+      glm::vec2 const texelMin =
+          glm::clamp(glm::floor(uvMin * resolutionF) - 1.F, glm::vec2{0.F}, glm::vec2{resolutionF});
+      glm::vec2 const texelMax =
+          glm::clamp(glm::ceil(uvMax * resolutionF) + 1.F, glm::vec2{0.F}, glm::vec2{resolutionF});
+      if (texelMin.x >= texelMax.x || texelMin.y >= texelMax.y) {
+        continue;
+      }
+      glm::uvec4 const rect{glm::uvec2(texelMin), glm::uvec2(texelMax)};
+
+      // the overflowing rects are merged into the last one
+      if (updateInfo.rectCount < kShadowMapMaxDirtyRects) {
+        updateInfo.rects[updateInfo.rectCount++] = rect;
+      } else {
+        glm::uvec4 &lastRect = updateInfo.rects[kShadowMapMaxDirtyRects - 1];
+        lastRect             = glm::uvec4(glm::min(glm::uvec2(lastRect), glm::uvec2(rect)),
+                                          glm::max(glm::uvec2(lastRect.z, lastRect.w),
+                                                   glm::uvec2(rect.z, rect.w)));
+      }
+    }
+  }
+
+  // a workgroup layer per rect, sized by the largest rect, nothing is dispatched without a rect
+  glm::uvec2 maxRectSize{0};
+  for (uint32_t i = 0; i < updateInfo.rectCount; i++) {
+    glm::uvec4 const &rect = updateInfo.rects[i];
+    maxRectSize            = glm::max(maxRectSize, glm::uvec2(rect.z - rect.x, rect.w - rect.y));
+  }
+  updateInfo.dispatchX = (maxRectSize.x + 7) / 8;
+  updateInfo.dispatchY = (maxRectSize.y + 7) / 8;
+  updateInfo.dispatchZ = updateInfo.rectCount;
+
+  _shadowMapUpdateBuffer->upload(&updateInfo, sizeof(G_ShadowMapUpdateInfo),
+                                 currentFrame * sizeof(G_ShadowMapUpdateInfo));
+}
+
 void SvoTracer::_updateUboData(size_t currentFrame) {
   static uint32_t currentSample = 0;
   // identity matrix
@@ -707,7 +1208,7 @@ void SvoTracer::_updateUboData(size_t currentFrame) {
       currentSample,
       currentTime,
   };
-  _renderInfoBufferBundle->getBuffer(currentFrame)->fillData(&renderInfo);
+  _renderInfoUniformBuffer->fillSlice(currentFrame, &renderInfo);
 
   vMatPrev     = vMat;
   vMatPrevInv  = vMatInv;
@@ -727,25 +1228,18 @@ void SvoTracer::_updateUboData(size_t currentFrame) {
   environmentInfo.sunLuminance           = td.sunLuminance;
   environmentInfo.atmosLuminance         = td.atmosLuminance;
   environmentInfo.sunSize                = td.sunSize;
-  _environmentInfoBufferBundle->getBuffer(currentFrame)->fillData(&environmentInfo);
+  _environmentInfoUniformBuffer->fillSlice(currentFrame, &environmentInfo);
 
   G_TweakableParameters tweakableParameters{};
-  tweakableParameters.debugB1          = td.debugB1;
-  tweakableParameters.debugF1          = td.debugF1;
-  tweakableParameters.debugI1          = td.debugI1;
-  tweakableParameters.debugC1          = td.debugC1;
-  tweakableParameters.explosure        = td.explosure;
-  tweakableParameters.visualizeChunks  = td.visualizeChunks;
-  tweakableParameters.visualizeOctree  = td.visualizeOctree;
-  tweakableParameters.beamOptimization = td.beamOptimization;
-  tweakableParameters.traceIndirectRay = td.traceIndirectRay;
-  tweakableParameters.taa              = td.taa;
-  _tweakableParametersBufferBundle->getBuffer(currentFrame)->fillData(&tweakableParameters);
+  tweakableParameters.debugF1   = td.debugF1;
+  tweakableParameters.debugC1   = td.debugC1;
+  tweakableParameters.explosure = td.explosure;
+  _tweakableParametersUniformBuffer->fillSlice(currentFrame, &tweakableParameters);
 
   G_TemporalFilterInfo temporalFilterInfo{};
   temporalFilterInfo.temporalAlpha       = td.temporalAlpha;
   temporalFilterInfo.temporalPositionPhi = td.temporalPositionPhi;
-  _temporalFilterInfoBufferBundle->getBuffer(currentFrame)->fillData(&temporalFilterInfo);
+  _temporalFilterInfoUniformBuffer->fillSlice(currentFrame, &temporalFilterInfo);
 
   G_SpatialFilterInfo spatialFilterInfo{};
   spatialFilterInfo.aTrousIterationCount  = static_cast<uint32_t>(td.aTrousIterationCount);
@@ -756,7 +1250,7 @@ void SvoTracer::_updateUboData(size_t currentFrame) {
   spatialFilterInfo.maxPhiZ               = td.maxPhiZ;
   spatialFilterInfo.phiZStableSampleCount = td.phiZStableSampleCount;
   spatialFilterInfo.changingLuminancePhi  = td.changingLuminancePhi;
-  _spatialFilterInfoBufferBundle->getBuffer(currentFrame)->fillData(&spatialFilterInfo);
+  _spatialFilterInfoUniformBuffer->fillSlice(currentFrame, &spatialFilterInfo);
 
   currentSample++;
 }
@@ -768,14 +1262,15 @@ G_OutputInfo SvoTracer::getOutputInfo() {
 }
 
 void SvoTracer::_createDescriptorSetBundle() {
-  _descriptorSetBundle = std::make_unique<DescriptorSetBundle>(_appContext, _framesInFlight,
-                                                               VK_SHADER_STAGE_COMPUTE_BIT);
+  // the per-frame uniform data is selected by dynamic offsets, so a single set serves every frame
+  _descriptorSetBundle =
+      std::make_unique<DescriptorSetBundle>(_appContext, 1, VK_SHADER_STAGE_COMPUTE_BIT);
 
-  _descriptorSetBundle->bindUniformBufferBundle(0, _renderInfoBufferBundle.get());
-  _descriptorSetBundle->bindUniformBufferBundle(1, _environmentInfoBufferBundle.get());
-  _descriptorSetBundle->bindUniformBufferBundle(2, _tweakableParametersBufferBundle.get());
-  _descriptorSetBundle->bindUniformBufferBundle(3, _temporalFilterInfoBufferBundle.get());
-  _descriptorSetBundle->bindUniformBufferBundle(4, _spatialFilterInfoBufferBundle.get());
+  _descriptorSetBundle->bindDynamicUniformBuffer(0, _renderInfoUniformBuffer.get());
+  _descriptorSetBundle->bindDynamicUniformBuffer(1, _environmentInfoUniformBuffer.get());
+  _descriptorSetBundle->bindDynamicUniformBuffer(2, _tweakableParametersUniformBuffer.get());
+  _descriptorSetBundle->bindDynamicUniformBuffer(3, _temporalFilterInfoUniformBuffer.get());
+  _descriptorSetBundle->bindDynamicUniformBuffer(4, _spatialFilterInfoUniformBuffer.get());
 
   _descriptorSetBundle->bindStorageImage(5, _scalarBlueNoise.get());
   _descriptorSetBundle->bindStorageImage(6, _vec2BlueNoise.get());
@@ -827,60 +1322,139 @@ void SvoTracer::_createDescriptorSetBundle() {
   _descriptorSetBundle->bindStorageBuffer(9, _svoBuilder->getChunkIndicesBuffer());
   _descriptorSetBundle->bindStorageBuffer(44, _sceneInfoBuffer.get());
   _descriptorSetBundle->bindStorageBuffer(45, _svoBuilder->getAppendedOctreeBuffer());
-  _descriptorSetBundle->bindStorageBuffer(46, _aTrousIterationBuffer.get());
   _descriptorSetBundle->bindStorageBuffer(47, _outputInfoBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(48, _svoBuilder->getAppendedLeafAttributeBuffer());
+  _descriptorSetBundle->bindStorageBuffer(49, _svoBuilder->getChunkBrickMaskBuffer());
+  _descriptorSetBundle->bindStorageBuffer(50, _svoBuilder->getChunkGroupOccupancyBuffer());
+
+  _descriptorSetBundle->bindStorageBuffer(51, _wavefrontRayBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(52, _wavefrontSortedRayBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(53, _wavefrontQueueInfoBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(54, _wavefrontBinBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(55, _wavefrontPixelBuffer.get());
+
+  _descriptorSetBundle->bindStorageBuffer(56, _radianceCacheBuffer.get());
+
+  _descriptorSetBundle->bindStorageBuffer(57, _tileSampleCountBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(58, _tileListBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(59, _tileDispatchBuffer.get());
+
+  _descriptorSetBundle->bindStorageBuffer(60, _shadowMapUpdateBuffer.get());
 
   _descriptorSetBundle->create();
 }
 
 void SvoTracer::_createPipelines() {
+  // the toggles are compiled into the pipelines, a variant is switched to when they change
+  SpecializationConstants const specializationConstants =
+      _makeSpecializationConstants(*_configContainer->svoTracerTweakingInfo);
+
   _transmittanceLutPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("transmittanceLut.comp"),
-      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _multiScatteringLutPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("multiScatteringLut.comp"),
-      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _skyViewLutPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("skyViewLut.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _shadowMapPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("shadowMap.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ShadowMapPushConstants), specializationConstants);
 
   _svoCourseBeamPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("svoCoarseBeam.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _svoTracingPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("svoTracing.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _godRayPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("godRay.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _temporalFilterPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("temporalFilter.comp"),
-      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _aTrousPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("aTrous.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_ATrousPushConstants), specializationConstants);
 
   _backgroundBlitPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("backgroundBlit.comp"),
-      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _taaUpscalingPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("taaUpscaling.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 
   _postProcessingPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("postProcessing.comp"),
-      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
+
+  _wavefrontBinCountPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontBinCount.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_WavefrontPushConstants), specializationConstants);
+
+  // a single workgroup scans all the bins of a queue
+  _wavefrontBinScanPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontBinScan.comp"),
+      WorkGroupSize{256, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_WavefrontPushConstants), specializationConstants);
+
+  _wavefrontBinScatterPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontBinScatter.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(G_WavefrontPushConstants), specializationConstants);
+
+  _wavefrontIndirectRayPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontIndirectRay.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      0, specializationConstants);
+
+  _wavefrontShadowRayPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontShadowRay.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      0, specializationConstants);
+
+  _wavefrontResolvePipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontResolve.comp"),
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
+
+  _radianceCacheUpdatePipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("radianceCacheUpdate.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      0, specializationConstants);
+
+  // a workgroup per tile for both
+  _tileClassifyPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("tileClassify.comp"), WorkGroupSize{8, 8, 1},
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
+
+  _svoShadingPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("svoShading.comp"), WorkGroupSize{8, 8, 1},
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 0,
+      specializationConstants);
 }
 
 void SvoTracer::_updatePipelinesDescriptorBundles() {
@@ -898,4 +1472,16 @@ void SvoTracer::_updatePipelinesDescriptorBundles() {
   _backgroundBlitPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _taaUpscalingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _postProcessingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+
+  _wavefrontBinCountPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontBinScanPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontBinScatterPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontIndirectRayPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontShadowRayPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontResolvePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+
+  _radianceCacheUpdatePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+
+  _tileClassifyPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _svoShadingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
 }
@@ -17,21 +17,25 @@ class Image;
 class ImageForwardingPair;
 class Buffer;
 class BufferBundle;
+class DynamicUniformBuffer;
 class Sampler;
 class SvoBuilder;
 class DescriptorSetBundle;
 class ComputePipeline;
+class RenderGraph;
 class Camera;
 class ShadowMapCamera;
 class Window;
 class ShaderCompiler;
 class ShaderChangeListener;
+class JobSystem;
 
 class SvoTracer : public PipelineScheduler {
 public:
   SvoTracer(VulkanApplicationContext *appContext, Logger *logger, size_t framesInFlight,
             Window *window, ShaderCompiler *shaderCompiler,
-            ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer);
+            ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer,
+            JobSystem *jobSystem);
   ~SvoTracer() override;
 
   // disable copy and move
@@ -42,6 +46,9 @@ public:
 
   void init(SvoBuilder *svoBuilder);
   void onPipelineRebuilt() override;
+  // switches the pipelines to the variants of the current toggles, the frames in flight must have
+  // finished
+  void onTweakableTogglesChanged();
 
   void onSwapchainResize();
   VkCommandBuffer getTracingCommandBuffer(size_t currentFrame) {
@@ -54,6 +61,10 @@ public:
   void drawFrame(size_t currentFrame);
 
   G_OutputInfo getOutputInfo();
+  // the average marching iterations of the primary rays, of the last frame in this frame slot
+  [[nodiscard]] float getPrimaryRayIterAverage() const { return _primaryRayIterAverage; }
+
+  [[nodiscard]] Camera *getCamera() const { return _camera.get(); }
 
   void processInput(double deltaTime);
 
@@ -68,6 +79,7 @@ private:
   ConfigContainer *_configContainer;
   ShaderCompiler *_shaderCompiler;
   ShaderChangeListener *_shaderChangeListener;
+  JobSystem *_jobSystem;
 
   SvoBuilder *_svoBuilder = nullptr;
 
@@ -83,9 +95,13 @@ private:
   std::vector<glm::vec2> _subpixOffsets{};
 
   void _updateShadowMapCamera();
+  void _updateShadowMapUpdateInfo(size_t currentFrame);
   void _updateUboData(size_t currentFrame);
+  void _updatePrimaryRayStats(size_t currentFrame);
 
   void _updateImageResolutions();
+  [[nodiscard]] uint32_t _getBeamResolutionWidth() const;
+  [[nodiscard]] uint32_t _getBeamResolutionHeight() const;
 
   void _recordRenderingCommandBuffers();
   void _recordDeliveryCommandBuffers();
@@ -108,6 +124,10 @@ private:
   std::unique_ptr<Image> _skyViewLutImage;
 
   std::unique_ptr<Image> _shadowMapImage;
+  // the shadow map is kept across the frames, it is fully traced again only when the shadow camera
+  // changes, otherwise only the texels covered by the edited chunks are
+  bool _shadowMapValid = false;
+  glm::mat4 _shadowMapVpMat{1.F};
 
   // the followed up resources are swapchain dimension related
   std::unique_ptr<Image> _backgroundImage;
@@ -171,18 +191,40 @@ private:
   // the memory increase should be small and solves your problem with uploading data:
   // https://www.reddit.com/r/vulkan/comments/10io2l8/is_framesinflight_fif_method_really_worth_it/
 
-  std::unique_ptr<BufferBundle> _renderInfoBufferBundle;
-  std::unique_ptr<BufferBundle> _environmentInfoBufferBundle;
-  std::unique_ptr<BufferBundle> _tweakableParametersBufferBundle;
-  std::unique_ptr<BufferBundle> _temporalFilterInfoBufferBundle;
-  std::unique_ptr<BufferBundle> _spatialFilterInfoBufferBundle;
+  std::unique_ptr<DynamicUniformBuffer> _renderInfoUniformBuffer;
+  std::unique_ptr<DynamicUniformBuffer> _environmentInfoUniformBuffer;
+  std::unique_ptr<DynamicUniformBuffer> _tweakableParametersUniformBuffer;
+  std::unique_ptr<DynamicUniformBuffer> _temporalFilterInfoUniformBuffer;
+  std::unique_ptr<DynamicUniformBuffer> _spatialFilterInfoUniformBuffer;
 
   std::unique_ptr<Buffer> _sceneInfoBuffer;
-  std::unique_ptr<Buffer> _aTrousIterationBuffer;
-  std::vector<std::unique_ptr<Buffer>> _aTrousIterationStagingBuffers;
   std::unique_ptr<Buffer> _outputInfoBuffer;
-
-  void _createBuffersAndBufferBundles();
+  std::unique_ptr<BufferBundle> _outputInfoReadbackBufferBundle;
+  float _primaryRayIterAverage = 0.F;
+
+  // the queues of the wavefront tracing mode, sized by the low res resolution, the ray queues are
+  // only allocated while the mode is enabled
+  std::unique_ptr<Buffer> _wavefrontRayBuffer;
+  std::unique_ptr<Buffer> _wavefrontSortedRayBuffer;
+  std::unique_ptr<Buffer> _wavefrontQueueInfoBuffer;
+  std::unique_ptr<Buffer> _wavefrontBinBuffer;
+  std::unique_ptr<Buffer> _wavefrontPixelBuffer;
+
+  // the 8x8 tiles of the adaptive sampling, the shaded ones are listed for an indirect dispatch
+  std::unique_ptr<Buffer> _tileSampleCountBuffer;
+  std::unique_ptr<Buffer> _tileListBuffer;
+  std::unique_ptr<Buffer> _tileDispatchBuffer;
+
+  // persists across the frames and the swapchain resizes, it is keyed by the world space voxels
+  std::unique_ptr<Buffer> _radianceCacheBuffer;
+
+  // the dirty rects of the shadow map and their dispatch size, one slice per frame in flight
+  std::unique_ptr<Buffer> _shadowMapUpdateBuffer;
+
+  void _createBuffers();
+  void _createWavefrontBuffers();
+  void _createWavefrontRayBuffers();
+  void _createAdaptiveSamplingBuffers();
   void _initBufferData();
 
   /// PIPELINES
@@ -203,7 +245,32 @@ private:
   std::unique_ptr<ComputePipeline> _taaUpscalingPipeline;
   std::unique_ptr<ComputePipeline> _postProcessingPipeline;
 
+  std::unique_ptr<ComputePipeline> _wavefrontBinCountPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontBinScanPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontBinScatterPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontIndirectRayPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontShadowRayPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontResolvePipeline;
+
+  std::unique_ptr<ComputePipeline> _radianceCacheUpdatePipeline;
+
+  std::unique_ptr<ComputePipeline> _tileClassifyPipeline;
+  std::unique_ptr<ComputePipeline> _svoShadingPipeline;
+
+  // the toggles that the pipelines are specialized with, the passes of a disabled feature are not
+  // recorded
+  bool _wavefrontTracing = false;
+  bool _radianceCache    = false;
+  bool _adaptiveSampling = false;
+
   void _createDescriptorSetBundle();
   void _createPipelines();
   void _updatePipelinesDescriptorBundles();
+
+  /// RENDER GRAPH
+
+  std::unique_ptr<RenderGraph> _renderGraph;
+
+  void _createRenderGraph();
+  void _addWavefrontPasses();
 };
\ No newline at end of file
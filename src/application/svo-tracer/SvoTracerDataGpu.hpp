@@ -14,6 +14,7 @@
 
 #define vec3 alignas(16) glm::vec3
 #define uvec3 alignas(16) glm::uvec3
+#define uvec4 alignas(16) glm::uvec4
 #define vec2 alignas(8) glm::vec2
 #define mat4 alignas(16) glm::mat4
 #define uvec2 alignas(8) glm::uvec2
@@ -23,6 +24,7 @@
 
 #undef vec3
 #undef uvec3
+#undef uvec4
 #undef vec2
 #undef mat4
 #undef uvec2
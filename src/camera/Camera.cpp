@@ -55,20 +55,22 @@ void Camera::processKeyboard(double deltaTime) {
 
   KeyboardInfo const &ki = _window->getKeyboardInfo();
 
+  glm::vec3 displacement{0.F};
+
   if (ki.isKeyPressed(GLFW_KEY_W)) {
-    _position += _front * velocity;
+    displacement += _front * velocity;
   }
   if (ki.isKeyPressed(GLFW_KEY_S)) {
-    _position -= _front * velocity;
+    displacement -= _front * velocity;
   }
   if (ki.isKeyPressed(GLFW_KEY_A)) {
-    _position -= _right * velocity;
+    displacement -= _right * velocity;
   }
   if (ki.isKeyPressed(GLFW_KEY_D)) {
-    _position += _right * velocity;
+    displacement += _right * velocity;
   }
   if (ki.isKeyPressed(GLFW_KEY_SPACE)) {
-    _position += kWorldUp * velocity;
+    displacement += kWorldUp * velocity;
   }
   if (ki.isKeyPressed(GLFW_KEY_LEFT_SHIFT)) {
     _movementSpeedMultiplier = _configContainer->cameraInfo->movementSpeedBoost;
@@ -76,8 +78,14 @@ void Camera::processKeyboard(double deltaTime) {
     _movementSpeedMultiplier = 1.F;
   }
   if (ki.isKeyPressed(GLFW_THUMB_KEY)) {
-    _position -= kWorldUp * velocity;
+    displacement -= kWorldUp * velocity;
+  }
+
+  if (displacement == glm::vec3{0.F}) {
+    return;
   }
+  _position = _movementResolver ? _movementResolver(_position, displacement)
+                                : _position + displacement;
 }
 
 void Camera::handleMouseMovement(CursorMoveInfo const &mouseInfo) {
@@ -10,10 +10,16 @@
 #include "window/CursorInfo.hpp"
 #include "window/Window.hpp"
 
+#include <functional>
+#include <utility>
+
 struct ConfigContainer;
 
 class Camera {
 public:
+  // returns where the camera ends up when it is moved from the position by the displacement
+  using MovementResolver = std::function<glm::vec3(glm::vec3 position, glm::vec3 displacement)>;
+
   Camera(Window *window, ConfigContainer *configContainer);
   ~Camera();
 
@@ -29,6 +35,11 @@ public:
 
   void processInput(double deltaTime);
 
+  // the camera moves freely without a resolver
+  void setMovementResolver(MovementResolver movementResolver) {
+    _movementResolver = std::move(movementResolver);
+  }
+
   // processes input received from any keyboard-like input system. Accepts input
   // parameter in the form of camera defined ENUM (to abstract it from windowing
   // systems)
@@ -64,6 +75,7 @@ private:
   float _pitch{};
 
   float _movementSpeedMultiplier = 1.F;
+  MovementResolver _movementResolver;
 
   // calculates the front vector from the Camera's (updated) Euler Angles
   void _updateCameraVectors();
@@ -5,6 +5,7 @@ class TomlConfigReader;
 struct ApplicationInfo {
   int framesInFlight{};
   bool isFramerateLimited{};
+  int benchmarkFrames{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
@@ -10,6 +10,9 @@ struct CameraInfo {
   float movementSpeed{};
   float movementSpeedBoost{};
   float mouseSensitivity{};
+  bool collision{};
+  float collisionHalfExtent{}; // in chunks
+  float collisionStepHeight{}; // in chunks
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
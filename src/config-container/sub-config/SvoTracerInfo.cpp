@@ -8,4 +8,8 @@ void SvoTracerInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
   taaSamplingOffsetSize = tomlConfigReader->getConfig<uint32_t>("SvoTracer.taaSamplingOffsetSize");
   shadowMapResolution   = tomlConfigReader->getConfig<uint32_t>("SvoTracer.shadowMapResolution");
   upscaleRatio          = tomlConfigReader->getConfig<float>("SvoTracer.upscaleRatio");
+
+  radianceCacheSize         = tomlConfigReader->getConfig<uint32_t>("SvoTracer.radianceCacheSize");
+  radianceCacheUpdateBudget =
+      tomlConfigReader->getConfig<uint32_t>("SvoTracer.radianceCacheUpdateBudget");
 }
@@ -10,6 +10,8 @@ struct SvoTracerInfo {
   uint32_t taaSamplingOffsetSize{};
   uint32_t shadowMapResolution{};
   float upscaleRatio{};
+  uint32_t radianceCacheSize{};
+  uint32_t radianceCacheUpdateBudget{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
@@ -17,6 +17,9 @@ void SvoTracerTweakingInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
   beamOptimization = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.beamOptimization");
   traceIndirectRay = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.traceIndirectRay");
   taa              = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.taa");
+  wavefrontTracing = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.wavefrontTracing");
+  radianceCache    = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.radianceCache");
+  adaptiveSampling = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.adaptiveSampling");
 
   sunAltitude     = tomlConfigReader->getConfig<float>("SvoTracerTweakingData.sunAltitude");
   sunAzimuth      = tomlConfigReader->getConfig<float>("SvoTracerTweakingData.sunAzimuth");
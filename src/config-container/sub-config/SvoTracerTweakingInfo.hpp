@@ -19,6 +19,9 @@ struct SvoTracerTweakingInfo {
   bool beamOptimization{};
   bool traceIndirectRay{};
   bool taa{};
+  bool wavefrontTracing{};
+  bool radianceCache{};
+  bool adaptiveSampling{};
 
   // for env
   float sunAltitude{};
@@ -6,4 +6,19 @@ void TerrainInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
   chunkVoxelDim  = tomlConfigReader->getConfig<uint32_t>("Terrain.chunkVoxelDim");
   auto const &cd = tomlConfigReader->getConfig<std::array<uint32_t, 3>>("Terrain.chunkDim");
   chunksDim      = glm::vec3(cd.at(0), cd.at(1), cd.at(2));
+  dagCompression = tomlConfigReader->getConfig<bool>("Terrain.dagCompression");
+  wideTree       = tomlConfigReader->getConfig<bool>("Terrain.wideTree");
+  separateLeafAttributes =
+      tomlConfigReader->getConfig<bool>("Terrain.separateLeafAttributes");
+  buildBudgetMs = tomlConfigReader->getConfig<float>("Terrain.buildBudgetMs");
+  chunkFieldDumpFolder =
+      tomlConfigReader->getConfig<std::string>("Terrain.chunkFieldDumpFolder");
+  cpuChunkGeneration = tomlConfigReader->getConfig<bool>("Terrain.cpuChunkGeneration");
+  cpuWorldMirror     = tomlConfigReader->getConfig<bool>("Terrain.cpuWorldMirror");
+  meshPath           = tomlConfigReader->getConfig<std::string>("Terrain.meshPath");
+  auto const &mbn    = tomlConfigReader->getConfig<std::array<float, 3>>("Terrain.meshBoxMin");
+  meshBoxMin         = glm::vec3(mbn.at(0), mbn.at(1), mbn.at(2));
+  auto const &mbx    = tomlConfigReader->getConfig<std::array<float, 3>>("Terrain.meshBoxMax");
+  meshBoxMax         = glm::vec3(mbx.at(0), mbx.at(1), mbx.at(2));
+  meshBlockType      = tomlConfigReader->getConfig<uint32_t>("Terrain.meshBlockType");
 }
@@ -3,12 +3,24 @@
 #include <glm/glm.hpp>
 
 #include <cstdint>
+#include <string>
 
 class TomlConfigReader;
 
 struct TerrainInfo {
   uint32_t chunkVoxelDim{};
   glm::uvec3 chunksDim{};
+  bool dagCompression{};
+  bool wideTree{};
+  bool separateLeafAttributes{};
+  float buildBudgetMs{};
+  std::string chunkFieldDumpFolder{};
+  bool cpuChunkGeneration{};
+  bool cpuWorldMirror{};
+  std::string meshPath{};
+  glm::vec3 meshBoxMin{};
+  glm::vec3 meshBoxMax{};
+  uint32_t meshBlockType{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
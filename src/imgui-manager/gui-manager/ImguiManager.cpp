@@ -7,6 +7,9 @@
 #include "../imgui-backends/imgui_impl_glfw.h"
 #include "../imgui-backends/imgui_impl_vulkan.h"
 #include "app-context/VulkanApplicationContext.hpp"
+#include "application/BlockState.hpp"
+#include "utils/event-dispatcher/GlobalEventDispatcher.hpp"
+#include "utils/event-types/EventType.hpp"
 #include "utils/config/RootDir.h"
 #include "utils/fps-sink/FpsSink.hpp"
 #include "utils/logger/Logger.hpp"
@@ -257,10 +260,13 @@ void ImguiManager::_drawConfigMenuItem() {
     auto &stti = _configContainer->svoTracerTweakingInfo;
     auto &bi   = _configContainer->brushInfo;
 
+    // the toggles are compiled into the pipelines, so their changes are applied between frames
+    bool togglesChanged = false;
+
     ImGui::SeparatorText("Debug");
-    ImGui::Checkbox("Debug B1", &stti->debugB1);
+    togglesChanged |= ImGui::Checkbox("Debug B1", &stti->debugB1);
     ImGui::SliderFloat("Debug F1", &stti->debugF1, 0.0F, 1.0F);
-    ImGui::SliderInt("Debug I1", &stti->debugI1, 0, 10);
+    togglesChanged |= ImGui::SliderInt("Debug I1", &stti->debugI1, 0, 10);
     ImGui::ColorEdit3("Debug C1", &stti->debugC1.x);
 
     ///
@@ -283,15 +289,18 @@ void ImguiManager::_drawConfigMenuItem() {
     ///
 
     ImGui::SeparatorText("Tracing");
-    ImGui::Checkbox("Visualize Chunks", &stti->visualizeChunks);
-    ImGui::Checkbox("Visualize Octree", &stti->visualizeOctree);
-    ImGui::Checkbox("Beam Optimization", &stti->beamOptimization);
-    ImGui::Checkbox("Trace Indirect Ray", &stti->traceIndirectRay);
+    togglesChanged |= ImGui::Checkbox("Visualize Chunks", &stti->visualizeChunks);
+    togglesChanged |= ImGui::Checkbox("Visualize Octree", &stti->visualizeOctree);
+    togglesChanged |= ImGui::Checkbox("Beam Optimization", &stti->beamOptimization);
+    togglesChanged |= ImGui::Checkbox("Trace Indirect Ray", &stti->traceIndirectRay);
+    togglesChanged |= ImGui::Checkbox("Wavefront Tracing", &stti->wavefrontTracing);
+    togglesChanged |= ImGui::Checkbox("Radiance Cache", &stti->radianceCache);
+    togglesChanged |= ImGui::Checkbox("Adaptive Sampling", &stti->adaptiveSampling);
 
     ///
 
     ImGui::SeparatorText("Filtering");
-    ImGui::Checkbox("TAA", &stti->taa);
+    togglesChanged |= ImGui::Checkbox("TAA", &stti->taa);
     ImGui::SliderFloat("Temporal Alpha", &stti->temporalAlpha, 0.0F, 1.0F);
     ImGui::SliderInt("A-Trous Iteration Count", &stti->aTrousIterationCount, 0, 5);
     ImGui::SliderFloat("Phi Z - Far End", &stti->minPhiZ, 0.0F, 1.0F);
@@ -306,6 +315,11 @@ void ImguiManager::_drawConfigMenuItem() {
 
     ///
 
+    if (togglesChanged) {
+      GlobalEventDispatcher::get().trigger<E_RenderLoopBlockRequest>(
+          E_RenderLoopBlockRequest{BlockState::kTogglesChanged});
+    }
+
     ImGui::EndMenu();
   }
 }
@@ -323,6 +337,9 @@ void ImguiManager::_drawFpsMenuItem(double fpsInTimeBucket) {
   ImGui::SetNextItemWidth(fpsMenuWidth);
   if (ImGui::BeginMenu("##FpsMenu")) {
     ImGui::Checkbox("Show Fps", &_showFpsGraph);
+    // for comparing the tree layouts and the marching variants
+    ImGui::Text("Frame Time: %.2f ms", fpsInTimeBucket > 0 ? 1000.0 / fpsInTimeBucket : 0.0);
+    ImGui::Text("Primary Ray Iterations: %.2f", _primaryRayIterAverage);
     ImGui::EndMenu();
   }
 
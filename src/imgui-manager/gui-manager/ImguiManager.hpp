@@ -30,6 +30,11 @@ public:
 
   void draw(FpsSink *fpsSink);
 
+  // the average marching iterations of the primary rays, shown in the fps menu
+  void setPrimaryRayIterAverage(float primaryRayIterAverage) {
+    _primaryRayIterAverage = primaryRayIterAverage;
+  }
+
   [[nodiscard]] VkCommandBuffer getCommandBuffer(size_t currentFrame) {
     return _guiCommandBuffers[currentFrame];
   }
@@ -45,7 +50,8 @@ private:
   ConfigContainer *_configContainer;
 
   int _framesInFlight;
-  bool _showFpsGraph = false;
+  bool _showFpsGraph           = false;
+  float _primaryRayIterAverage = 0.F;
 
   std::unique_ptr<FpsGui> _fpsGui;
 
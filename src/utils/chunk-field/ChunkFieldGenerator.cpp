@@ -0,0 +1,179 @@
+#include "ChunkFieldGenerator.hpp"
+
+#include "ChunkFieldKernel.hpp"
+#include "utils/job-system/JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace {
+
+// the lanes of the scalar path are the plain types, the integer math is unsigned, so it wraps like
+// the one of the shader
+struct ScalarLanes {
+  using F = float;
+  using I = uint32_t;
+  using M = bool;
+
+  static constexpr uint32_t kWidth = 1;
+
+  static F splat(float f) { return f; }
+  static I splatInt(uint32_t i) { return i; }
+  static I iota(uint32_t i) { return i; }
+
+  static F negate(F f) { return -f; }
+  static F floor(F f) { return std::floor(f); }
+  static F sqrt(F f) { return std::sqrt(f); }
+  static F min(F a, F b) { return std::min(a, b); }
+  static F max(F a, F b) { return std::max(a, b); }
+
+  static I toInt(F f) { return static_cast<uint32_t>(static_cast<int32_t>(f)); }
+  static F toFloat(I i) { return static_cast<float>(static_cast<int32_t>(i)); }
+  template <uint32_t kBits> static I shiftLeft(I i) { return i << kBits; }
+
+  static M lessThan(F a, F b) { return a < b; }
+  static I select(M mask, I ifTrue, I ifFalse) { return mask ? ifTrue : ifFalse; }
+
+  static void store(uint16_t *dst, I i) { *dst = static_cast<uint16_t>(i); }
+};
+
+bool _cpuHasAvx2() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  // the os must save the ymm registers as well
+  int info[4];
+  __cpuid(info, 1);
+  bool const osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+  return false;
+#endif
+}
+
+ChunkFieldGenerator::SimdPath _getBestSimdPath() {
+  if (ChunkFieldGenerator::isSimdPathSupported(ChunkFieldGenerator::SimdPath::kAvx2)) {
+    return ChunkFieldGenerator::SimdPath::kAvx2;
+  }
+  if (ChunkFieldGenerator::isSimdPathSupported(ChunkFieldGenerator::SimdPath::kNeon)) {
+    return ChunkFieldGenerator::SimdPath::kNeon;
+  }
+  return ChunkFieldGenerator::SimdPath::kScalar;
+}
+} // namespace
+
+ChunkFieldGenerator::ChunkFieldGenerator(JobSystem *jobSystem, uint32_t voxelResolution,
+                                         glm::uvec3 chunksDim)
+    : _jobSystem(jobSystem), _voxelResolution(voxelResolution), _chunksDim(chunksDim),
+      _simdPath(_getBestSimdPath()) {}
+
+bool ChunkFieldGenerator::isSimdPathSupported(SimdPath simdPath) {
+  switch (simdPath) {
+  case SimdPath::kScalar:
+    return true;
+  case SimdPath::kAvx2:
+#if defined(CHUNK_FIELD_AVX2)
+    static bool const kCpuHasAvx2 = _cpuHasAvx2();
+    return kCpuHasAvx2;
+#else
+    return false;
+#endif
+  case SimdPath::kNeon:
+#if defined(CHUNK_FIELD_NEON)
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+char const *ChunkFieldGenerator::getSimdPathName(SimdPath simdPath) {
+  switch (simdPath) {
+  case SimdPath::kScalar:
+    return "scalar";
+  case SimdPath::kAvx2:
+    return "avx2";
+  case SimdPath::kNeon:
+    return "neon";
+  }
+  return "unknown";
+}
+
+void ChunkFieldGenerator::setSimdPath(SimdPath simdPath) {
+  _simdPath = isSimdPathSupported(simdPath) ? simdPath : SimdPath::kScalar;
+}
+
+size_t ChunkFieldGenerator::getFieldSize() const {
+  auto const dim = static_cast<size_t>(_voxelResolution) + 1;
+  return dim * dim * dim;
+}
+
+void ChunkFieldGenerator::generate(std::vector<uint16_t> &oField, glm::uvec3 chunkIndex) const {
+  oField.resize(getFieldSize());
+
+  uint32_t const slabCount = _voxelResolution + 1;
+  if (_jobSystem == nullptr) {
+    for (uint32_t z = 0; z < slabCount; z++) {
+      _generateSlab(oField.data(), chunkIndex, z);
+    }
+    return;
+  }
+  // a slab is a few hundred thousand noise evaluations, so a slab per job is coarse enough
+  _jobSystem->parallelFor(0, slabCount, 1, [&](size_t begin, size_t end) {
+    for (size_t z = begin; z < end; z++) {
+      _generateSlab(oField.data(), chunkIndex, static_cast<uint32_t>(z));
+    }
+  });
+}
+
+void ChunkFieldGenerator::_generateSlab(uint16_t *oField, glm::uvec3 chunkIndex,
+                                        uint32_t z) const {
+  uint32_t const dim = _voxelResolution + 1;
+
+  uint32_t simdWidth = 1;
+  void (*simdKernel)(ChunkFieldRow const &, uint16_t *) = nullptr;
+#if defined(CHUNK_FIELD_AVX2)
+  if (_simdPath == SimdPath::kAvx2) {
+    simdWidth  = kChunkFieldAvx2Width;
+    simdKernel = &generateChunkFieldRowAvx2;
+  }
+#endif
+#if defined(CHUNK_FIELD_NEON)
+  if (_simdPath == SimdPath::kNeon) {
+    simdWidth  = kChunkFieldNeonWidth;
+    simdKernel = &generateChunkFieldRowNeon;
+  }
+#endif
+
+  ChunkFieldRow row{};
+  row.voxelResolution = _voxelResolution;
+  row.chunkPos[0]     = static_cast<float>(chunkIndex.x);
+  row.chunkPos[1]     = static_cast<float>(chunkIndex.y);
+  row.chunkPos[2]     = static_cast<float>(chunkIndex.z);
+  // chunkDimension.xz / 2.0 of the shader, from the integer dimension
+  row.halfWorldDim[0] = static_cast<float>(static_cast<int32_t>(_chunksDim.x)) / 2.F;
+  row.halfWorldDim[1] = static_cast<float>(static_cast<int32_t>(_chunksDim.z)) / 2.F;
+  row.z               = z;
+
+  // the full lanes go through the simd kernel, the remaining voxels of the row through the scalar
+  uint32_t const simdEnd = simdKernel != nullptr ? dim / simdWidth * simdWidth : 0;
+  for (uint32_t y = 0; y < dim; y++) {
+    uint16_t *rowData = oField + (static_cast<size_t>(z) * dim + y) * dim;
+    row.y             = y;
+    if (simdEnd > 0) {
+      row.xBegin = 0;
+      row.xEnd   = simdEnd;
+      simdKernel(row, rowData);
+    }
+    row.xBegin = simdEnd;
+    row.xEnd   = dim;
+    generateChunkFieldRow<ScalarLanes>(row, rowData);
+  }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "glm/glm.hpp" // IWYU pragma: export
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// generates the chunk fields on the cpu, the values are the same as the ones written by
+// chunkFieldConstruction.comp, the packed block type and weight of every voxel, the rows are
+// vectorized with avx2 or neon when the cpu has them, the z-slabs are spread over the job system
+class ChunkFieldGenerator {
+public:
+  enum class SimdPath { kScalar, kAvx2, kNeon };
+
+  // the job system is optional, the slabs are generated on the calling thread without it
+  ChunkFieldGenerator(JobSystem *jobSystem, uint32_t voxelResolution, glm::uvec3 chunksDim);
+
+  // the field has getFieldSize() values in x, y, z order, the same layout as the chunk field image
+  void generate(std::vector<uint16_t> &oField, glm::uvec3 chunkIndex) const;
+
+  [[nodiscard]] size_t getFieldSize() const;
+  [[nodiscard]] SimdPath getSimdPath() const { return _simdPath; }
+  // the tools force the paths to compare them, falls back to the scalar path if not supported
+  void setSimdPath(SimdPath simdPath);
+
+  [[nodiscard]] static bool isSimdPathSupported(SimdPath simdPath);
+  [[nodiscard]] static char const *getSimdPathName(SimdPath simdPath);
+
+private:
+  JobSystem *_jobSystem;
+  uint32_t _voxelResolution;
+  glm::uvec3 _chunksDim;
+  SimdPath _simdPath = SimdPath::kScalar;
+
+  void _generateSlab(uint16_t *oField, glm::uvec3 chunkIndex, uint32_t z) const;
+};
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// the cpu port of chunkFieldConstruction.comp, the kernel is templated on the lanes, so the scalar,
+// avx2 and neon paths share the code, every operation is done in the order of the shader, and the
+// fp contraction is disabled for the kernel, so the paths are bit-exact with each other
+
+// a row is a line of voxels along x, y and z are the same for the whole row
+struct ChunkFieldRow {
+  uint32_t voxelResolution; // a chunk field has voxelResolution + 1 voxels along every axis
+  float chunkPos[3];
+  float halfWorldDim[2]; // half of the xz dimension of the world, in chunks
+  uint32_t y;
+  uint32_t z;
+  // the lanes are filled in order, so the count must be a multiple of the lane width
+  uint32_t xBegin;
+  uint32_t xEnd;
+};
+
+// the block types and the weight packing of blockTypeAndWeight.glsl
+uint32_t constexpr kChunkFieldBlockTypeEmpty = 0;
+uint32_t constexpr kChunkFieldBlockTypeDirt  = 1;
+uint32_t constexpr kChunkFieldBlockTypeSand  = 3;
+uint32_t constexpr kChunkFieldBlockTypeGrass = 4;
+uint32_t constexpr kChunkFieldWeightBits     = 12;
+uint32_t constexpr kChunkFieldWeightLevels   = (1U << kChunkFieldWeightBits) - 1;
+
+// the vectorized paths live in their own translation units, which are built with the instruction
+// sets enabled, see the cmake file
+uint32_t constexpr kChunkFieldAvx2Width = 8;
+uint32_t constexpr kChunkFieldNeonWidth = 4;
+void generateChunkFieldRowAvx2(ChunkFieldRow const &row, uint16_t *oRow);
+void generateChunkFieldRowNeon(ChunkFieldRow const &row, uint16_t *oRow);
+
+// the integer gradient hash of inoise.glsl, the signed overflow of the shader is done in unsigned
+template <typename L>
+void _chunkFieldHash(typename L::F &oGx, typename L::F &oGy, typename L::F &oGz,
+                     typename L::I px, typename L::I py, typename L::I pz) {
+  using I = typename L::I;
+
+  I nx = px * L::splatInt(127) + py * L::splatInt(311) + pz * L::splatInt(74);
+  I ny = px * L::splatInt(269) + py * L::splatInt(183) + pz * L::splatInt(246);
+  I nz = px * L::splatInt(113) + py * L::splatInt(271) + pz * L::splatInt(124);
+
+  auto const scramble = [](I n) {
+    n = L::template shiftLeft<13>(n) ^ n;
+    return n * (n * n * L::splatInt(15731) + L::splatInt(789221)) + L::splatInt(1376312589);
+  };
+  nx = scramble(nx);
+  ny = scramble(ny);
+  nz = scramble(nz);
+
+  I const mask    = L::splatInt(0x0fffffff);
+  auto const norm = L::splat(static_cast<float>(0x0fffffff));
+  oGx             = L::splat(-1.F) + L::splat(2.F) * L::toFloat(nx & mask) / norm;
+  oGy             = L::splat(-1.F) + L::splat(2.F) * L::toFloat(ny & mask) / norm;
+  oGz             = L::splat(-1.F) + L::splat(2.F) * L::toFloat(nz & mask) / norm;
+}
+
+// the value of noised in inoise.glsl, the derivatives are not used by the field
+template <typename L>
+typename L::F _chunkFieldNoise(typename L::F px, typename L::F py, typename L::F pz) {
+  using F = typename L::F;
+  using I = typename L::I;
+
+  F const floorX = L::floor(px);
+  F const floorY = L::floor(py);
+  F const floorZ = L::floor(pz);
+  I const ix     = L::toInt(floorX);
+  I const iy     = L::toInt(floorY);
+  I const iz     = L::toInt(floorZ);
+  F const fx     = px - floorX;
+  F const fy     = py - floorY;
+  F const fz     = pz - floorZ;
+
+  // quintic interpolant
+  F const ux = fx * fx * fx * (fx * (fx * L::splat(6.F) - L::splat(15.F)) + L::splat(10.F));
+  F const uy = fy * fy * fy * (fy * (fy * L::splat(6.F) - L::splat(15.F)) + L::splat(10.F));
+  F const uz = fz * fz * fz * (fz * (fz * L::splat(6.F) - L::splat(15.F)) + L::splat(10.F));
+
+  // the projections of the gradients of the corners, in the order of va to vh
+  F v[8];
+  for (uint32_t corner = 0; corner < 8; corner++) {
+    uint32_t const cx = corner & 1U;
+    uint32_t const cy = (corner >> 1) & 1U;
+    uint32_t const cz = (corner >> 2) & 1U;
+
+    F gx;
+    F gy;
+    F gz;
+    _chunkFieldHash<L>(gx, gy, gz, ix + L::splatInt(cx), iy + L::splatInt(cy),
+                       iz + L::splatInt(cz));
+    v[corner] = gx * (fx - L::splat(static_cast<float>(cx))) +
+                gy * (fy - L::splat(static_cast<float>(cy))) +
+                gz * (fz - L::splat(static_cast<float>(cz)));
+  }
+  F const &va = v[0];
+  F const &vb = v[1];
+  F const &vc = v[2];
+  F const &vd = v[3];
+  F const &ve = v[4];
+  F const &vf = v[5];
+  F const &vg = v[6];
+  F const &vh = v[7];
+
+  return va + ux * (vb - va) + uy * (vc - va) + uz * (ve - va) + ux * uy * (va - vb - vc + vd) +
+         uy * uz * (va - vc - ve + vg) + uz * ux * (va - vb - ve + vf) +
+         (L::negate(va) + vb + vc - vd + ve - vf - vg + vh) * ux * uy * uz;
+}
+
+template <typename L> void generateChunkFieldRow(ChunkFieldRow const &row, uint16_t *oRow) {
+  using F = typename L::F;
+  using I = typename L::I;
+
+  float const resolution = static_cast<float>(row.voxelResolution);
+  float const globalY    = row.chunkPos[1] + (static_cast<float>(row.y) - 0.5F) / resolution;
+  float const globalZ    = row.chunkPos[2] + (static_cast<float>(row.z) - 0.5F) / resolution;
+
+  // islandGradientFalloff, the world center is the half dimension
+  float const falloffEdge = std::min(row.halfWorldDim[0], row.halfWorldDim[1]);
+  float const toCenterZ   = row.halfWorldDim[1] - globalZ;
+
+  // the sand replaces the other blocks near the ground
+  uint32_t const solidBlockTypeOverride = globalY < 0.1F ? kChunkFieldBlockTypeSand : 0;
+
+  float constexpr kWeightBoundary = 1.F / 100.F;
+
+  for (uint32_t x = row.xBegin; x < row.xEnd; x += L::kWidth) {
+    F const globalX = L::splat(row.chunkPos[0]) +
+                      (L::toFloat(L::iota(x)) - L::splat(0.5F)) / L::splat(resolution);
+
+    // computeNoise, the fbm of 5 octaves
+    F total         = L::splat(0.F);
+    float amplitude = 0.5F;
+    float frequency = 2.F;
+    for (uint32_t octave = 0; octave < 5; octave++) {
+      F const noise = _chunkFieldNoise<L>(globalX * L::splat(frequency),
+                                          L::splat(globalY) * L::splat(frequency),
+                                          L::splat(globalZ) * L::splat(frequency));
+      total = total + L::splat(amplitude) * (noise + L::splat(0.5F));
+      amplitude *= 0.3F;
+      frequency *= 2.2F;
+    }
+
+    F const toCenterX = L::splat(row.halfWorldDim[0]) - globalX;
+    F const distance =
+        L::sqrt(toCenterX * toCenterX + L::splat(toCenterZ) * L::splat(toCenterZ));
+    F const t = L::min(L::max((distance - L::splat(0.F)) / L::splat(falloffEdge - 0.F),
+                              L::splat(0.F)),
+                       L::splat(1.F));
+    F const falloff = L::splat(1.F) - t * t * (L::splat(3.F) - L::splat(2.F) * t);
+
+    F const weight = total * falloff - L::splat(globalY);
+
+    // getBlockTypeFromWeight
+    I blockType = L::select(L::lessThan(weight, L::splat(0.01F)),
+                            L::splatInt(kChunkFieldBlockTypeGrass),
+                            L::splatInt(kChunkFieldBlockTypeDirt));
+    if (solidBlockTypeOverride != 0) {
+      blockType = L::splatInt(solidBlockTypeOverride);
+    }
+    blockType = L::select(L::lessThan(weight, L::splat(0.F)),
+                          L::splatInt(kChunkFieldBlockTypeEmpty), blockType);
+
+    // _packWeight
+    F const clamped =
+        L::min(L::max(weight, L::splat(-kWeightBoundary)), L::splat(kWeightBoundary));
+    F const f01 = (clamped - L::splat(-kWeightBoundary)) /
+                  L::splat(kWeightBoundary - -kWeightBoundary);
+    I const packedWeight = L::toInt(f01 * L::splat(static_cast<float>(kChunkFieldWeightLevels)));
+
+    L::store(oRow + x, L::template shiftLeft<kChunkFieldWeightBits>(blockType) | packedWeight);
+  }
+}
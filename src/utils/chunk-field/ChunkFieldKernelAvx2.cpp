@@ -0,0 +1,71 @@
+#include "ChunkFieldKernel.hpp"
+
+// built with avx2 enabled, see the cmake file, only called once the cpu is checked
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace {
+
+struct Avx2Float {
+  __m256 v;
+};
+struct Avx2Int {
+  __m256i v;
+};
+
+Avx2Float operator+(Avx2Float a, Avx2Float b) { return {_mm256_add_ps(a.v, b.v)}; }
+Avx2Float operator-(Avx2Float a, Avx2Float b) { return {_mm256_sub_ps(a.v, b.v)}; }
+Avx2Float operator*(Avx2Float a, Avx2Float b) { return {_mm256_mul_ps(a.v, b.v)}; }
+Avx2Float operator/(Avx2Float a, Avx2Float b) { return {_mm256_div_ps(a.v, b.v)}; }
+
+Avx2Int operator+(Avx2Int a, Avx2Int b) { return {_mm256_add_epi32(a.v, b.v)}; }
+Avx2Int operator*(Avx2Int a, Avx2Int b) { return {_mm256_mullo_epi32(a.v, b.v)}; }
+Avx2Int operator^(Avx2Int a, Avx2Int b) { return {_mm256_xor_si256(a.v, b.v)}; }
+Avx2Int operator&(Avx2Int a, Avx2Int b) { return {_mm256_and_si256(a.v, b.v)}; }
+Avx2Int operator|(Avx2Int a, Avx2Int b) { return {_mm256_or_si256(a.v, b.v)}; }
+
+struct Avx2Lanes {
+  using F = Avx2Float;
+  using I = Avx2Int;
+  using M = __m256;
+
+  static constexpr uint32_t kWidth = kChunkFieldAvx2Width;
+
+  static F splat(float f) { return {_mm256_set1_ps(f)}; }
+  static I splatInt(uint32_t i) { return {_mm256_set1_epi32(static_cast<int>(i))}; }
+  static I iota(uint32_t i) {
+    return {_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)),
+                             _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))};
+  }
+
+  static F negate(F f) { return {_mm256_xor_ps(f.v, _mm256_set1_ps(-0.F))}; }
+  static F floor(F f) { return {_mm256_floor_ps(f.v)}; }
+  static F sqrt(F f) { return {_mm256_sqrt_ps(f.v)}; }
+  static F min(F a, F b) { return {_mm256_min_ps(a.v, b.v)}; }
+  static F max(F a, F b) { return {_mm256_max_ps(a.v, b.v)}; }
+
+  static I toInt(F f) { return {_mm256_cvttps_epi32(f.v)}; }
+  static F toFloat(I i) { return {_mm256_cvtepi32_ps(i.v)}; }
+  template <uint32_t kBits> static I shiftLeft(I i) { return {_mm256_slli_epi32(i.v, kBits)}; }
+
+  static M lessThan(F a, F b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+  static I select(M mask, I ifTrue, I ifFalse) {
+    return {_mm256_blendv_epi8(ifFalse.v, ifTrue.v, _mm256_castps_si256(mask))};
+  }
+
+  // the packed values fit in 15 bits, so the saturation never kicks in, packus works within the
+  // 128-bit halves, the permute brings the two halves together
+  static void store(uint16_t *dst, I i) {
+    __m256i const packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(i.v, i.v), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(packed));
+  }
+};
+
+} // namespace
+
+void generateChunkFieldRowAvx2(ChunkFieldRow const &row, uint16_t *oRow) {
+  generateChunkFieldRow<Avx2Lanes>(row, oRow);
+}
+
+#endif // __AVX2__
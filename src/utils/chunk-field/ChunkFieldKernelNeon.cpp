@@ -0,0 +1,64 @@
+#include "ChunkFieldKernel.hpp"
+
+// neon is always there on arm64, floor needs armv8
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+#include <arm_neon.h>
+
+namespace {
+
+struct NeonFloat {
+  float32x4_t v;
+};
+struct NeonInt {
+  uint32x4_t v;
+};
+
+NeonFloat operator+(NeonFloat a, NeonFloat b) { return {vaddq_f32(a.v, b.v)}; }
+NeonFloat operator-(NeonFloat a, NeonFloat b) { return {vsubq_f32(a.v, b.v)}; }
+NeonFloat operator*(NeonFloat a, NeonFloat b) { return {vmulq_f32(a.v, b.v)}; }
+NeonFloat operator/(NeonFloat a, NeonFloat b) { return {vdivq_f32(a.v, b.v)}; }
+
+NeonInt operator+(NeonInt a, NeonInt b) { return {vaddq_u32(a.v, b.v)}; }
+NeonInt operator*(NeonInt a, NeonInt b) { return {vmulq_u32(a.v, b.v)}; }
+NeonInt operator^(NeonInt a, NeonInt b) { return {veorq_u32(a.v, b.v)}; }
+NeonInt operator&(NeonInt a, NeonInt b) { return {vandq_u32(a.v, b.v)}; }
+NeonInt operator|(NeonInt a, NeonInt b) { return {vorrq_u32(a.v, b.v)}; }
+
+struct NeonLanes {
+  using F = NeonFloat;
+  using I = NeonInt;
+  using M = uint32x4_t;
+
+  static constexpr uint32_t kWidth = kChunkFieldNeonWidth;
+
+  static F splat(float f) { return {vdupq_n_f32(f)}; }
+  static I splatInt(uint32_t i) { return {vdupq_n_u32(i)}; }
+  static I iota(uint32_t i) {
+    uint32_t const offsets[4] = {0, 1, 2, 3};
+    return {vaddq_u32(vdupq_n_u32(i), vld1q_u32(offsets))};
+  }
+
+  static F negate(F f) { return {vnegq_f32(f.v)}; }
+  static F floor(F f) { return {vrndmq_f32(f.v)}; }
+  static F sqrt(F f) { return {vsqrtq_f32(f.v)}; }
+  static F min(F a, F b) { return {vminq_f32(a.v, b.v)}; }
+  static F max(F a, F b) { return {vmaxq_f32(a.v, b.v)}; }
+
+  static I toInt(F f) { return {vreinterpretq_u32_s32(vcvtq_s32_f32(f.v))}; }
+  static F toFloat(I i) { return {vcvtq_f32_s32(vreinterpretq_s32_u32(i.v))}; }
+  template <uint32_t kBits> static I shiftLeft(I i) { return {vshlq_n_u32(i.v, kBits)}; }
+
+  static M lessThan(F a, F b) { return vcltq_f32(a.v, b.v); }
+  static I select(M mask, I ifTrue, I ifFalse) { return {vbslq_u32(mask, ifTrue.v, ifFalse.v)}; }
+
+  static void store(uint16_t *dst, I i) { vst1_u16(dst, vmovn_u32(i.v)); }
+};
+
+} // namespace
+
+void generateChunkFieldRowNeon(ChunkFieldRow const &row, uint16_t *oRow) {
+  generateChunkFieldRow<NeonLanes>(row, oRow);
+}
+
+#endif // __aarch64__ || _M_ARM64
@@ -0,0 +1,149 @@
+#include "TextureArrayBlob.hpp"
+
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace {
+// "TXAB"
+constexpr uint32_t kMagic   = 0x42415854;
+constexpr uint32_t kVersion = 1;
+
+// fnv-1a over 8 byte words, the tail is padded with zeros
+uint64_t _checksum(void const *data, uint64_t size) {
+  constexpr uint64_t kOffsetBasis = 14695981039346656037ULL;
+  constexpr uint64_t kPrime       = 1099511628211ULL;
+
+  auto const *bytes = static_cast<unsigned char const *>(data);
+  uint64_t hash     = kOffsetBasis;
+  for (uint64_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + offset, std::min<uint64_t>(sizeof(uint64_t), size - offset));
+    hash = (hash ^ word) * kPrime;
+  }
+  return hash;
+}
+} // namespace
+
+std::unique_ptr<TextureArrayBlob> TextureArrayBlob::map(std::string const &path, Logger *logger) {
+  // the constructor is private
+  std::unique_ptr<TextureArrayBlob> blob(new TextureArrayBlob());
+
+#ifdef _WIN32
+  HANDLE const fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  blob->_fileHandle = fileHandle;
+
+  LARGE_INTEGER fileSize{};
+  GetFileSizeEx(fileHandle, &fileSize);
+  blob->_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+  if (blob->_mappedSize < sizeof(Header)) {
+    logger->warn("texture array blob: {} is truncated", path);
+    return nullptr;
+  }
+
+  blob->_mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (blob->_mappingHandle == nullptr) {
+    logger->warn("texture array blob: failed to map {}", path);
+    return nullptr;
+  }
+  void *mappedAddr = MapViewOfFile(blob->_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+  if (mappedAddr == nullptr) {
+    logger->warn("texture array blob: failed to map {}", path);
+    return nullptr;
+  }
+#else
+  blob->_fileDescriptor = open(path.c_str(), O_RDONLY);
+  if (blob->_fileDescriptor < 0) {
+    return nullptr;
+  }
+
+  struct stat fileStat {};
+  fstat(blob->_fileDescriptor, &fileStat);
+  blob->_mappedSize = static_cast<size_t>(fileStat.st_size);
+  if (blob->_mappedSize < sizeof(Header)) {
+    logger->warn("texture array blob: {} is truncated", path);
+    return nullptr;
+  }
+
+  void *mappedAddr =
+      mmap(nullptr, blob->_mappedSize, PROT_READ, MAP_PRIVATE, blob->_fileDescriptor, 0);
+  if (mappedAddr == MAP_FAILED) {
+    logger->warn("texture array blob: failed to map {}", path);
+    return nullptr;
+  }
+#endif // _WIN32
+  blob->_header = static_cast<Header const *>(mappedAddr);
+
+  Header const &header = *blob->_header;
+  if (header.magic != kMagic || header.version != kVersion) {
+    logger->warn("texture array blob: {} has an unknown format", path);
+    return nullptr;
+  }
+  uint64_t const expectedSize = static_cast<uint64_t>(header.width) * header.height *
+                                header.layerCount * header.bytesPerPixel;
+  if (header.dataSize != expectedSize || blob->_mappedSize < sizeof(Header) + header.dataSize) {
+    logger->warn("texture array blob: {} is truncated", path);
+    return nullptr;
+  }
+  if (_checksum(blob->getData(), header.dataSize) != header.checksum) {
+    logger->warn("texture array blob: the checksum of {} does not match", path);
+    return nullptr;
+  }
+  return blob;
+}
+
+bool TextureArrayBlob::write(std::string const &path, Header header, void const *data,
+                             Logger *logger) {
+  header.magic    = kMagic;
+  header.version  = kVersion;
+  header.dataSize = static_cast<uint64_t>(header.width) * header.height * header.layerCount *
+                    header.bytesPerPixel;
+  header.checksum = _checksum(data, header.dataSize);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    logger->error("texture array blob: failed to open {} for writing", path);
+    return false;
+  }
+  file.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+  file.write(static_cast<char const *>(data), static_cast<std::streamsize>(header.dataSize));
+  return file.good();
+}
+
+TextureArrayBlob::~TextureArrayBlob() {
+#ifdef _WIN32
+  if (_header != nullptr) {
+    UnmapViewOfFile(_header);
+  }
+  if (_mappingHandle != nullptr) {
+    CloseHandle(_mappingHandle);
+  }
+  if (_fileHandle != nullptr) {
+    CloseHandle(_fileHandle);
+  }
+#else
+  if (_header != nullptr) {
+    munmap(const_cast<Header *>(_header), _mappedSize);
+  }
+  if (_fileDescriptor >= 0) {
+    close(_fileDescriptor);
+  }
+#endif // _WIN32
+}
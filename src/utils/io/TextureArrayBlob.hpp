@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class Logger;
+
+// a texture array packed into a single uncompressed file, a header followed by the tightly packed
+// layers, so it can be mapped and uploaded without decoding
+class TextureArrayBlob {
+public:
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t layerCount;
+    uint32_t bytesPerPixel;
+    uint64_t dataSize;
+    // of the data only
+    uint64_t checksum;
+  };
+
+  // maps the blob read-only, returns nullptr if it is missing, or if its header or checksum does
+  // not match
+  static std::unique_ptr<TextureArrayBlob> map(std::string const &path, Logger *logger);
+
+  // the size and the checksum of the header are filled here, returns false if the file cannot be
+  // written
+  static bool write(std::string const &path, Header header, void const *data, Logger *logger);
+
+  ~TextureArrayBlob();
+
+  // disable copy and move
+  TextureArrayBlob(TextureArrayBlob const &)            = delete;
+  TextureArrayBlob(TextureArrayBlob &&)                 = delete;
+  TextureArrayBlob &operator=(TextureArrayBlob const &) = delete;
+  TextureArrayBlob &operator=(TextureArrayBlob &&)      = delete;
+
+  [[nodiscard]] Header const &getHeader() const { return *_header; }
+  // valid as long as the blob is
+  [[nodiscard]] void const *getData() const { return _header + 1; }
+
+private:
+  TextureArrayBlob() = default;
+
+  Header const *_header = nullptr;
+  size_t _mappedSize    = 0;
+
+#ifdef _WIN32
+  void *_fileHandle    = nullptr;
+  void *_mappingHandle = nullptr;
+#else
+  int _fileDescriptor = -1;
+#endif // _WIN32
+};
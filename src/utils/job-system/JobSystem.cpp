@@ -0,0 +1,225 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+struct JobSystem::Job {
+  std::function<void()> task;
+  // the unfinished dependencies, and one more that is held while the job is being scheduled
+  std::atomic<size_t> pendingDependencyCount{0};
+
+  std::mutex mutex;
+  // guarded by the mutex, so no dependent is added after the job has released them
+  std::vector<JobHandle> dependents;
+  std::atomic<bool> finished{false};
+};
+
+namespace {
+// the job system that the current thread works for, and its worker index
+thread_local JobSystem const *tJobSystem = nullptr;
+thread_local size_t tWorkerIndex         = 0;
+// where the current thread starts stealing from, rotated so the victims are spread out
+thread_local size_t tStealOffset = 0;
+} // namespace
+
+JobSystem::JobSystem(size_t workerCount) {
+  if (workerCount == 0) {
+    workerCount = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+  }
+
+  for (size_t i = 0; i < workerCount + 1; i++) {
+    _queues.push_back(std::make_unique<JobQueue>());
+  }
+  _workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; i++) {
+    _workers.emplace_back([this, i]() { _workerLoop(i); });
+  }
+}
+
+// the queued jobs are drained before the workers stop
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> const lock(_sleepMutex);
+    _stopping = true;
+  }
+  _wakeCondition.notify_all();
+  for (auto &worker : _workers) {
+    worker.join();
+  }
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> task,
+                                         std::vector<JobHandle> const &dependencies) {
+  auto job                    = std::make_shared<Job>();
+  job->task                   = std::move(task);
+  job->pendingDependencyCount = dependencies.size() + 1;
+
+  for (auto const &dependency : dependencies) {
+    std::lock_guard<std::mutex> const lock(dependency->mutex);
+    if (dependency->finished) {
+      job->pendingDependencyCount--;
+    } else {
+      dependency->dependents.push_back(job);
+    }
+  }
+
+  // the scheduling hold is released last, so the job is enqueued exactly once
+  if (job->pendingDependencyCount.fetch_sub(1) == 1) {
+    _enqueue(job);
+  }
+  return job;
+}
+
+void JobSystem::wait(JobHandle const &job) {
+  while (!isFinished(job)) {
+    if (!_tryRunOne()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void JobSystem::wait(std::vector<JobHandle> const &jobs) {
+  for (auto const &job : jobs) {
+    wait(job);
+  }
+}
+
+bool JobSystem::isFinished(JobHandle const &job) {
+  return job->finished.load(std::memory_order_acquire);
+}
+
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grainSize,
+                            std::function<void(size_t, size_t)> const &body) {
+  if (begin >= end) {
+    return;
+  }
+  grainSize               = std::max<size_t>(grainSize, 1);
+  size_t const chunkCount = (end - begin + grainSize - 1) / grainSize;
+  if (chunkCount == 1 || _workers.empty()) {
+    body(begin, end);
+    return;
+  }
+
+  // the chunks are handed out by a counter, instead of a job per chunk, so a fine grain costs an
+  // atomic increment per chunk, the helpers that start late find nothing left and return
+  std::atomic<size_t> nextChunk{0};
+  auto runChunks = [&]() {
+    for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+      size_t const chunkBegin = begin + chunk * grainSize;
+      body(chunkBegin, std::min(chunkBegin + grainSize, end));
+    }
+  };
+
+  size_t const helperCount = std::min(_workers.size(), chunkCount - 1);
+  std::vector<JobHandle> helpers{};
+  helpers.reserve(helperCount);
+  for (size_t i = 0; i < helperCount; i++) {
+    helpers.push_back(schedule(runChunks));
+  }
+  runChunks();
+  wait(helpers);
+}
+
+void JobSystem::_workerLoop(size_t workerIndex) {
+  tJobSystem   = this;
+  tWorkerIndex = workerIndex;
+  tStealOffset = workerIndex + 1;
+
+  while (true) {
+    if (_tryRunOne()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _wakeCondition.wait(lock, [this]() { return _stopping || _queuedJobCount > 0; });
+    if (_stopping && _queuedJobCount == 0) {
+      return;
+    }
+  }
+}
+
+void JobSystem::_enqueue(JobHandle job) {
+  size_t const queueIndex = tJobSystem == this ? tWorkerIndex : _workers.size();
+  {
+    std::lock_guard<std::mutex> const lock(_queues[queueIndex]->mutex);
+    _queues[queueIndex]->jobs.push_back(std::move(job));
+  }
+  _queuedJobCount++;
+
+  // the sleeping workers check the count under the lock, so the wake up cannot be missed
+  { std::lock_guard<std::mutex> const lock(_sleepMutex); }
+  _wakeCondition.notify_one();
+}
+
+JobSystem::JobHandle JobSystem::_takeJob() {
+  auto popFrom = [this](JobQueue &queue, bool fromBack) -> JobHandle {
+    std::lock_guard<std::mutex> const lock(queue.mutex);
+    if (queue.jobs.empty()) {
+      return nullptr;
+    }
+    JobHandle job = nullptr;
+    if (fromBack) {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+    } else {
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+    }
+    _queuedJobCount--;
+    return job;
+  };
+
+  bool const isWorker = tJobSystem == this;
+
+  // the own queue is used as a stack, the most recent job is the most likely to be cache hot
+  if (isWorker) {
+    if (JobHandle job = popFrom(*_queues[tWorkerIndex], true)) {
+      return job;
+    }
+  }
+
+  // the shared queue and the other workers are taken from the front, in fifo order
+  size_t const sharedQueueIndex = _workers.size();
+  if (JobHandle job = popFrom(*_queues[sharedQueueIndex], false)) {
+    return job;
+  }
+  for (size_t i = 0; i < _workers.size(); i++) {
+    size_t const victimIndex = (tStealOffset + i) % _workers.size();
+    if (isWorker && victimIndex == tWorkerIndex) {
+      continue;
+    }
+    if (JobHandle job = popFrom(*_queues[victimIndex], false)) {
+      tStealOffset = victimIndex;
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+bool JobSystem::_tryRunOne() {
+  if (_queuedJobCount == 0) {
+    return false;
+  }
+  JobHandle const job = _takeJob();
+  if (job == nullptr) {
+    return false;
+  }
+  _run(job);
+  return true;
+}
+
+void JobSystem::_run(JobHandle const &job) {
+  job->task();
+  // releases the captures
+  job->task = nullptr;
+
+  std::vector<JobHandle> dependents{};
+  {
+    std::lock_guard<std::mutex> const lock(job->mutex);
+    job->finished.store(true, std::memory_order_release);
+    dependents.swap(job->dependents);
+  }
+  for (auto &dependent : dependents) {
+    if (dependent->pendingDependencyCount.fetch_sub(1) == 1) {
+      _enqueue(std::move(dependent));
+    }
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// a work-stealing thread pool, every worker owns a deque, the jobs scheduled by a worker are pushed
+// to its own deque and taken back in lifo order, the idle workers steal from the other end, the
+// jobs scheduled by the other threads go to a shared queue
+// the threads that wait for a job run the other jobs meanwhile, so waiting inside a job is fine
+class JobSystem {
+public:
+  struct Job;
+  using JobHandle = std::shared_ptr<Job>;
+
+  // 0 means one worker less than the hardware threads, as the waiting thread helps as well
+  explicit JobSystem(size_t workerCount = 0);
+  ~JobSystem();
+
+  // disable copy and move
+  JobSystem(JobSystem const &)            = delete;
+  JobSystem(JobSystem &&)                 = delete;
+  JobSystem &operator=(JobSystem const &) = delete;
+  JobSystem &operator=(JobSystem &&)      = delete;
+
+  // the job runs once all of its dependencies are finished, which may be the case already, the
+  // task should not throw, use async for the tasks that may
+  JobHandle schedule(std::function<void()> task, std::vector<JobHandle> const &dependencies = {});
+
+  // the result and the exception of the task are delivered through the future
+  template <typename Func> auto async(Func &&func) -> std::future<std::invoke_result_t<Func>> {
+    using Result      = std::invoke_result_t<Func>;
+    auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+    std::future<Result> future = packagedTask->get_future();
+    schedule([packagedTask]() { (*packagedTask)(); });
+    return future;
+  }
+
+  void wait(JobHandle const &job);
+  void wait(std::vector<JobHandle> const &jobs);
+  [[nodiscard]] static bool isFinished(JobHandle const &job);
+
+  // calls body(chunkBegin, chunkEnd) for the chunks of grainSize elements of [begin, end), and
+  // returns once all of them are done, the calling thread takes chunks as well
+  void parallelFor(size_t begin, size_t end, size_t grainSize,
+                   std::function<void(size_t, size_t)> const &body);
+
+  [[nodiscard]] size_t getWorkerCount() const { return _workers.size(); }
+
+private:
+  struct JobQueue {
+    std::mutex mutex;
+    std::deque<JobHandle> jobs;
+  };
+
+  // one per worker, followed by the shared queue of the other threads
+  std::vector<std::unique_ptr<JobQueue>> _queues;
+  std::vector<std::thread> _workers;
+
+  std::mutex _sleepMutex;
+  std::condition_variable _wakeCondition;
+  std::atomic<size_t> _queuedJobCount{0};
+  bool _stopping = false;
+
+  void _workerLoop(size_t workerIndex);
+  void _enqueue(JobHandle job);
+  // returns false if no job is found in any of the queues
+  bool _tryRunOne();
+  [[nodiscard]] JobHandle _takeJob();
+  void _run(JobHandle const &job);
+};
@@ -1,6 +1,7 @@
 #include "ShaderCompiler.hpp"
 
 #include "CustomFileIncluder.hpp"
+#include "utils/job-system/JobSystem.hpp"
 #include "utils/logger/Logger.hpp"
 
 struct PathInfo {
@@ -25,7 +26,7 @@ PathInfo _getFullDirAndFileName(const std::string &fullPath, Logger *logger) {
 }
 }; // namespace
 
-ShaderCompiler::ShaderCompiler(Logger *logger, std::function<void(std::string const &)> includeCallback) : _logger(logger) {
+ShaderCompiler::ShaderCompiler(Logger *logger, std::function<void(std::string const &)> includeCallback) : _logger(logger), _includeCallback(includeCallback) {
   std::unique_ptr<CustomFileIncluder> fileIncluder = std::make_unique<CustomFileIncluder>(logger, includeCallback);
 
   // _defaultOptions takes the ownership of fileIncluder, but doesn't provide a way to retrieve it,
@@ -41,6 +42,15 @@ ShaderCompiler::ShaderCompiler(Logger *logger, std::function<void(std::string co
 std::optional<std::vector<uint32_t>>
 ShaderCompiler::compileComputeShader(const std::string &fullPathToFile,
                                      std::string const &sourceCode) {
+  if (auto precompiledShader = _takePrecompiledShader(fullPathToFile)) {
+    if (_includeCallback != nullptr) {
+      for (auto const &includedFile : precompiledShader->includedFiles) {
+        _includeCallback(includedFile);
+      }
+    }
+    return std::move(precompiledShader->code);
+  }
+
   auto const fullDirAndFileName = _getFullDirAndFileName(fullPathToFile, _logger);
 
   _fileIncluder->setIncludeDir(fullDirAndFileName.fullPathToDir);
@@ -60,3 +70,58 @@ ShaderCompiler::compileComputeShader(const std::string &fullPathToFile,
   }
   return std::vector<uint32_t>(compilationResult.cbegin(), compilationResult.cend());
 }
+
+void ShaderCompiler::addMacroDefinition(std::string const &name, std::string const &value) {
+  _defaultOptions.AddMacroDefinition(name, value);
+
+  std::lock_guard<std::mutex> const lock(_precompiledShadersMutex);
+  _precompiledShaders.clear();
+}
+
+void ShaderCompiler::precompileComputeShaders(std::vector<std::string> const &fullPathsToFiles,
+                                              JobSystem *jobSystem) {
+  jobSystem->parallelFor(0, fullPathsToFiles.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      std::string const &fullPathToFile = fullPathsToFiles[i];
+      auto const fullDirAndFileName     = _getFullDirAndFileName(fullPathToFile, _logger);
+
+      // the shared includer is not thread safe, so every compilation gets its own, which records
+      // the included files instead of reporting them from the worker
+      PrecompiledShader precompiledShader{};
+      auto fileIncluder = std::make_unique<CustomFileIncluder>(
+          _logger, [&precompiledShader](std::string const &fullPathToIncludedFile) {
+            precompiledShader.includedFiles.push_back(fullPathToIncludedFile);
+          });
+      fileIncluder->setIncludeDir(fullDirAndFileName.fullPathToDir);
+      shaderc::CompileOptions options(_defaultOptions);
+      options.SetIncluder(std::move(fileIncluder));
+
+      std::string const sourceCode =
+          ShaderFileReader::readShaderSourceCode(fullPathToFile, _logger);
+      shaderc::SpvCompilationResult const compilationResult =
+          CompileGlslToSpv(sourceCode, shaderc_glsl_compute_shader,
+                           fullDirAndFileName.fileName.c_str(), options);
+
+      // the failed ones are compiled again by the pipelines, which report the errors
+      if (compilationResult.GetCompilationStatus() != shaderc_compilation_status_success) {
+        continue;
+      }
+      precompiledShader.code.assign(compilationResult.cbegin(), compilationResult.cend());
+
+      std::lock_guard<std::mutex> const lock(_precompiledShadersMutex);
+      _precompiledShaders[fullPathToFile] = std::move(precompiledShader);
+    }
+  });
+}
+
+std::optional<ShaderCompiler::PrecompiledShader>
+ShaderCompiler::_takePrecompiledShader(std::string const &path) {
+  std::lock_guard<std::mutex> const lock(_precompiledShadersMutex);
+  auto it = _precompiledShaders.find(path);
+  if (it == _precompiledShaders.end()) {
+    return std::nullopt;
+  }
+  PrecompiledShader precompiledShader = std::move(it->second);
+  _precompiledShaders.erase(it);
+  return precompiledShader;
+}
@@ -5,11 +5,15 @@
 
 #include <cstdint>
 #include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class Logger;
 class CustomFileIncluder;
+class JobSystem;
 
 class ShaderCompiler : public shaderc::Compiler {
 public:
@@ -19,9 +23,30 @@ public:
   std::optional<std::vector<uint32_t>> compileComputeShader(const std::string &fullPathToFile,
                                                             std::string const &sourceCode);
 
+  // the macro is visible to all the shaders compiled afterwards, as if defined by -D, the
+  // precompiled shaders are dropped
+  void addMacroDefinition(std::string const &name, std::string const &value = "");
+
+  // compiles the shaders in parallel on the job system, the result of a file is taken by the next
+  // compileComputeShader call of it, which replays the include callbacks of the file, so the
+  // pipelines created afterwards skip the serial compilation, safe to call from a job
+  void precompileComputeShaders(std::vector<std::string> const &fullPathsToFiles,
+                                JobSystem *jobSystem);
+
 private:
+  struct PrecompiledShader {
+    std::vector<uint32_t> code;
+    std::vector<std::string> includedFiles;
+  };
+
   Logger *_logger;
   shaderc::CompileOptions _defaultOptions;
   CustomFileIncluder *_fileIncluder;
+  std::function<void(std::string const &)> _includeCallback;
+
+  std::mutex _precompiledShadersMutex;
+  std::unordered_map<std::string, PrecompiledShader> _precompiledShaders;
+
+  [[nodiscard]] std::optional<PrecompiledShader> _takePrecompiledShader(std::string const &path);
 
 }; // namespace ShaderCompiler
\ No newline at end of file
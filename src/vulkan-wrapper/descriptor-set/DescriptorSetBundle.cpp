@@ -1,15 +1,23 @@
 #include "DescriptorSetBundle.hpp"
 
+#include "app-context/DeletionQueue.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
 
 #include "../memory/Buffer.hpp"
 #include "../memory/BufferBundle.hpp"
+#include "../memory/DynamicUniformBuffer.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 DescriptorSetBundle::~DescriptorSetBundle() {
-  vkDestroyDescriptorSetLayout(_appContext->getDevice(), _descriptorSetLayout, nullptr);
-  vkDestroyDescriptorPool(_appContext->getDevice(), _descriptorPool, nullptr);
+  // the descriptor sets might still be bound by the frames in flight
+  _appContext->getDeletionQueue()->push([device              = _appContext->getDevice(),
+                                         descriptorSetLayout = _descriptorSetLayout,
+                                         descriptorPool      = _descriptorPool]() {
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+  });
 }
 
 void DescriptorSetBundle::bindUniformBufferBundle(uint32_t bindingSlot,
@@ -22,6 +30,26 @@ void DescriptorSetBundle::bindUniformBufferBundle(uint32_t bindingSlot,
   _uniformBufferBundles.emplace_back(bindingSlot, bufferBundle);
 }
 
+// the buffer holds the data of every frame, so it can be bound to a bundle of any size
+void DescriptorSetBundle::bindDynamicUniformBuffer(uint32_t bindingSlot,
+                                                   DynamicUniformBuffer *buffer) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+
+  _boundedSlots.insert(bindingSlot);
+  _dynamicUniformBuffers.emplace_back(bindingSlot, buffer);
+  // the dynamic offsets are consumed in the order of the binding numbers
+  std::sort(_dynamicUniformBuffers.begin(), _dynamicUniformBuffers.end());
+}
+
+std::vector<uint32_t> DescriptorSetBundle::getDynamicOffsets(size_t frameIndex) const {
+  std::vector<uint32_t> dynamicOffsets{};
+  dynamicOffsets.reserve(_dynamicUniformBuffers.size());
+  for (auto const &[_, buffer] : _dynamicUniformBuffers) {
+    dynamicOffsets.push_back(buffer->getDynamicOffset(frameIndex));
+  }
+  return dynamicOffsets;
+}
+
 void DescriptorSetBundle::bindStorageImage(uint32_t bindingSlot, Image *storageImage) {
   // just like the func above
   assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
@@ -66,6 +94,13 @@ void DescriptorSetBundle::_createDescriptorPool() {
         VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniformBufferSize});
   }
 
+  auto dynamicUniformBufferSize =
+      static_cast<uint32_t>(_dynamicUniformBuffers.size() * _bundleSize);
+  if (dynamicUniformBufferSize > 0) {
+    poolSizes.emplace_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                                dynamicUniformBufferSize});
+  }
+
   auto storageImageSize = static_cast<uint32_t>(_storageImages.size());
   if (storageImageSize > 0) {
     poolSizes.emplace_back(
@@ -109,6 +144,15 @@ void DescriptorSetBundle::_createDescriptorSetLayout() {
     bindings.push_back(uboLayoutBinding);
   }
 
+  for (auto const &[bindingNo, _] : _dynamicUniformBuffers) {
+    VkDescriptorSetLayoutBinding uboLayoutBinding{};
+    uboLayoutBinding.binding         = bindingNo;
+    uboLayoutBinding.descriptorCount = 1;
+    uboLayoutBinding.descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    uboLayoutBinding.stageFlags      = _shaderStageFlags;
+    bindings.push_back(uboLayoutBinding);
+  }
+
   for (auto const &[bindingNo, _] : _storageImages) {
     VkDescriptorSetLayoutBinding samplerLayoutBinding{};
     samplerLayoutBinding.binding         = bindingNo;
@@ -168,6 +212,23 @@ void DescriptorSetBundle::_createDescriptorSet(uint32_t descriptorSetIndex) {
     descriptorWrites.push_back(descriptorWrite);
   }
 
+  std::vector<VkDescriptorBufferInfo> dynamicUniformBufferInfos{};
+  dynamicUniformBufferInfos.reserve(_dynamicUniformBuffers.size());
+  for (auto const &[_, buffer] : _dynamicUniformBuffers) {
+    dynamicUniformBufferInfos.push_back(buffer->getDescriptorInfo());
+  }
+  for (uint32_t i = 0; i < _dynamicUniformBuffers.size(); i++) {
+    auto const &[bindingNo, _] = _dynamicUniformBuffers[i];
+    VkWriteDescriptorSet descriptorWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    descriptorWrite.dstSet          = dstSet;
+    descriptorWrite.dstBinding      = bindingNo;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo     = &dynamicUniformBufferInfos[i];
+    descriptorWrites.push_back(descriptorWrite);
+  }
+
   std::vector<VkDescriptorImageInfo> storageImageInfos{};
   storageImageInfos.reserve(_storageImages.size());
   for (auto const &[_, storageImage] : _storageImages) {
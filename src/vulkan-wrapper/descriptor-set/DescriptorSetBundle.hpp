@@ -10,6 +10,7 @@
 
 class Buffer;
 class BufferBundle;
+class DynamicUniformBuffer;
 class VulkanApplicationContext;
 class Logger;
 // for easy management of descriptor sets, auto resource management
@@ -29,8 +30,11 @@ public:
   [[nodiscard]] size_t getBundleSize() const { return _bundleSize; }
   [[nodiscard]] VkDescriptorSet &getDescriptorSet(size_t index) { return _descriptorSets[index]; }
   [[nodiscard]] VkDescriptorSetLayout &getDescriptorSetLayout() { return _descriptorSetLayout; }
+  // the offsets of the dynamic uniform buffers for the frame, in the order of their bindings
+  [[nodiscard]] std::vector<uint32_t> getDynamicOffsets(size_t frameIndex) const;
 
   void bindUniformBufferBundle(uint32_t bindingSlot, BufferBundle *bufferBundle);
+  void bindDynamicUniformBuffer(uint32_t bindingSlot, DynamicUniformBuffer *buffer);
   void bindStorageImage(uint32_t bindingSlot, Image *storageImage);
   void bindImageSampler(uint32_t bindingSlot, Image *storageImage);
   void bindStorageBuffer(uint32_t bindingSlot, Buffer *buffer);
@@ -48,6 +52,7 @@ private:
 
   std::unordered_set<uint32_t> _boundedSlots{}; // used to check for duplicated bindings
   std::vector<std::pair<uint32_t, BufferBundle *>> _uniformBufferBundles{};
+  std::vector<std::pair<uint32_t, DynamicUniformBuffer *>> _dynamicUniformBuffers{};
   std::vector<std::pair<uint32_t, Image *>> _storageImages{};
   std::vector<std::pair<uint32_t, Image *>> _imageSamplers{};
   std::vector<std::pair<uint32_t, Buffer *>> _storageBuffers{};
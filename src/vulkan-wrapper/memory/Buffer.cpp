@@ -1,6 +1,7 @@
 #include "Buffer.hpp"
 
-#include "../utils/SimpleCommands.hpp"
+#include "app-context/DeletionQueue.hpp"
+#include "app-context/StagingRing.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
 
 #include <cassert>
@@ -24,14 +25,21 @@ VmaAllocationCreateFlags _decideAllocationCreateFlags(MemoryStyle memoryAccessin
 } // namespace
 
 Buffer::Buffer(VulkanApplicationContext *appContext, VkDeviceSize size,
-               VkBufferUsageFlags bufferUsageFlags, MemoryStyle memoryStyle)
-    : _appContext(appContext), _size(size), _memoryStyle(memoryStyle) {
+               VkBufferUsageFlags bufferUsageFlags, MemoryStyle memoryStyle,
+               OwnerQueue ownerQueue)
+    : _appContext(appContext), _size(size), _memoryStyle(memoryStyle), _ownerQueue(ownerQueue) {
   _allocate(bufferUsageFlags);
 }
 
 Buffer::~Buffer() {
   if (_vkBuffer != VK_NULL_HANDLE) {
-    vmaDestroyBuffer(_appContext->getAllocator(), _vkBuffer, _bufferAllocation);
+    // the pending uploads still copy into the buffer
+    _getOwnerStagingRing()->wait(_lastUploadTicket);
+    // the frames in flight might still be using the buffer
+    _appContext->getDeletionQueue()->push([allocator = _appContext->getAllocator(),
+                                           vkBuffer = _vkBuffer, allocation = _bufferAllocation]() {
+      vmaDestroyBuffer(allocator, vkBuffer, allocation);
+    });
     _vkBuffer = VK_NULL_HANDLE;
   }
 }
@@ -76,100 +84,54 @@ VkBufferMemoryBarrier Buffer::getMemoryBarrier(VkAccessFlags srcAccessMask,
   return memoryBarrier;
 }
 
-Buffer::StagingBufferHandle Buffer::_createStagingBuffer() const {
-  StagingBufferHandle stagingBufferHandle{};
-
-  VmaAllocator allocator = _appContext->getAllocator();
-
-  VkBufferCreateInfo stagingBufCreateInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-  stagingBufCreateInfo.size               = _size;
-  stagingBufCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-
-  VmaAllocationCreateInfo stagingAllocCreateInfo = {};
-  stagingAllocCreateInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
-  stagingAllocCreateInfo.flags =
-      VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-  VmaAllocationInfo stagingAllocInfo;
-  vmaCreateBuffer(allocator, &stagingBufCreateInfo, &stagingAllocCreateInfo,
-                  &stagingBufferHandle.vkBuffer, &stagingBufferHandle.bufferAllocation,
-                  &stagingAllocInfo);
-  stagingBufferHandle.mappedAddr = stagingAllocInfo.pMappedData;
-
-  return stagingBufferHandle;
+StagingRing *Buffer::_getOwnerStagingRing() const {
+  return _ownerQueue == OwnerQueue::kCompute ? _appContext->getComputeStagingRing()
+                                             : _appContext->getGraphicsStagingRing();
 }
 
-void Buffer::_destroyStagingBuffer(StagingBufferHandle &stagingBufferHandle) {
-  vmaDestroyBuffer(_appContext->getAllocator(), stagingBufferHandle.vkBuffer,
-                   stagingBufferHandle.bufferAllocation);
-  stagingBufferHandle.vkBuffer         = VK_NULL_HANDLE;
-  stagingBufferHandle.bufferAllocation = VK_NULL_HANDLE;
-  stagingBufferHandle.mappedAddr       = nullptr;
-}
-
-void Buffer::fillData(const void *data) {
-  auto const &device      = _appContext->getDevice();
-  auto const &queue       = _appContext->getGraphicsQueue();
-  auto const &commandPool = _appContext->getCommandPool();
+StagingTicket Buffer::upload(const void *data, VkDeviceSize size, VkDeviceSize offset) {
+  VkDeviceSize const copySize = size == VK_WHOLE_SIZE ? _size - offset : size;
+  assert(offset + copySize <= _size && "copy size exceeds the buffer size");
 
   switch (_memoryStyle) {
   case MemoryStyle::kHostVisible: {
-    memcpy(_mappedAddr, data, _size);
-    break;
+    auto *dst = static_cast<uint8_t *>(_mappedAddr) + offset;
+    if (data != nullptr) {
+      memcpy(dst, data, copySize);
+    } else {
+      memset(dst, 0, copySize);
+    }
+    return 0;
   }
   case MemoryStyle::kDedicated: {
-    StagingBufferHandle stagingBufferHandle = _createStagingBuffer();
-    memcpy(stagingBufferHandle.mappedAddr, data, _size);
-
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
-
-    VkBufferCopy bufCopy = {
-        0,     // srcOffset
-        0,     // dstOffset,
-        _size, // size
-    };
-
-    // copy staging buffer to main buffer
-    vkCmdCopyBuffer(commandBuffer, stagingBufferHandle.vkBuffer, _vkBuffer, 1, &bufCopy);
-
-    endSingleTimeCommands(device, commandPool, queue, commandBuffer);
-    _destroyStagingBuffer(stagingBufferHandle);
-    break;
+    _lastUploadTicket = _getOwnerStagingRing()->uploadToBuffer(_vkBuffer, offset, data, copySize);
+    return _lastUploadTicket;
+  }
   }
+  return 0;
+}
+
+void Buffer::fillData(const void *data, VkDeviceSize size) {
+  upload(data, size);
+  if (_memoryStyle == MemoryStyle::kDedicated) {
+    _getOwnerStagingRing()->flush();
   }
 }
 
-void Buffer::fetchData(void *data) {
-  auto const &device      = _appContext->getDevice();
-  auto const &queue       = _appContext->getGraphicsQueue();
-  auto const &commandPool = _appContext->getCommandPool();
+void Buffer::fetchData(void *data, VkDeviceSize size) {
+  VkDeviceSize const copySize = size == VK_WHOLE_SIZE ? _size : size;
+  assert(copySize <= _size && "copy size exceeds the buffer size");
 
   switch (_memoryStyle) {
   case MemoryStyle::kHostVisible: {
     assert(_mappedAddr != nullptr && "_mappedAddr is nullptr");
-    memcpy(data, _mappedAddr, _size);
+    memcpy(data, _mappedAddr, copySize);
     return;
   }
 
   case MemoryStyle::kDedicated: {
-    StagingBufferHandle stagingBufferHandle = _createStagingBuffer();
-
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
-
-    VkBufferCopy bufCopy = {
-        0,     // srcOffset
-        0,     // dstOffset,
-        _size, // size
-    };
-
-    // copy main buffer to staging buffer
-    vkCmdCopyBuffer(commandBuffer, _vkBuffer, stagingBufferHandle.vkBuffer, 1, &bufCopy);
-    endSingleTimeCommands(device, commandPool, queue, commandBuffer);
-
-    memcpy(data, stagingBufferHandle.mappedAddr, _size);
-
-    _destroyStagingBuffer(stagingBufferHandle);
+    _getOwnerStagingRing()->downloadFromBuffer(_vkBuffer, 0, data, copySize);
     break;
   }
   }
-}
\ No newline at end of file
+}
@@ -8,17 +8,26 @@
 #include "vk_mem_alloc.h" // NO_G3_REWRITE
 #endif
 
+#include "app-context/StagingRing.hpp"
+
 enum class MemoryStyle {
   kDedicated,
   kHostVisible,
 };
 
+// the queue that the buffer is used on, the staging transfers go through its staging ring
+enum class OwnerQueue {
+  kGraphics,
+  kCompute,
+};
+
 class VulkanApplicationContext;
 // the wrapper class of VkBuffer, handles memory allocation and data filling
 class Buffer {
 public:
   Buffer(VulkanApplicationContext *appContext, VkDeviceSize size,
-         VkBufferUsageFlags bufferUsageFlags, MemoryStyle memoryStyle);
+         VkBufferUsageFlags bufferUsageFlags, MemoryStyle memoryStyle,
+         OwnerQueue ownerQueue = OwnerQueue::kGraphics);
   ~Buffer();
 
   // default copy and move
@@ -29,8 +38,17 @@ public:
 
   // fill buffer with data
   //  buffer will be zero-initialized if data is nullptr
-  void fillData(const void *data = nullptr);
-  void fetchData(void *data);
+  //  only the first `size` bytes are transferred if size is given
+  //  the transfer is submitted but not waited for, the later submissions to the owner queue see
+  //  the new data
+  void fillData(const void *data = nullptr, VkDeviceSize size = VK_WHOLE_SIZE);
+  // same as fillData, but the transfer is only recorded into the open batch of the staging ring,
+  // the batch is submitted by the next fillData or flush of the ring, so that multiple uploads are
+  // batched into one submission, returns the ticket of the batch (0 for host visible buffers)
+  StagingTicket upload(const void *data, VkDeviceSize size = VK_WHOLE_SIZE,
+                       VkDeviceSize offset = 0);
+  // waits for the transfer
+  void fetchData(void *data, VkDeviceSize size = VK_WHOLE_SIZE);
 
   void *mapMemory();
   void unmapMemory();
@@ -59,20 +77,13 @@ private:
   VkDeviceSize _size; // total size of buffer
 
   MemoryStyle _memoryStyle;
+  OwnerQueue _ownerQueue;
+  StagingTicket _lastUploadTicket = 0;
 
   VkBuffer _vkBuffer              = VK_NULL_HANDLE;
   VmaAllocation _bufferAllocation = VK_NULL_HANDLE;
   void *_mappedAddr               = nullptr;
 
   void _allocate(VkBufferUsageFlags bufferUsageFlags);
-
-  struct StagingBufferHandle {
-    VkBuffer vkBuffer              = VK_NULL_HANDLE;
-    VmaAllocation bufferAllocation = VK_NULL_HANDLE;
-    void *mappedAddr               = nullptr;
-  };
-
-  // create a staging buffer that is both allowed to be transferred to and from
-  [[nodiscard]] StagingBufferHandle _createStagingBuffer() const;
-  void _destroyStagingBuffer(StagingBufferHandle &stagingBufferHandle);
+  [[nodiscard]] StagingRing *_getOwnerStagingRing() const;
 };
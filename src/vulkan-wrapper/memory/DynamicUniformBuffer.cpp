@@ -0,0 +1,37 @@
+#include "DynamicUniformBuffer.hpp"
+
+#include "Buffer.hpp"
+#include "app-context/VulkanApplicationContext.hpp"
+
+#include <cassert>
+
+DynamicUniformBuffer::DynamicUniformBuffer(VulkanApplicationContext *appContext,
+                                           size_t sliceCount, VkDeviceSize sliceSize)
+    : _sliceCount(sliceCount), _sliceSize(sliceSize) {
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(appContext->getPhysicalDevice(), &properties);
+  VkDeviceSize const alignment = properties.limits.minUniformBufferOffsetAlignment;
+  _sliceStride                 = (_sliceSize + alignment - 1) / alignment * alignment;
+
+  _buffer = std::make_unique<Buffer>(appContext, _sliceStride * _sliceCount,
+                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+}
+
+DynamicUniformBuffer::~DynamicUniformBuffer() = default;
+
+uint32_t DynamicUniformBuffer::getDynamicOffset(size_t sliceIndex) const {
+  assert(sliceIndex < _sliceCount && "DynamicUniformBuffer: slice index out of range");
+  return static_cast<uint32_t>(sliceIndex * _sliceStride);
+}
+
+VkDescriptorBufferInfo DynamicUniformBuffer::getDescriptorInfo() const {
+  VkDescriptorBufferInfo descriptorInfo{};
+  descriptorInfo.buffer = _buffer->getVkBuffer();
+  descriptorInfo.offset = 0;
+  descriptorInfo.range  = _sliceSize;
+  return descriptorInfo;
+}
+
+void DynamicUniformBuffer::fillSlice(size_t sliceIndex, const void *data) {
+  _buffer->upload(data, _sliceSize, getDynamicOffset(sliceIndex));
+}
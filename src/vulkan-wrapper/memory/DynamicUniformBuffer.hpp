@@ -0,0 +1,42 @@
+#pragma once
+
+#include "volk.h"
+
+#include <cstdint>
+#include <memory>
+
+class Buffer;
+class VulkanApplicationContext;
+
+// a single host visible uniform buffer that holds one slice per frame in flight, the slice is
+// selected by a dynamic offset when the descriptor set is bound, so one descriptor set can serve
+// all the frames, instead of a set per frame like BufferBundle
+class DynamicUniformBuffer {
+public:
+  DynamicUniformBuffer(VulkanApplicationContext *appContext, size_t sliceCount,
+                       VkDeviceSize sliceSize);
+  ~DynamicUniformBuffer();
+
+  // delete copy and move
+  DynamicUniformBuffer(const DynamicUniformBuffer &)            = delete;
+  DynamicUniformBuffer &operator=(const DynamicUniformBuffer &) = delete;
+  DynamicUniformBuffer(DynamicUniformBuffer &&)                 = delete;
+  DynamicUniformBuffer &operator=(DynamicUniformBuffer &&)      = delete;
+
+  [[nodiscard]] size_t getSliceCount() const { return _sliceCount; }
+  [[nodiscard]] uint32_t getDynamicOffset(size_t sliceIndex) const;
+
+  // the range of the descriptor covers one slice
+  [[nodiscard]] VkDescriptorBufferInfo getDescriptorInfo() const;
+
+  // the slice must not be in use by the gpu
+  void fillSlice(size_t sliceIndex, const void *data);
+
+private:
+  size_t _sliceCount;
+  VkDeviceSize _sliceSize;
+  // the slice size rounded up to the dynamic offset alignment of the device
+  VkDeviceSize _sliceStride;
+
+  std::unique_ptr<Buffer> _buffer;
+};
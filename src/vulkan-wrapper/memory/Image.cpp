@@ -1,6 +1,9 @@
 #include "Image.hpp"
 
+#include "app-context/DeletionQueue.hpp"
+#include "app-context/StagingRing.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
+#include "utils/job-system/JobSystem.hpp"
 
 #include "../utils/SimpleCommands.hpp"
 
@@ -8,6 +11,7 @@
 #include "stb_image.h"
 
 #include <cassert>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 
@@ -34,13 +38,46 @@ static const std::unordered_map<VkFormat, int> kVkFormatBytesPerPixelMap{
 };
 
 namespace {
+void _freeImageData(unsigned char *imageData) { stbi_image_free(imageData); }
+
 unsigned char *_loadImageFromPath(const std::string &path, int &width, int &height, int &channels) {
   unsigned char *imageData = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
   assert(imageData != nullptr && "Failed to load texture image");
   return imageData;
 }
 
-void _freeImageData(unsigned char *imageData) { stbi_image_free(imageData); }
+// the files are decoded on the job system, stb_image keeps no state between the calls, all the
+// files should be in the same dimension
+std::vector<unsigned char *> _loadImagesFromPaths(JobSystem *jobSystem,
+                                                  std::vector<std::string> const &paths, int &width,
+                                                  int &height) {
+  std::vector<unsigned char *> imageDatas(paths.size(), nullptr);
+  std::vector<int> widths(paths.size(), 0);
+  std::vector<int> heights(paths.size(), 0);
+
+  jobSystem->parallelFor(0, paths.size(), 1, [&](size_t begin, size_t end) {
+    int channels = 0;
+    for (size_t i = begin; i < end; i++) {
+      imageDatas[i] = _loadImageFromPath(paths[i], widths[i], heights[i], channels);
+    }
+  });
+
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (widths[i] == widths[0] && heights[i] == heights[0]) {
+      continue;
+    }
+    for (unsigned char *imageData : imageDatas) {
+      _freeImageData(imageData);
+    }
+    throw std::runtime_error("all the images of the array should be in the same dimension, " +
+                             paths[i] + " is " + std::to_string(widths[i]) + "x" +
+                             std::to_string(heights[i]) + ", " + paths[0] + " is " +
+                             std::to_string(widths[0]) + "x" + std::to_string(heights[0]));
+  }
+  width  = widths.empty() ? 0 : widths[0];
+  height = heights.empty() ? 0 : heights[0];
+  return imageDatas;
+}
 } // namespace
 
 Image::Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, VkFormat format,
@@ -57,6 +94,34 @@ Image::Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, V
                                  _dimensions.depth, _layerCount);
 }
 
+Image::Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, VkFormat format)
+    : _appContext(appContext), _currentImageLayout(VK_IMAGE_LAYOUT_UNDEFINED), _layerCount(1),
+      _format(format), _dimensions(dimensions) {}
+
+std::unique_ptr<Image> Image::createWithoutMemory(VulkanApplicationContext *appContext,
+                                                  ImageDimensions dimensions, VkFormat format,
+                                                  VkImageUsageFlags usage) {
+  // the constructor is private
+  std::unique_ptr<Image> image(new Image(appContext, dimensions, format));
+  VkImageCreateInfo const imageInfo =
+      image->_getImageCreateInfo(VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, usage);
+  vkCreateImage(appContext->getDevice(), &imageInfo, nullptr, &image->_vkImage);
+  return image;
+}
+
+VkMemoryRequirements Image::getMemoryRequirements() const {
+  VkMemoryRequirements memoryRequirements{};
+  vkGetImageMemoryRequirements(_appContext->getDevice(), _vkImage, &memoryRequirements);
+  return memoryRequirements;
+}
+
+void Image::bindMemory(VmaAllocation allocation) {
+  assert(_allocation == VK_NULL_HANDLE && "the image owns its memory already");
+  vmaBindImageMemory(_appContext->getAllocator(), allocation, _vkImage);
+  _vkImageView = createImageView(_appContext->getDevice(), _vkImage, _format,
+                                 VK_IMAGE_ASPECT_COLOR_BIT, _dimensions.depth, _layerCount);
+}
+
 Image::Image(VulkanApplicationContext *appContext, const std::string &filename,
              VkImageUsageFlags usage, VkSampler sampler, VkImageLayout initialImageLayout,
              VkSampleCountFlagBits numSamples, VkImageTiling tiling, VkImageAspectFlags aspectFlags)
@@ -72,9 +137,12 @@ Image::Image(VulkanApplicationContext *appContext, const std::string &filename,
 
   _createImage(numSamples, tiling, usage);
 
+  // the transitions and the copy are batched in the staging ring, and are not waited for
+  StagingRing *stagingRing = _appContext->getGraphicsStagingRing();
+
   // make it pastable
   if (initialImageLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-    _transitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    _recordLayoutTransition(stagingRing->getCommandBuffer(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
   }
 
   // copy the image data to the image
@@ -84,36 +152,35 @@ Image::Image(VulkanApplicationContext *appContext, const std::string &filename,
   _freeImageData(imageData);
 
   if (initialImageLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
-    _transitionImageLayout(initialImageLayout);
+    _recordLayoutTransition(stagingRing->getCommandBuffer(), initialImageLayout);
   }
+  _uploadTicket = stagingRing->flush();
 
   _vkImageView = createImageView(_appContext->getDevice(), _vkImage, _format, aspectFlags,
                                  _dimensions.depth, _layerCount);
 }
 
 Image::Image(VulkanApplicationContext *appContext, const std::vector<std::string> &filenames,
-             VkImageUsageFlags usage, VkSampler sampler, VkImageLayout initialImageLayout,
-             VkSampleCountFlagBits numSamples, VkImageTiling tiling, VkImageAspectFlags aspectFlags)
+             JobSystem *jobSystem, VkImageUsageFlags usage, VkSampler sampler,
+             VkImageLayout initialImageLayout, VkSampleCountFlagBits numSamples,
+             VkImageTiling tiling, VkImageAspectFlags aspectFlags)
     : _appContext(appContext), _vkSampler(sampler), _currentImageLayout(VK_IMAGE_LAYOUT_UNDEFINED),
       _layerCount(static_cast<uint32_t>(filenames.size())), _format(VK_FORMAT_R8G8B8A8_UNORM) {
-  std::vector<unsigned char *> imageDatas{};
-
-  int width    = 0;
-  int height   = 0;
-  int channels = 0;
-  for (std::string const &filename : filenames) {
-    // load image from path
-    auto *imageData = _loadImageFromPath(filename, width, height, channels);
-    imageDatas.push_back(imageData);
-  }
+  int width  = 0;
+  int height = 0;
+  std::vector<unsigned char *> imageDatas =
+      _loadImagesFromPaths(jobSystem, filenames, width, height);
 
   _dimensions = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
 
   _createImage(numSamples, tiling, usage);
 
+  // the transitions and the copies are batched in the staging ring, and are not waited for
+  StagingRing *stagingRing = _appContext->getGraphicsStagingRing();
+
   // make it pastable
   if (initialImageLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-    _transitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    _recordLayoutTransition(stagingRing->getCommandBuffer(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
   }
 
   // copy the image data to the image
@@ -123,8 +190,36 @@ Image::Image(VulkanApplicationContext *appContext, const std::vector<std::string
   }
 
   if (initialImageLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
-    _transitionImageLayout(initialImageLayout);
+    _recordLayoutTransition(stagingRing->getCommandBuffer(), initialImageLayout);
   }
+  _uploadTicket = stagingRing->flush();
+
+  _vkImageView = createImageView(_appContext->getDevice(), _vkImage, _format, aspectFlags,
+                                 _dimensions.depth, _layerCount);
+}
+
+Image::Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, uint32_t layerCount,
+             VkFormat format, void const *data, VkImageUsageFlags usage, VkSampler sampler,
+             VkImageLayout initialImageLayout, VkImageAspectFlags aspectFlags)
+    : _appContext(appContext), _vkSampler(sampler), _currentImageLayout(VK_IMAGE_LAYOUT_UNDEFINED),
+      _layerCount(layerCount), _format(format), _dimensions(dimensions) {
+  _createImage(VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, usage);
+
+  // the transitions and the copy are batched in the staging ring, and are not waited for
+  StagingRing *stagingRing = _appContext->getGraphicsStagingRing();
+
+  // make it pastable
+  if (initialImageLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+    _recordLayoutTransition(stagingRing->getCommandBuffer(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+  }
+
+  // the layers are contiguous, so one region covers all of them
+  _copyDataToImage(data, 0, layerCount);
+
+  if (initialImageLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
+    _recordLayoutTransition(stagingRing->getCommandBuffer(), initialImageLayout);
+  }
+  _uploadTicket = stagingRing->flush();
 
   _vkImageView = createImageView(_appContext->getDevice(), _vkImage, _format, aspectFlags,
                                  _dimensions.depth, _layerCount);
@@ -132,9 +227,17 @@ Image::Image(VulkanApplicationContext *appContext, const std::vector<std::string
 
 Image::~Image() {
   if (_vkImage != VK_NULL_HANDLE) {
-    vkDestroyImageView(_appContext->getDevice(), _vkImageView, nullptr);
-    vkDestroyImage(_appContext->getDevice(), _vkImage, nullptr);
-    vmaFreeMemory(_appContext->getAllocator(), _allocation);
+    // the pending uploads still copy into the image
+    _appContext->getGraphicsStagingRing()->wait(_uploadTicket);
+    // the frames in flight might still be using the image
+    _appContext->getDeletionQueue()->push(
+        [device = _appContext->getDevice(), allocator = _appContext->getAllocator(),
+         vkImageView = _vkImageView, vkImage = _vkImage, allocation = _allocation]() {
+          vkDestroyImageView(device, vkImageView, nullptr);
+          vkDestroyImage(device, vkImage, nullptr);
+          // null for the images created without memory, which is skipped by vma
+          vmaFreeMemory(allocator, allocation);
+        });
   }
 }
 
@@ -144,65 +247,31 @@ void Image::clearImage(VkCommandBuffer commandBuffer) {
                        &clearRange);
 }
 
-void Image::_copyDataToImage(unsigned char *imageData, uint32_t layerToCopyTo) {
-  auto const &device      = _appContext->getDevice();
-  auto const &queue       = _appContext->getGraphicsQueue();
-  auto const &commandPool = _appContext->getCommandPool();
-  auto const &allocator   = _appContext->getAllocator();
-
+// the copy is recorded into the open batch of the graphics staging ring
+void Image::_copyDataToImage(void const *imageData, uint32_t layerToCopyTo, uint32_t layerCount) {
   const uint32_t imagePixelCount = _dimensions.width * _dimensions.height * _dimensions.depth;
   // the channel count is ignored here, because the VkFormat is enough
-  const uint32_t imageDataSize = imagePixelCount * kVkFormatBytesPerPixelMap.at(_format);
-
-  // create a staging buffer
-  VkBufferCreateInfo bufferInfo{};
-  bufferInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  bufferInfo.size        = imageDataSize;
-  bufferInfo.usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-  VmaAllocationCreateInfo vmaAllocInfo{};
-  vmaAllocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-
-  VkBuffer stagingBuffer                = VK_NULL_HANDLE;
-  VmaAllocation stagingBufferAllocation = nullptr;
-  vmaCreateBuffer(allocator, &bufferInfo, &vmaAllocInfo, &stagingBuffer, &stagingBufferAllocation,
-                  nullptr);
-
-  // copy your data to the staging buffer
-  void *mappedData = nullptr;
-  vmaMapMemory(allocator, stagingBufferAllocation, &mappedData);
-  memcpy(mappedData, imageData, imageDataSize);
-  vmaUnmapMemory(allocator, stagingBufferAllocation);
-
-  // record a command to copy the buffer to the image
-  VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
+  const VkDeviceSize imageDataSize = static_cast<VkDeviceSize>(imagePixelCount) * layerCount *
+                                     kVkFormatBytesPerPixelMap.at(_format);
 
   VkBufferImageCopy region{};
-  region.bufferOffset                = 0;
   region.bufferRowLength             = 0; // If your data is tightly packed, this can be 0
   region.bufferImageHeight           = 0; // If your data is tightly packed, this can be 0
   region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   region.imageSubresource.mipLevel   = 0;
   // the first layer of the texture array that the data should be copied into
   region.imageSubresource.baseArrayLayer = layerToCopyTo;
-  region.imageSubresource.layerCount     = 1;
+  region.imageSubresource.layerCount     = layerCount;
   region.imageOffset                     = {0, 0, 0};
   region.imageExtent                     = {static_cast<uint32_t>(_dimensions.width),
                                             static_cast<uint32_t>(_dimensions.height),
                                             static_cast<uint32_t>(_dimensions.depth)};
 
-  vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, _vkImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-  endSingleTimeCommands(device, commandPool, queue, commandBuffer);
-
-  // Clean up the staging buffer
-  vmaDestroyBuffer(_appContext->getAllocator(), stagingBuffer, stagingBufferAllocation);
+  _appContext->getGraphicsStagingRing()->uploadToImage(_vkImage, region, imageData, imageDataSize);
 }
 
-VkResult Image::_createImage(VkSampleCountFlagBits numSamples, VkImageTiling tiling,
-                             VkImageUsageFlags usage) {
+VkImageCreateInfo Image::_getImageCreateInfo(VkSampleCountFlagBits numSamples,
+                                             VkImageTiling tiling, VkImageUsageFlags usage) const {
   VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
   imageInfo.imageType     = _dimensions.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
   imageInfo.extent.width  = _dimensions.width;
@@ -215,6 +284,12 @@ VkResult Image::_createImage(VkSampleCountFlagBits numSamples, VkImageTiling til
   imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
   imageInfo.usage         = usage;
   imageInfo.samples       = numSamples;
+  return imageInfo;
+}
+
+VkResult Image::_createImage(VkSampleCountFlagBits numSamples, VkImageTiling tiling,
+                             VkImageUsageFlags usage) {
+  VkImageCreateInfo const imageInfo = _getImageCreateInfo(numSamples, tiling, usage);
 
   VmaAllocationCreateInfo vmaallocInfo = {};
   vmaallocInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
@@ -273,7 +348,11 @@ void Image::_transitionImageLayout(VkImageLayout newLayout) {
   auto const &commandPool = _appContext->getCommandPool();
 
   VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
+  _recordLayoutTransition(commandBuffer, newLayout);
+  endSingleTimeCommands(device, commandPool, queue, commandBuffer);
+}
 
+void Image::_recordLayoutTransition(VkCommandBuffer commandBuffer, VkImageLayout newLayout) {
   VkImageMemoryBarrier barrier{};
   barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
   barrier.oldLayout                       = _currentImageLayout;
@@ -317,7 +396,7 @@ void Image::_transitionImageLayout(VkImageLayout newLayout) {
     destinationStage      = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
   } else if (_currentImageLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
              newLayout == VK_IMAGE_LAYOUT_GENERAL) {
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
     sourceStage           = VK_PIPELINE_STAGE_TRANSFER_BIT;
     destinationStage      = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
@@ -328,8 +407,6 @@ void Image::_transitionImageLayout(VkImageLayout newLayout) {
   vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1,
                        &barrier);
 
-  endSingleTimeCommands(device, commandPool, queue, commandBuffer);
-
   _currentImageLayout = newLayout;
 }
 
@@ -8,6 +8,9 @@
 #include "vk_mem_alloc.h" // NO_G3_REWRITE
 #endif
 
+#include "app-context/StagingRing.hpp"
+
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,6 +32,7 @@ struct ImageDimensions {
 };
 
 class VulkanApplicationContext;
+class JobSystem;
 // the wrapper class of VkImage and its corresponding VkImageView, handles
 // memory allocation
 class Image {
@@ -51,14 +55,29 @@ public:
         VkImageAspectFlags aspectFlags   = VK_IMAGE_ASPECT_COLOR_BIT);
 
   // create a texture array from a set of image files, all images should be in
-  // the same dimension and the same format..
+  // the same dimension and the same format.. the files are decoded on the job system, throws if
+  // the dimensions differ
   Image(VulkanApplicationContext *appContext, const std::vector<std::string> &filenames,
-        VkImageUsageFlags usage, VkSampler sampler = VK_NULL_HANDLE,
+        JobSystem *jobSystem, VkImageUsageFlags usage, VkSampler sampler = VK_NULL_HANDLE,
         VkImageLayout initialImageLayout = VK_IMAGE_LAYOUT_GENERAL,
         VkSampleCountFlagBits numSamples = VK_SAMPLE_COUNT_1_BIT,
         VkImageTiling tiling             = VK_IMAGE_TILING_OPTIMAL,
         VkImageAspectFlags aspectFlags   = VK_IMAGE_ASPECT_COLOR_BIT);
 
+  // create a texture array from the tightly packed layers in memory, all the layers are uploaded
+  // with a single copy
+  Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, uint32_t layerCount,
+        VkFormat format, void const *data, VkImageUsageFlags usage,
+        VkSampler sampler                = VK_NULL_HANDLE,
+        VkImageLayout initialImageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        VkImageAspectFlags aspectFlags   = VK_IMAGE_ASPECT_COLOR_BIT);
+
+  // create a blank image without memory, the memory is bound by bindMemory, and can be shared with
+  // other images, so the content and the layout are undefined before the first write of a frame
+  static std::unique_ptr<Image> createWithoutMemory(VulkanApplicationContext *appContext,
+                                                    ImageDimensions dimensions, VkFormat format,
+                                                    VkImageUsageFlags usage);
+
   ~Image();
 
   // disable move and copy
@@ -69,6 +88,11 @@ public:
 
   VkImage &getVkImage() { return _vkImage; }
 
+  // only for the images created without memory
+  [[nodiscard]] VkMemoryRequirements getMemoryRequirements() const;
+  // the allocation is owned by the caller, and must outlive the image
+  void bindMemory(VmaAllocation allocation);
+
   [[nodiscard]] VkDescriptorImageInfo getDescriptorInfo(VkImageLayout imageLayout) const;
   [[nodiscard]] ImageDimensions getDimensions() const { return _dimensions; }
 
@@ -79,6 +103,8 @@ public:
                                      uint32_t layerCount = 1);
 
 private:
+  Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, VkFormat format);
+
   VulkanApplicationContext *_appContext;
 
   VkImage _vkImage          = VK_NULL_HANDLE;
@@ -90,14 +116,21 @@ private:
   VkFormat _format;
 
   ImageDimensions _dimensions;
+  // the ticket of the upload of the image files
+  StagingTicket _uploadTicket = 0;
 
-  void _copyDataToImage(unsigned char *imageData, uint32_t layerToCopyTo = 0);
+  void _copyDataToImage(void const *imageData, uint32_t layerToCopyTo = 0,
+                        uint32_t layerCount = 1);
 
+  [[nodiscard]] VkImageCreateInfo _getImageCreateInfo(VkSampleCountFlagBits numSamples,
+                                                      VkImageTiling tiling,
+                                                      VkImageUsageFlags usage) const;
   // creates an image with VK_IMAGE_LAYOUT_UNDEFINED initially
   VkResult _createImage(VkSampleCountFlagBits numSamples, VkImageTiling tiling,
                         VkImageUsageFlags usage);
 
   void _transitionImageLayout(VkImageLayout newLayout);
+  void _recordLayoutTransition(VkCommandBuffer commandBuffer, VkImageLayout newLayout);
 };
 
 // storing the pointer of a pair of imgs, support for easy dumping
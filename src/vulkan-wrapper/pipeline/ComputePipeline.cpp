@@ -7,15 +7,20 @@
 #include "utils/logger/Logger.hpp"
 #include "utils/shader-compiler/ShaderCompiler.hpp"
 
+#include <vector>
+
 ComputePipeline::ComputePipeline(VulkanApplicationContext *appContext, Logger *logger,
                                  PipelineScheduler *scheduler,
                                  std::string fullPathToShaderSourceCode,
                                  WorkGroupSize workGroupSize,
                                  DescriptorSetBundle *descriptorSetBundle,
                                  ShaderCompiler *shaderCompiler,
-                                 ShaderChangeListener *shaderChangeListener)
+                                 ShaderChangeListener *shaderChangeListener,
+                                 uint32_t pushConstantSize,
+                                 SpecializationConstants specializationConstants)
     : Pipeline(appContext, logger, scheduler, std::move(fullPathToShaderSourceCode),
-               descriptorSetBundle, VK_SHADER_STAGE_COMPUTE_BIT, shaderChangeListener),
+               descriptorSetBundle, VK_SHADER_STAGE_COMPUTE_BIT, shaderChangeListener,
+               pushConstantSize, std::move(specializationConstants)),
       _workGroupSize(workGroupSize), _shaderCompiler(shaderCompiler) {
   if (!compileAndCacheShaderModule()) {
     _logger->error("pipeline: {} is failed to compile!");
@@ -40,7 +45,8 @@ bool ComputePipeline::compileAndCacheShaderModule() {
   return false;
 }
 
-// the shader module must be cached before this step
+// the shader module must be cached before this step, only the variant in use is created, the
+// others are created again when they are switched to
 void ComputePipeline::build() {
   _cleanupPipelineAndLayout();
 
@@ -50,8 +56,21 @@ void ComputePipeline::build() {
   // this is why the compute pipeline requires the descriptor set layout to be specified
   pipelineLayoutInfo.pSetLayouts = &_descriptorSetBundle->getDescriptorSetLayout();
 
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.offset     = 0;
+  pushConstantRange.size       = _pushConstantSize;
+  if (_pushConstantSize > 0) {
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges    = &pushConstantRange;
+  }
+
   vkCreatePipelineLayout(_appContext->getDevice(), &pipelineLayoutInfo, nullptr, &_pipelineLayout);
 
+  _pipeline = _getOrCreateVariant(_specializationConstants);
+}
+
+VkPipeline ComputePipeline::_createVariant(SpecializationConstants const &specializationConstants) {
   if (_cachedShaderModule == VK_NULL_HANDLE) {
     _logger->error("failed to build the pipeline because of a null shader module: {}",
                    _fullPathToShaderSourceCode);
@@ -63,14 +82,36 @@ void ComputePipeline::build() {
   shaderStageInfo.module = _cachedShaderModule;
   shaderStageInfo.pName  = "main"; // name of the entry function of current shader
 
+  // every constant is 4 bytes wide, a bool constant is read as a VkBool32
+  std::vector<VkSpecializationMapEntry> mapEntries;
+  std::vector<uint32_t> constantData;
+  mapEntries.reserve(specializationConstants.size());
+  constantData.reserve(specializationConstants.size());
+  for (auto const &[constantId, value] : specializationConstants) {
+    mapEntries.push_back({constantId, static_cast<uint32_t>(constantData.size() * sizeof(uint32_t)),
+                          sizeof(uint32_t)});
+    constantData.push_back(value);
+  }
+
+  VkSpecializationInfo specializationInfo{};
+  specializationInfo.mapEntryCount = static_cast<uint32_t>(mapEntries.size());
+  specializationInfo.pMapEntries   = mapEntries.data();
+  specializationInfo.dataSize      = constantData.size() * sizeof(uint32_t);
+  specializationInfo.pData         = constantData.data();
+  if (!specializationConstants.empty()) {
+    shaderStageInfo.pSpecializationInfo = &specializationInfo;
+  }
+
   VkComputePipelineCreateInfo computePipelineCreateInfo{};
   computePipelineCreateInfo.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
   computePipelineCreateInfo.layout = _pipelineLayout;
   computePipelineCreateInfo.flags  = 0;
   computePipelineCreateInfo.stage  = shaderStageInfo;
 
+  VkPipeline pipeline = VK_NULL_HANDLE;
   vkCreateComputePipelines(_appContext->getDevice(), VK_NULL_HANDLE, 1, &computePipelineCreateInfo,
-                           nullptr, &_pipeline);
+                           nullptr, &pipeline);
+  return pipeline;
 }
 
 void ComputePipeline::recordCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
@@ -84,7 +125,7 @@ void ComputePipeline::recordCommand(VkCommandBuffer commandBuffer, uint32_t curr
 }
 
 void ComputePipeline::recordIndirectCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
-                                            VkBuffer indirectBuffer) {
+                                            VkBuffer indirectBuffer, VkDeviceSize offset) {
   _bind(commandBuffer, currentFrame);
-  vkCmdDispatchIndirect(commandBuffer, indirectBuffer, 0);
+  vkCmdDispatchIndirect(commandBuffer, indirectBuffer, offset);
 }
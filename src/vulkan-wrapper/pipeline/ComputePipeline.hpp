@@ -16,7 +16,9 @@ public:
                   PipelineScheduler *scheduler, std::string fullPathToShaderSourceCode,
                   WorkGroupSize workGroupSize, DescriptorSetBundle *descriptorSetBundle,
                   ShaderCompiler *shaderCompiler,
-                  ShaderChangeListener *shaderChangeListener = nullptr);
+                  ShaderChangeListener *shaderChangeListener      = nullptr,
+                  uint32_t pushConstantSize                       = 0,
+                  SpecializationConstants specializationConstants = {});
 
   ~ComputePipeline() override;
 
@@ -32,11 +34,14 @@ public:
   void recordCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t threadCountX,
                      uint32_t threadCountY, uint32_t threadCountZ);
 
+  // offset is where the VkDispatchIndirectCommand starts in the buffer
   void recordIndirectCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
-                             VkBuffer indirectBuffer);
+                             VkBuffer indirectBuffer, VkDeviceSize offset = 0);
 
 private:
   WorkGroupSize _workGroupSize;
 
   ShaderCompiler *_shaderCompiler;
+
+  VkPipeline _createVariant(SpecializationConstants const &specializationConstants) override;
 };
\ No newline at end of file
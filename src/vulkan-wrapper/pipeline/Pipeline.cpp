@@ -1,5 +1,6 @@
 #include "Pipeline.hpp"
 #include "../descriptor-set/DescriptorSetBundle.hpp"
+#include "app-context/DeletionQueue.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
 #include "file-watcher/ShaderChangeListener.hpp"
 #include "scheduler/Scheduler.hpp"
@@ -16,11 +17,13 @@ static const std::map<VkShaderStageFlags, VkPipelineBindPoint> kShaderStageFlags
 Pipeline::Pipeline(VulkanApplicationContext *appContext, Logger *logger,
                    PipelineScheduler *scheduler, std::string fullPathToShaderSourceCode,
                    DescriptorSetBundle *descriptorSetBundle, VkShaderStageFlags shaderStageFlags,
-                   ShaderChangeListener *shaderChangeListener)
+                   ShaderChangeListener *shaderChangeListener, uint32_t pushConstantSize,
+                   SpecializationConstants specializationConstants)
     : _appContext(appContext), _logger(logger), _scheduler(scheduler),
       _shaderChangeListener(shaderChangeListener), _descriptorSetBundle(descriptorSetBundle),
       _fullPathToShaderSourceCode(std::move(fullPathToShaderSourceCode)),
-      _shaderStageFlags(shaderStageFlags) {
+      _shaderStageFlags(shaderStageFlags), _pushConstantSize(pushConstantSize),
+      _specializationConstants(std::move(specializationConstants)) {
 
   if (_shaderChangeListener != nullptr) {
     _shaderChangeListener->addWatchingPipeline(this);
@@ -36,15 +39,49 @@ Pipeline::~Pipeline() {
   }
 }
 
+// the frames in flight might still be using the old pipelines, so they are destroyed through the
+// deletion queue, the shader module is only used when the pipelines are created
 void Pipeline::_cleanupPipelineAndLayout() {
-  if (_pipelineLayout != VK_NULL_HANDLE) {
-    vkDestroyPipelineLayout(_appContext->getDevice(), _pipelineLayout, nullptr);
-    _pipelineLayout = VK_NULL_HANDLE;
+  if (_pipelineLayout == VK_NULL_HANDLE && _variants.empty()) {
+    return;
   }
-  if (_pipeline != VK_NULL_HANDLE) {
-    vkDestroyPipeline(_appContext->getDevice(), _pipeline, nullptr);
-    _pipeline = VK_NULL_HANDLE;
+  std::vector<VkPipeline> pipelines;
+  pipelines.reserve(_variants.size());
+  for (auto const &[specializationConstants, pipeline] : _variants) {
+    pipelines.push_back(pipeline);
   }
+  _appContext->getDeletionQueue()->push([device         = _appContext->getDevice(),
+                                         pipelineLayout = _pipelineLayout,
+                                         pipelines      = std::move(pipelines)]() {
+    if (pipelineLayout != VK_NULL_HANDLE) {
+      vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    }
+    for (VkPipeline pipeline : pipelines) {
+      vkDestroyPipeline(device, pipeline, nullptr);
+    }
+  });
+  _variants.clear();
+  _pipelineLayout = VK_NULL_HANDLE;
+  _pipeline       = VK_NULL_HANDLE;
+}
+
+bool Pipeline::setSpecializationConstants(SpecializationConstants const &specializationConstants) {
+  if (specializationConstants == _specializationConstants) {
+    return false;
+  }
+  _specializationConstants = specializationConstants;
+  _pipeline                = _getOrCreateVariant(_specializationConstants);
+  return true;
+}
+
+VkPipeline Pipeline::_getOrCreateVariant(SpecializationConstants const &specializationConstants) {
+  auto it = _variants.find(specializationConstants);
+  if (it != _variants.end()) {
+    return it->second;
+  }
+  VkPipeline pipeline = _createVariant(specializationConstants);
+  _variants.emplace(specializationConstants, pipeline);
+  return pipeline;
 }
 
 void Pipeline::_cleanupShaderModule() {
@@ -71,8 +108,12 @@ VkShaderModule Pipeline::_createShaderModule(const std::vector<uint32_t> &code)
 }
 
 void Pipeline::_bind(VkCommandBuffer commandBuffer, size_t currentFrame) {
+  // a bundle that keeps its per-frame data behind dynamic offsets holds a single set
+  size_t const setIndex = currentFrame % _descriptorSetBundle->getBundleSize();
+  std::vector<uint32_t> const dynamicOffsets =
+      _descriptorSetBundle->getDynamicOffsets(currentFrame);
   vkCmdBindDescriptorSets(commandBuffer, kShaderStageFlagsToBindPoint.at(_shaderStageFlags),
-                          _pipelineLayout, 0, 1,
-                          &_descriptorSetBundle->getDescriptorSet(currentFrame), 0, nullptr);
+                          _pipelineLayout, 0, 1, &_descriptorSetBundle->getDescriptorSet(setIndex),
+                          static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
   vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline);
 }
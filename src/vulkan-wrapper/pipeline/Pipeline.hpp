@@ -2,7 +2,9 @@
 
 #include "volk.h"
 
+#include <cassert>
 #include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -14,12 +16,18 @@ class DescriptorSetBundle;
 class PipelineScheduler;
 class ShaderChangeListener;
 
+// the values of the specialization constants of a pipeline variant, keyed by the constant id, a
+// bool constant takes 0 or 1
+using SpecializationConstants = std::map<uint32_t, uint32_t>;
+
 class Pipeline {
 public:
   Pipeline(VulkanApplicationContext *appContext, Logger *logger, PipelineScheduler *scheduler,
            std::string fullPathToShaderSourceCode, DescriptorSetBundle *descriptorSetBundle,
            VkShaderStageFlags shaderStageFlags,
-           ShaderChangeListener *shaderChangeListener = nullptr);
+           ShaderChangeListener *shaderChangeListener      = nullptr,
+           uint32_t pushConstantSize                       = 0,
+           SpecializationConstants specializationConstants = {});
   virtual ~Pipeline();
 
   // disable copy and move
@@ -42,6 +50,18 @@ public:
 
   [[nodiscard]] PipelineScheduler *getScheduler() const { return _scheduler; }
 
+  // switches to the variant specialized with the constants, a variant is created on its first use
+  // and cached until the pipeline is rebuilt, returns true if the variant has changed, then the
+  // commands using the pipeline must be re-recorded
+  bool setSpecializationConstants(SpecializationConstants const &specializationConstants);
+
+  // per-dispatch parameters, recorded straight into the command buffer, so they need neither a
+  // buffer copy nor a barrier, the data stays set for the following dispatches of the pipeline
+  template <typename T> void pushConstants(VkCommandBuffer commandBuffer, T const &data) {
+    assert(sizeof(T) == _pushConstantSize && "the data must match the push constant range");
+    vkCmdPushConstants(commandBuffer, _pipelineLayout, _shaderStageFlags, 0, sizeof(T), &data);
+  }
+
 protected:
   VulkanApplicationContext *_appContext;
   Logger *_logger;
@@ -57,10 +77,21 @@ protected:
   std::vector<Image *> _storageImages;               // images for storage data
 
   VkShaderStageFlags _shaderStageFlags;
+  // a single range at offset 0, no range is created if the size is 0
+  uint32_t _pushConstantSize;
+
+  SpecializationConstants _specializationConstants;
+  // the created variants, all of them share the pipeline layout
+  std::map<SpecializationConstants, VkPipeline> _variants;
 
+  // the variant in use
   VkPipeline _pipeline             = VK_NULL_HANDLE;
   VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
 
+  // the pipeline layout must be created before this step
+  virtual VkPipeline _createVariant(SpecializationConstants const &specializationConstants) = 0;
+  VkPipeline _getOrCreateVariant(SpecializationConstants const &specializationConstants);
+
   void _cleanupPipelineAndLayout();
   void _cleanupShaderModule();
 
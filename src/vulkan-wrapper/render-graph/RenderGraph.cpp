@@ -0,0 +1,292 @@
+#include "RenderGraph.hpp"
+
+#include "../memory/Image.hpp"
+#include "app-context/DeletionQueue.hpp"
+#include "app-context/VulkanApplicationContext.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace {
+// the accesses that the passes of a later level might make to the data written before
+VkAccessFlags constexpr kReadWriteAccess =
+    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+    VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+// the indirect arguments of the dispatches are read in the draw indirect stage
+VkPipelineStageFlags constexpr kGraphStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                              VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+bool _contains(std::vector<void const *> const &resources, void const *resource) {
+  return std::find(resources.begin(), resources.end(), resource) != resources.end();
+}
+
+bool _intersects(std::vector<void const *> const &a, std::vector<void const *> const &b) {
+  return std::any_of(a.begin(), a.end(),
+                     [&b](void const *resource) { return _contains(b, resource); });
+}
+
+VkPipelineStageFlags _getPipelineStage(RenderGraph::Stage stage) {
+  return stage == RenderGraph::Stage::kCompute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                               : VK_PIPELINE_STAGE_TRANSFER_BIT;
+}
+
+VkAccessFlags _getWriteAccess(RenderGraph::Stage stage) {
+  return stage == RenderGraph::Stage::kCompute ? VK_ACCESS_SHADER_WRITE_BIT
+                                               : VK_ACCESS_TRANSFER_WRITE_BIT;
+}
+
+float _toMegabytes(VkDeviceSize size) { return static_cast<float>(size) / (1024.F * 1024.F); }
+} // namespace
+
+RenderGraph::RenderGraph(VulkanApplicationContext *appContext, Logger *logger)
+    : _appContext(appContext), _logger(logger) {}
+
+RenderGraph::~RenderGraph() {
+  if (_sharedAllocations.empty()) {
+    return;
+  }
+  // the memory may be freed before the images bound to it are destroyed, they are unused by then
+  _appContext->getDeletionQueue()->push(
+      [allocator = _appContext->getAllocator(), allocations = _sharedAllocations]() {
+        for (VmaAllocation allocation : allocations) {
+          vmaFreeMemory(allocator, allocation);
+        }
+      });
+}
+
+void RenderGraph::addTransientImage(Image *image) {
+  assert(!_compiled && "the graph is compiled already");
+  _transientImages.push_back(image);
+}
+
+void RenderGraph::addPass(Pass pass) {
+  assert(!_compiled && "the graph is compiled already");
+  _passes.push_back(std::move(pass));
+}
+
+void RenderGraph::compile() {
+  assert(!_compiled && "the graph is compiled already");
+  std::vector<uint32_t> const passLevels = _levelPasses();
+  _aliasTransientImages(passLevels);
+  _prepareBarriers();
+  _compiled = true;
+
+  _logger->info("render graph: {} passes in {} levels", _passes.size(), _levels.size());
+}
+
+void RenderGraph::record(VkCommandBuffer commandBuffer, uint32_t frameIndex) const {
+  assert(_compiled && "the graph must be compiled before recording");
+
+  // the barriers of the skipped levels are merged into the next recorded one, so the passes after
+  // them still wait for everything before, and the transient images are still transitioned
+  VkPipelineStageFlags srcStageMask = 0;
+  VkPipelineStageFlags dstStageMask = 0;
+  VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  std::vector<VkImageMemoryBarrier> imageBarriers;
+
+  std::vector<uint32_t> enabledPassIndices;
+  for (auto const &level : _levels) {
+    srcStageMask |= level.srcStageMask;
+    dstStageMask |= level.dstStageMask;
+    memoryBarrier.srcAccessMask |= level.memoryBarrier.srcAccessMask;
+    memoryBarrier.dstAccessMask |= level.memoryBarrier.dstAccessMask;
+    imageBarriers.insert(imageBarriers.end(), level.imageBarriers.begin(),
+                         level.imageBarriers.end());
+
+    enabledPassIndices.clear();
+    for (uint32_t passIndex : level.passIndices) {
+      if (!_passes[passIndex].isEnabled || _passes[passIndex].isEnabled()) {
+        enabledPassIndices.push_back(passIndex);
+      }
+    }
+    if (enabledPassIndices.empty()) {
+      continue;
+    }
+
+    vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 1, &memoryBarrier, 0,
+                         nullptr, static_cast<uint32_t>(imageBarriers.size()),
+                         imageBarriers.data());
+    for (uint32_t passIndex : enabledPassIndices) {
+      _passes[passIndex].record(commandBuffer, frameIndex);
+    }
+
+    srcStageMask                = 0;
+    dstStageMask                = 0;
+    memoryBarrier.srcAccessMask = 0;
+    memoryBarrier.dstAccessMask = 0;
+    imageBarriers.clear();
+  }
+}
+
+std::vector<uint32_t> RenderGraph::_levelPasses() {
+  std::vector<uint32_t> passLevels(_passes.size(), 0);
+  uint32_t levelCount = 0;
+  for (uint32_t i = 0; i < _passes.size(); i++) {
+    Pass const &pass = _passes[i];
+    uint32_t level   = 0;
+    for (uint32_t j = 0; j < i; j++) {
+      Pass const &earlierPass = _passes[j];
+      // read after write, write after write and write after read
+      bool const dependent = _intersects(pass.reads, earlierPass.writes) ||
+                             _intersects(pass.writes, earlierPass.writes) ||
+                             _intersects(pass.writes, earlierPass.reads);
+      if (dependent) {
+        level = std::max(level, passLevels[j] + 1);
+      }
+    }
+    passLevels[i] = level;
+    levelCount    = std::max(levelCount, level + 1);
+  }
+
+  _levels.resize(levelCount);
+  for (uint32_t i = 0; i < _passes.size(); i++) {
+    _levels[passLevels[i]].passIndices.push_back(i);
+  }
+  return passLevels;
+}
+
+void RenderGraph::_aliasTransientImages(std::vector<uint32_t> const &passLevels) {
+  struct Lifetime {
+    Image *image;
+    uint32_t firstLevel;
+    uint32_t lastLevel;
+    VkMemoryRequirements memoryRequirements;
+  };
+
+  auto const lastLevel = static_cast<uint32_t>(std::max<size_t>(_levels.size(), 1) - 1);
+  std::vector<Lifetime> lifetimes;
+  for (Image *image : _transientImages) {
+    Lifetime lifetime{image, std::numeric_limits<uint32_t>::max(), 0,
+                      image->getMemoryRequirements()};
+    for (uint32_t i = 0; i < _passes.size(); i++) {
+      if (_contains(_passes[i].reads, image) || _contains(_passes[i].writes, image)) {
+        lifetime.firstLevel = std::min(lifetime.firstLevel, passLevels[i]);
+        lifetime.lastLevel  = std::max(lifetime.lastLevel, passLevels[i]);
+      }
+    }
+    // keep an undeclared image alive for the whole frame, it might still be used by a pass
+    if (lifetime.firstLevel == std::numeric_limits<uint32_t>::max()) {
+      _logger->warn("render graph: transient image is not used by any pass");
+      lifetime.firstLevel = 0;
+      lifetime.lastLevel  = lastLevel;
+    }
+    lifetimes.push_back(lifetime);
+  }
+  std::stable_sort(lifetimes.begin(), lifetimes.end(), [](Lifetime const &a, Lifetime const &b) {
+    return a.firstLevel < b.firstLevel;
+  });
+
+  struct SharedMemory {
+    VkMemoryRequirements memoryRequirements;
+    uint32_t lastLevel;
+    std::vector<Image *> images;
+  };
+
+  std::vector<SharedMemory> sharedMemories;
+  VkDeviceSize unaliasedSize = 0;
+  for (auto const &lifetime : lifetimes) {
+    VkMemoryRequirements const &requirements = lifetime.memoryRequirements;
+    unaliasedSize += requirements.size;
+
+    // the memory that grows the least, and the smallest one among those
+    SharedMemory *bestFit   = nullptr;
+    VkDeviceSize bestGrowth = std::numeric_limits<VkDeviceSize>::max();
+    for (auto &sharedMemory : sharedMemories) {
+      if (sharedMemory.lastLevel >= lifetime.firstLevel ||
+          (sharedMemory.memoryRequirements.memoryTypeBits & requirements.memoryTypeBits) == 0) {
+        continue;
+      }
+      VkDeviceSize const size   = sharedMemory.memoryRequirements.size;
+      VkDeviceSize const growth = requirements.size > size ? requirements.size - size : 0;
+      if (growth < bestGrowth ||
+          (growth == bestGrowth && size < bestFit->memoryRequirements.size)) {
+        bestFit    = &sharedMemory;
+        bestGrowth = growth;
+      }
+    }
+
+    if (bestFit == nullptr) {
+      sharedMemories.push_back({requirements, lifetime.lastLevel, {lifetime.image}});
+      continue;
+    }
+    VkMemoryRequirements &sharedRequirements = bestFit->memoryRequirements;
+
+    sharedRequirements.size      = std::max(sharedRequirements.size, requirements.size);
+    sharedRequirements.alignment = std::max(sharedRequirements.alignment, requirements.alignment);
+    sharedRequirements.memoryTypeBits &= requirements.memoryTypeBits;
+    bestFit->lastLevel = lifetime.lastLevel;
+    bestFit->images.push_back(lifetime.image);
+  }
+
+  VmaAllocationCreateInfo allocCreateInfo{};
+  allocCreateInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+  VkDeviceSize aliasedSize = 0;
+  for (auto const &sharedMemory : sharedMemories) {
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkResult const result    = vmaAllocateMemory(_appContext->getAllocator(),
+                                                 &sharedMemory.memoryRequirements, &allocCreateInfo,
+                                                 &allocation, nullptr);
+    if (result != VK_SUCCESS) {
+      _logger->error("render graph: failed to allocate the memory of the transient images");
+      exit(0);
+    }
+    _sharedAllocations.push_back(allocation);
+    aliasedSize += sharedMemory.memoryRequirements.size;
+
+    // every image starts at the beginning of the memory
+    for (Image *image : sharedMemory.images) {
+      image->bindMemory(allocation);
+    }
+  }
+
+  // the images are transitioned right before their first use, which also discards the content
+  // left by the images that used the memory before
+  for (auto const &lifetime : lifetimes) {
+    VkImageMemoryBarrier imageBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    imageBarrier.srcAccessMask               = 0;
+    imageBarrier.dstAccessMask               = kReadWriteAccess;
+    imageBarrier.oldLayout                   = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageBarrier.newLayout                   = VK_IMAGE_LAYOUT_GENERAL;
+    imageBarrier.srcQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image                       = lifetime.image->getVkImage();
+    imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageBarrier.subresourceRange.levelCount = 1;
+    imageBarrier.subresourceRange.layerCount = 1;
+    _levels[lifetime.firstLevel].imageBarriers.push_back(imageBarrier);
+  }
+
+  _logger->info("render graph: {} transient images in {} allocations, {:.1f} MB instead of "
+                "{:.1f} MB",
+                _transientImages.size(), sharedMemories.size(), _toMegabytes(aliasedSize),
+                _toMegabytes(unaliasedSize));
+}
+
+void RenderGraph::_prepareBarriers() {
+  for (uint32_t levelIndex = 0; levelIndex < _levels.size(); levelIndex++) {
+    Level &level = _levels[levelIndex];
+    if (levelIndex == 0) {
+      // the uniform buffers written by the host, and everything the previous frame did
+      level.srcStageMask = VK_PIPELINE_STAGE_HOST_BIT | kGraphStages;
+      level.memoryBarrier.srcAccessMask =
+          VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+      level.memoryBarrier.dstAccessMask = kReadWriteAccess | VK_ACCESS_UNIFORM_READ_BIT;
+    } else {
+      for (uint32_t passIndex : _levels[levelIndex - 1].passIndices) {
+        Pass const &pass = _passes[passIndex];
+        level.srcStageMask |= _getPipelineStage(pass.stage);
+        if (!pass.writes.empty()) {
+          level.memoryBarrier.srcAccessMask |= _getWriteAccess(pass.stage);
+        }
+      }
+      level.memoryBarrier.dstAccessMask = kReadWriteAccess;
+    }
+    // the data written before might be used by any later level, so it is made available to all
+    // the stages of the graph at once
+    level.dstStageMask = kGraphStages;
+  }
+}
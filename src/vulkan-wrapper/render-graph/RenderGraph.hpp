@@ -0,0 +1,97 @@
+#pragma once
+
+#include "volk.h"
+
+#ifdef _WIN32
+#include "vma/vk_mem_alloc.h" // NO_G3_REWRITE
+#else
+#include "vk_mem_alloc.h" // NO_G3_REWRITE
+#endif
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class Logger;
+class Image;
+class VulkanApplicationContext;
+
+// a small compute render graph, the passes declare the images and buffers they read and write, the
+// graph then:
+// 1. places every pass into the earliest level after all the passes it depends on, the passes of
+// the same level are recorded back to back without any barrier in between
+// 2. emits one memory barrier between two levels, which waits only for the stages of the level
+// before
+// 3. lets the transient images share memory if they are never alive in the same level
+// the resources that are not written by any pass can be left out of the declarations, the buffers
+// written by a pass may be read as the indirect arguments of the passes of later levels
+class RenderGraph {
+public:
+  enum class Stage {
+    kCompute,
+    kTransfer,
+  };
+
+  struct Pass {
+    std::string name;
+    Stage stage = Stage::kCompute;
+    // the images (Image *) and buffers (Buffer *) accessed by the pass, a resource that is read and
+    // written is listed in both
+    std::vector<void const *> reads;
+    std::vector<void const *> writes;
+    std::function<void(VkCommandBuffer commandBuffer, uint32_t frameIndex)> record;
+    // checked when the graph is recorded, a disabled pass is left out, and a level without any
+    // enabled pass is skipped together with its barrier, a pass without it is always enabled
+    std::function<bool()> isEnabled;
+  };
+
+  RenderGraph(VulkanApplicationContext *appContext, Logger *logger);
+  // the shared memory is released through the deletion queue
+  ~RenderGraph();
+
+  // disable copy and move
+  RenderGraph(RenderGraph const &)            = delete;
+  RenderGraph(RenderGraph &&)                 = delete;
+  RenderGraph &operator=(RenderGraph const &) = delete;
+  RenderGraph &operator=(RenderGraph &&)      = delete;
+
+  // the image must be created by Image::createWithoutMemory, its content does not survive between
+  // its last use in a frame and its first use in the next frame, the first use must not read it
+  void addTransientImage(Image *image);
+  void addPass(Pass pass);
+
+  // levels the passes, binds the memory of the transient images, and prepares the barriers, no
+  // passes or images can be added afterwards
+  void compile();
+
+  // the first barrier also waits for the host writes and the previous frame
+  void record(VkCommandBuffer commandBuffer, uint32_t frameIndex) const;
+
+private:
+  VulkanApplicationContext *_appContext;
+  Logger *_logger;
+
+  std::vector<Pass> _passes;
+  std::vector<Image *> _transientImages;
+  bool _compiled = false;
+
+  struct Level {
+    std::vector<uint32_t> passIndices;
+    // the barrier before the level
+    VkPipelineStageFlags srcStageMask = 0;
+    VkPipelineStageFlags dstStageMask = 0;
+    VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    // the transient images that are first used in the level, they are transitioned from
+    // VK_IMAGE_LAYOUT_UNDEFINED, because another image might have been using their memory
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+  };
+  std::vector<Level> _levels;
+
+  // the memory shared by the transient images
+  std::vector<VmaAllocation> _sharedAllocations;
+
+  std::vector<uint32_t> _levelPasses();
+  void _aliasTransientImages(std::vector<uint32_t> const &passLevels);
+  void _prepareBarriers();
+};